@@ -249,6 +249,8 @@ CTX.INPUT['common'] = """
  TupleOutputStreamProcessor.cpp
  MiscUtil.cpp
  debuglog.cpp
+ LikeMatcher.cpp
+ HyperLogLogSketch.cpp
 """
 
 CTX.INPUT['execution'] = """
@@ -260,6 +262,7 @@ CTX.INPUT['execution'] = """
 
 CTX.INPUT['executors'] = """
  OptimizedProjector.cpp
+ PlanNodeStats.cpp
  abstractexecutor.cpp
  abstractjoinexecutor.cpp
  aggregateexecutor.cpp
@@ -289,11 +292,15 @@ CTX.INPUT['executors'] = """
 
 CTX.INPUT['expressions'] = """
  abstractexpression.cpp
+ expressionoptimizer.cpp
  expressionutil.cpp
  functionexpression.cpp
  geofunctions.cpp
+ JsonPathEvaluator.cpp
+ memoizedexpression.cpp
  operatorexpression.cpp
  parametervalueexpression.cpp
+ RegexpPatternCache.cpp
  scalarvalueexpression.cpp
  subqueryexpression.cpp
  tupleaddressexpression.cpp
@@ -385,6 +392,7 @@ CTX.INPUT['stats'] = """
 CTX.INPUT['logging'] = """
  JNILogProxy.cpp
  LogManager.cpp
+ LogRing.cpp
 """
 
 # specify the third party input
@@ -453,6 +461,8 @@ if whichtests in ("${eetestsuite}", "common"):
     CTX.TESTS['common'] = """
      debuglog_test
      elastic_hashinator_test
+     hyperloglog_sketch_test
+     like_matcher_test
      nvalue_test
      pool_test
      serializeio_test
@@ -473,6 +483,7 @@ if whichtests in ("${eetestsuite}", "execution"):
 if whichtests in ("${eetestsuite}", "executors"):
     CTX.TESTS['executors'] = """
     OptimizedProjectorTest
+    PlanNodeStatsTest
     MergeReceiveExecutorTest
     PartitionByExecutorTest
     TestGeneratedPlans
@@ -493,6 +504,7 @@ if whichtests in ("${eetestsuite}", "indexes"):
      CompactingHashIndexTest
      CompactingTreeMultiIndexTest
      CoveringCellIndexTest
+     IndexMaintenanceBenchmark
     """
 
 if whichtests in ("${eetestsuite}", "storage"):
@@ -518,6 +530,7 @@ if whichtests in ("${eetestsuite}", "storage"):
 
 if whichtests in ("${eetestsuite}", "structures"):
     CTX.TESTS['structures'] = """
+     BTreeBulkLoadTest
      CompactingMapTest
      CompactingMapIndexCountTest
      CompactingHashTest
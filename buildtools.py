@@ -323,7 +323,7 @@ def buildThirdPartyTools(CTX, makefile):
     makefile.write('\t  /bin/rm -rf "${PCRE2_OBJ}"; \\\n')
     makefile.write('\t  mkdir -p "${PCRE2_OBJ}"; \\\n')
     makefile.write('\t  cd "${PCRE2_OBJ}"; \\\n')
-    makefile.write('\t  "${PCRE2_SRC}/configure" --disable-shared --with-pic --prefix="${PCRE2_INSTALL}" ; \\\n')
+    makefile.write('\t  "${PCRE2_SRC}/configure" --disable-shared --with-pic --enable-jit --prefix="${PCRE2_INSTALL}" ; \\\n')
     makefile.write('\tfi\n')
     makefile.write('unpack-pcre2:\n')
     makefile.write('\tif [ ! -d "$PCRE2_SRC" ] ; then \\\n')
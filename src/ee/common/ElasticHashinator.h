@@ -105,25 +105,62 @@ protected:
         return partitionForToken(hashCode);
     }
 
+    /*
+     * Find the partition owning the largest token <= hashCode. The tokens are
+     * searched in Eytzinger (breadth first) order so the probe sequence walks
+     * down the front of the array and the loop body has no data dependent branch.
+     * If every bit we appended on the way down was a left turn there is no token
+     * <= hashCode and we land in slot 0, which wraps to the last token on the ring.
+     */
     int32_t partitionForToken(int32_t hashCode) const {
-        int32_t min = 0;
-        int32_t max = tokenCount - 1;
-
-        while (min <= max) {
-            assert(min >= 0);
-            assert(max >= 0);
-            uint32_t mid = (min + max) >> 1;
-            int32_t midval = tokens[mid * 2];
-
-            if (midval < hashCode) {
-                min = mid + 1;
-            } else if (midval > hashCode) {
-                max = mid - 1;
-            } else {
-                return tokens[mid * 2 + 1];
+        uint32_t k = 1;
+        while (k <= tokenCount) {
+            k = 2 * k + (eytzingerTokens[k] <= hashCode);
+        }
+        k >>= __builtin_ffs(k);
+        return eytzingerPartitions[k];
+    }
+
+    /*
+     * Batch form of partitionForToken. The searches are independent so the
+     * processor can overlap their loads.
+     */
+    void partitionsForTokens(const int32_t *hashCodes, int32_t count, int32_t *partitions) const {
+        for (int32_t ii = 0; ii < count; ii++) {
+            partitions[ii] = partitionForToken(hashCodes[ii]);
+        }
+    }
+
+    /*
+     * Hash a column of values and route each of them, in chunks of
+     * HASHINATE_BATCH_SIZE. Values that hashinate(NValue) special cases to
+     * partition 0 (nulls and INT64_MIN) are routed after the batched lookup.
+     */
+    void partitionsForValues(const NValue *values, int32_t count, int32_t *partitions) const {
+        int32_t hashCodes[HASHINATE_BATCH_SIZE];
+        bool toPartitionZero[HASHINATE_BATCH_SIZE];
+        for (int32_t base = 0; base < count; base += HASHINATE_BATCH_SIZE) {
+            const int32_t batchCount =
+                count - base < HASHINATE_BATCH_SIZE ? count - base : HASHINATE_BATCH_SIZE;
+            bool anyToPartitionZero = false;
+            for (int32_t ii = 0; ii < batchCount; ii++) {
+                hashCodes[ii] = 0;
+                toPartitionZero[ii] = ! tokenForValue(values[base + ii], hashCodes[ii]);
+                anyToPartitionZero |= toPartitionZero[ii];
+            }
+            partitionsForTokens(hashCodes, batchCount, &partitions[base]);
+            if (anyToPartitionZero) {
+                for (int32_t ii = 0; ii < batchCount; ii++) {
+                    if (toPartitionZero[ii]) {
+                        partitions[base + ii] = 0;
+                    }
+                }
             }
         }
-        return tokens[(min - 1) * 2 + 1];
+    }
+
+    bool sharesConfig(const int32_t *configPtr, uint32_t numTokens) const {
+        return tokensOwner.get() == NULL && tokens == configPtr && tokenCount == numTokens;
     }
 
     std::string debug() const {
@@ -141,12 +178,76 @@ protected:
 
 private:
 
-    ElasticHashinator(int32_t *tokens, uint32_t tokenCount, bool owned) : tokens(tokens), tokenCount(tokenCount), tokensOwner( owned ? tokens : NULL ) {}
+    ElasticHashinator(int32_t *tokens, uint32_t tokenCount, bool owned) :
+        tokens(tokens), tokenCount(tokenCount), tokensOwner( owned ? tokens : NULL ),
+        eytzingerTokens(new int32_t[tokenCount + 1]), eytzingerPartitions(new int32_t[tokenCount + 1])
+    {
+        // Slot 0 is the "no token <= hash" answer, which wraps around the ring
+        eytzingerTokens[0] = std::numeric_limits<int32_t>::min();
+        eytzingerPartitions[0] = tokenCount > 0 ? tokens[(tokenCount - 1) * 2 + 1] : 0;
+        uint32_t next = buildEytzinger(0, 1);
+        assert(next == tokenCount);
+        (void)next;
+    }
+
+    /*
+     * Lay out the sorted tokens in Eytzinger order with an in-order walk of the
+     * implicit tree rooted at eytzingerIndex. Returns the next sorted index to place.
+     */
+    uint32_t buildEytzinger(uint32_t sortedIndex, uint32_t eytzingerIndex) {
+        if (eytzingerIndex <= tokenCount) {
+            sortedIndex = buildEytzinger(sortedIndex, 2 * eytzingerIndex);
+            eytzingerTokens[eytzingerIndex] = tokens[sortedIndex * 2];
+            eytzingerPartitions[eytzingerIndex] = tokens[sortedIndex * 2 + 1];
+            sortedIndex = buildEytzinger(sortedIndex + 1, 2 * eytzingerIndex + 1);
+        }
+        return sortedIndex;
+    }
+
+    /*
+     * Compute the ring token for a value the way hashinate(NValue) does. Returns
+     * false if the value is one that is always routed to partition 0.
+     */
+    bool tokenForValue(const NValue &value, int32_t &hashCode) const {
+        if (value.isNull()) {
+            return false;
+        }
+        switch (ValuePeeker::peekValueType(value)) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        {
+            const int64_t raw = ValuePeeker::peekAsRawInt64(value);
+            if (raw == INT64_MIN) {
+                return false;
+            }
+            hashCode = MurmurHash3_x64_128(raw);
+            return true;
+        }
+        case VALUE_TYPE_VARBINARY:
+        case VALUE_TYPE_VARCHAR:
+        {
+            int32_t length;
+            const char* buf = ValuePeeker::peekObject_withoutNull(value, &length);
+            hashCode = MurmurHash3_x64_128(buf, length, 0);
+            return true;
+        }
+        default:
+            // let the scalar path raise the unsupported type error
+            TheHashinator::hashinate(value);
+            return false;
+        }
+    }
 
     const int32_t *tokens;
     const uint32_t tokenCount;
     boost::scoped_array<int32_t> tokensOwner;
 
+    // Tokens and their partitions in 1-based Eytzinger order, see partitionForToken
+    boost::scoped_array<int32_t> eytzingerTokens;
+    boost::scoped_array<int32_t> eytzingerPartitions;
+
 };
 }
 #endif /* ELASTICHASHINATOR_H_ */
@@ -0,0 +1,328 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/HyperLogLogSketch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <murmur3/MurmurHash3.h>
+
+namespace voltdb {
+
+namespace {
+
+// The hash seed of hll::HyperLogLog
+const uint32_t HASH_SEED = 313;
+const uint8_t MAX_RANK = 32 - HyperLogLogSketch::REGISTER_BIT_WIDTH + 1;
+const size_t PACKED_REGISTERS_SIZE = HyperLogLogSketch::NUM_REGISTERS * 5 / 8;
+
+/** The position of the first 1 bit of x among its top b bits, or b + 1 */
+uint8_t rho(uint32_t x, uint8_t b) {
+    uint8_t v = 1;
+    while (v <= b && !(x & 0x80000000)) {
+        v++;
+        x <<= 1;
+    }
+    return v;
+}
+
+/**
+ * The estimate of hll::HyperLogLog, from the sum of 2^-rank over the
+ * registers and the number of zero registers.
+ */
+double estimateFrom(double sum, uint32_t zeros) {
+    const uint32_t m = HyperLogLogSketch::NUM_REGISTERS;
+    const double alphaMM = 0.7213 / (1.0 + 1.079 / m) * m * m;
+    double estimate = alphaMM / sum;
+    if (estimate <= 2.5 * m) {
+        if (zeros != 0) {
+            estimate = m * log(static_cast<double>(m) / zeros);
+        }
+    }
+    else if (estimate > (1.0 / 30.0) * 4294967296.0) {
+        estimate = -4294967296.0 * log(1.0 - (estimate / 4294967296.0));
+    }
+    return estimate;
+}
+
+size_t varintSize(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+char* putVarint(char* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+bool getVarint(const char*& in, const char* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && in < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*in++);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+HyperLogLogSketch::HyperLogLogSketch()
+{
+}
+
+void HyperLogLogSketch::add(const char* data, uint32_t length) {
+    uint32_t hash = MurmurHash3_x86_32(data, length, HASH_SEED);
+    uint32_t index = hash >> (32 - REGISTER_BIT_WIDTH);
+    uint8_t rank = rho(hash << REGISTER_BIT_WIDTH, 32 - REGISTER_BIT_WIDTH);
+    if (isSparse()) {
+        addEntry(makeEntry(index, rank));
+    }
+    else if (rank > m_registers[index]) {
+        m_registers[index] = rank;
+    }
+}
+
+void HyperLogLogSketch::addEntry(uint32_t entry) {
+    m_pending.push_back(entry);
+    if (m_pending.size() >= PENDING_MAX_ENTRIES) {
+        mergePending();
+        if (m_entries.size() > SPARSE_MAX_ENTRIES) {
+            toDense();
+        }
+    }
+}
+
+void HyperLogLogSketch::mergePending() const {
+    if (m_pending.empty()) {
+        return;
+    }
+    std::sort(m_pending.begin(), m_pending.end());
+    std::vector<uint32_t> merged(m_entries.size() + m_pending.size());
+    std::merge(m_entries.begin(), m_entries.end(),
+               m_pending.begin(), m_pending.end(),
+               merged.begin());
+    // The entries of a register are together, in rank order: keep the last.
+    size_t kept = 0;
+    for (size_t ii = 0; ii < merged.size(); ++ii) {
+        if (kept > 0 && entryIndex(merged[kept - 1]) == entryIndex(merged[ii])) {
+            merged[kept - 1] = merged[ii];
+        }
+        else {
+            merged[kept++] = merged[ii];
+        }
+    }
+    merged.resize(kept);
+    m_entries.swap(merged);
+    m_pending.clear();
+}
+
+void HyperLogLogSketch::toDense() {
+    mergePending();
+    m_registers.assign(NUM_REGISTERS, 0);
+    for (size_t ii = 0; ii < m_entries.size(); ++ii) {
+        m_registers[entryIndex(m_entries[ii])] = entryRank(m_entries[ii]);
+    }
+    std::vector<uint32_t>().swap(m_entries);
+    std::vector<uint32_t>().swap(m_pending);
+}
+
+double HyperLogLogSketch::estimate() const {
+    double sum = 0.0;
+    uint32_t zeros = 0;
+    if (isSparse()) {
+        mergePending();
+        zeros = NUM_REGISTERS - static_cast<uint32_t>(m_entries.size());
+        sum = zeros;
+        for (size_t ii = 0; ii < m_entries.size(); ++ii) {
+            sum += 1.0 / pow(2.0, entryRank(m_entries[ii]));
+        }
+    }
+    else {
+        for (uint32_t ii = 0; ii < NUM_REGISTERS; ++ii) {
+            sum += 1.0 / pow(2.0, m_registers[ii]);
+            if (m_registers[ii] == 0) {
+                zeros++;
+            }
+        }
+    }
+    return estimateFrom(sum, zeros);
+}
+
+void HyperLogLogSketch::merge(const HyperLogLogSketch& other) {
+    if (other.isSparse()) {
+        other.mergePending();
+        if (isSparse()) {
+            m_pending.insert(m_pending.end(), other.m_entries.begin(), other.m_entries.end());
+            mergePending();
+            if (m_entries.size() > SPARSE_MAX_ENTRIES) {
+                toDense();
+            }
+            return;
+        }
+        for (size_t ii = 0; ii < other.m_entries.size(); ++ii) {
+            uint8_t& reg = m_registers[entryIndex(other.m_entries[ii])];
+            reg = std::max(reg, entryRank(other.m_entries[ii]));
+        }
+        return;
+    }
+    if (isSparse()) {
+        toDense();
+    }
+    for (uint32_t ii = 0; ii < NUM_REGISTERS; ++ii) {
+        m_registers[ii] = std::max(m_registers[ii], other.m_registers[ii]);
+    }
+}
+
+void HyperLogLogSketch::clear() {
+    std::vector<uint32_t>().swap(m_entries);
+    std::vector<uint32_t>().swap(m_pending);
+    std::vector<uint8_t>().swap(m_registers);
+}
+
+size_t HyperLogLogSketch::serializedSize() const {
+    if ( ! isSparse()) {
+        return 2 + PACKED_REGISTERS_SIZE;
+    }
+    mergePending();
+    size_t size = 2 + varintSize(static_cast<uint32_t>(m_entries.size()));
+    uint32_t previous = 0;
+    for (size_t ii = 0; ii < m_entries.size(); ++ii) {
+        size += varintSize(m_entries[ii] - previous);
+        previous = m_entries[ii];
+    }
+    return size;
+}
+
+void HyperLogLogSketch::serializeTo(char* buffer) const {
+    buffer[1] = static_cast<char>(REGISTER_BIT_WIDTH);
+    if (isSparse()) {
+        mergePending();
+        buffer[0] = static_cast<char>(SPARSE_FORMAT);
+        char* out = putVarint(buffer + 2, static_cast<uint32_t>(m_entries.size()));
+        uint32_t previous = 0;
+        for (size_t ii = 0; ii < m_entries.size(); ++ii) {
+            out = putVarint(out, m_entries[ii] - previous);
+            previous = m_entries[ii];
+        }
+        return;
+    }
+    buffer[0] = static_cast<char>(DENSE_FORMAT);
+    char* out = buffer + 2;
+    uint64_t bits = 0;
+    int nBits = 0;
+    for (uint32_t ii = 0; ii < NUM_REGISTERS; ++ii) {
+        bits |= static_cast<uint64_t>(m_registers[ii]) << nBits;
+        nBits += 5;
+        while (nBits >= 8) {
+            *out++ = static_cast<char>(bits & 0xFF);
+            bits >>= 8;
+            nBits -= 8;
+        }
+    }
+    assert(nBits == 0);
+}
+
+bool HyperLogLogSketch::deserializeFrom(const char* buffer, size_t length) {
+    if (length < 2) {
+        return false;
+    }
+    const uint8_t format = static_cast<uint8_t>(buffer[0]);
+    std::vector<uint32_t> entries;
+    std::vector<uint8_t> registers;
+
+    if (format == REGISTER_BIT_WIDTH && length == 1 + NUM_REGISTERS) {
+        // hll::HyperLogLog::dump()
+        registers.assign(buffer + 1, buffer + length);
+    }
+    else if (static_cast<uint8_t>(buffer[1]) != REGISTER_BIT_WIDTH) {
+        return false;
+    }
+    else if (format == SPARSE_FORMAT) {
+        const char* in = buffer + 2;
+        const char* end = buffer + length;
+        uint32_t count;
+        if ( ! getVarint(in, end, count) || count > NUM_REGISTERS) {
+            return false;
+        }
+        entries.reserve(count);
+        uint32_t entry = 0;
+        for (uint32_t ii = 0; ii < count; ++ii) {
+            uint32_t delta;
+            // Registers are strictly increasing, and set registers have a rank.
+            if ( ! getVarint(in, end, delta) || (ii > 0 && delta == 0) ||
+                delta > UINT32_MAX - entry) {
+                return false;
+            }
+            entry += delta;
+            if (entryIndex(entry) >= NUM_REGISTERS || entryRank(entry) == 0 ||
+                entryRank(entry) > MAX_RANK ||
+                (ii > 0 && entryIndex(entry) == entryIndex(entries.back()))) {
+                return false;
+            }
+            entries.push_back(entry);
+        }
+        if (in != end) {
+            return false;
+        }
+    }
+    else if (format == DENSE_FORMAT && length == 2 + PACKED_REGISTERS_SIZE) {
+        registers.resize(NUM_REGISTERS);
+        const char* in = buffer + 2;
+        uint64_t bits = 0;
+        int nBits = 0;
+        for (uint32_t ii = 0; ii < NUM_REGISTERS; ++ii) {
+            while (nBits < 5) {
+                bits |= static_cast<uint64_t>(static_cast<uint8_t>(*in++)) << nBits;
+                nBits += 8;
+            }
+            registers[ii] = static_cast<uint8_t>(bits & 0x1F);
+            bits >>= 5;
+            nBits -= 5;
+        }
+    }
+    else {
+        return false;
+    }
+
+    for (size_t ii = 0; ii < registers.size(); ++ii) {
+        if (registers[ii] > MAX_RANK) {
+            return false;
+        }
+    }
+    m_entries.swap(entries);
+    std::vector<uint32_t>().swap(m_pending);
+    m_registers.swap(registers);
+    if (m_entries.size() > SPARSE_MAX_ENTRIES) {
+        toDense();
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,111 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HYPERLOGLOGSKETCH_H_
+#define HYPERLOGLOGSKETCH_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * The HyperLogLog behind APPROX_COUNT_DISTINCT, with 2^16 registers.
+ *
+ * A dense register array is 64KB, which is a lot to hold for every
+ * group of a GROUP BY with many small groups.  So a sketch starts
+ * sparse: a sorted list of (register, rank) entries for the registers
+ * which are not zero, four bytes each.  New entries collect in a small
+ * unsorted buffer which is merged into the list when it fills.  Past
+ * SPARSE_MAX_ENTRIES the sketch goes dense for good.
+ *
+ * Values are hashed and ranked exactly as by hll::HyperLogLog with the
+ * same register width, and the estimates are the same: while sparse,
+ * the estimate is always in linear counting range, which depends only
+ * on the number of zero registers.
+ *
+ * The serialized form, the partial aggregate sent from each partition
+ * to the coordinator, is
+ *   sparse: uint8 SPARSE_FORMAT, uint8 register bit width, varint
+ *           number of entries, the entries as varint deltas;
+ *   dense:  uint8 DENSE_FORMAT, uint8 register bit width, the ranks
+ *           packed into 5 bits each, least significant bits first.
+ * The dense dump of hll::HyperLogLog, the bit width followed by a byte
+ * per register, is also accepted.
+ */
+class HyperLogLogSketch {
+public:
+    static const uint8_t REGISTER_BIT_WIDTH = 16;
+    static const uint32_t NUM_REGISTERS = 1 << REGISTER_BIT_WIDTH;
+    /** 16KB of entries, a quarter of the dense registers */
+    static const size_t SPARSE_MAX_ENTRIES = NUM_REGISTERS / 16;
+    static const size_t PENDING_MAX_ENTRIES = 256;
+
+    static const uint8_t SPARSE_FORMAT = 0xF1;
+    static const uint8_t DENSE_FORMAT = 0xF2;
+
+    HyperLogLogSketch();
+
+    void add(const char* data, uint32_t length);
+
+    double estimate() const;
+
+    /** Union another sketch into this one */
+    void merge(const HyperLogLogSketch& other);
+
+    /** Back to an empty sparse sketch, releasing the registers. */
+    void clear();
+
+    bool isSparse() const {
+        return m_registers.empty();
+    }
+
+    size_t serializedSize() const;
+
+    void serializeTo(char* buffer) const;
+
+    /** Returns false if the bytes are not a serialized sketch. */
+    bool deserializeFrom(const char* buffer, size_t length);
+
+private:
+    static uint32_t makeEntry(uint32_t index, uint8_t rank) {
+        return (index << 5) | rank;
+    }
+    static uint32_t entryIndex(uint32_t entry) {
+        return entry >> 5;
+    }
+    static uint8_t entryRank(uint32_t entry) {
+        return static_cast<uint8_t>(entry & 0x1F);
+    }
+
+    void addEntry(uint32_t entry);
+    /** Sort the pending entries into the sparse list. */
+    void mergePending() const;
+    void toDense();
+
+    // Sorted by register, one entry per register; mutable so that
+    // pending entries can be folded in by const readers.
+    mutable std::vector<uint32_t> m_entries;
+    mutable std::vector<uint32_t> m_pending;
+    // Empty while sparse
+    std::vector<uint8_t> m_registers;
+};
+
+}
+
+#endif /* HYPERLOGLOGSKETCH_H_ */
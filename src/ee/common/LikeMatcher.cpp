@@ -0,0 +1,176 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/LikeMatcher.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace voltdb {
+
+void LikeMatcher::prepare(const char *pattern, int32_t length) {
+    if (m_prepared && m_pattern.size() == static_cast<size_t>(length) &&
+        ::memcmp(m_pattern.data(), pattern, length) == 0) {
+        return;
+    }
+    m_pattern.assign(pattern, length);
+    m_prepared = true;
+    m_segments.clear();
+
+    if (m_pattern.find('_') != std::string::npos) {
+        m_kind = GENERAL;
+        return;
+    }
+
+    size_t start = 0;
+    while (start <= m_pattern.size()) {
+        size_t percent = m_pattern.find('%', start);
+        if (percent == std::string::npos) {
+            percent = m_pattern.size();
+        }
+        if (percent > start) {
+            m_segments.push_back(std::make_pair(start, percent - start));
+        }
+        start = percent + 1;
+    }
+    m_anchoredStart = m_pattern.empty() || m_pattern[0] != '%';
+    m_anchoredEnd = m_pattern.empty() || m_pattern[m_pattern.size() - 1] != '%';
+
+    if (m_pattern.find('%') == std::string::npos) {
+        m_kind = EXACT;
+        if (m_segments.empty()) {
+            m_segments.push_back(std::make_pair(0, 0));
+        }
+    }
+    else if (m_segments.size() != 1) {
+        m_kind = SEGMENTS;
+    }
+    else if (m_anchoredStart) {
+        m_kind = m_anchoredEnd ? SEGMENTS : PREFIX;
+    }
+    else {
+        m_kind = m_anchoredEnd ? SUFFIX : CONTAINS;
+    }
+}
+
+bool LikeMatcher::matches(const char *value, int32_t length) const {
+    assert(m_prepared && m_kind != GENERAL);
+    const size_t valueLength = static_cast<size_t>(length);
+    const char *literals = m_pattern.data();
+
+    switch (m_kind) {
+    case EXACT:
+        return valueLength == m_segments[0].second &&
+               ::memcmp(value, literals + m_segments[0].first, valueLength) == 0;
+    case PREFIX:
+        return valueLength >= m_segments[0].second &&
+               ::memcmp(value, literals + m_segments[0].first, m_segments[0].second) == 0;
+    case SUFFIX:
+        return valueLength >= m_segments[0].second &&
+               ::memcmp(value + valueLength - m_segments[0].second,
+                        literals + m_segments[0].first, m_segments[0].second) == 0;
+    case CONTAINS:
+        return findSubstring(value, valueLength,
+                             literals + m_segments[0].first, m_segments[0].second) != NULL;
+    default:
+        break;
+    }
+
+    // Anchored ends are checked in place, the literals in between are
+    // found left to right; taking the leftmost match of each never
+    // loses a match since '%' absorbs whatever lies between them.
+    size_t first = 0;
+    size_t last = m_segments.size();
+    size_t position = 0;
+    size_t end = valueLength;
+    if (m_anchoredStart && first < last) {
+        const std::pair<size_t, size_t> &segment = m_segments[first++];
+        if (segment.second > end || ::memcmp(value, literals + segment.first, segment.second) != 0) {
+            return false;
+        }
+        position = segment.second;
+    }
+    if (m_anchoredEnd && first < last) {
+        const std::pair<size_t, size_t> &segment = m_segments[--last];
+        if (segment.second > end - position ||
+            ::memcmp(value + end - segment.second, literals + segment.first, segment.second) != 0) {
+            return false;
+        }
+        end -= segment.second;
+    }
+    for (size_t i = first; i < last; ++i) {
+        const std::pair<size_t, size_t> &segment = m_segments[i];
+        const char *found = findSubstring(value + position, end - position,
+                                          literals + segment.first, segment.second);
+        if (found == NULL) {
+            return false;
+        }
+        position = (found - value) + segment.second;
+    }
+    return true;
+}
+
+const char *LikeMatcher::findSubstring(const char *haystack, size_t haystackLength,
+                                       const char *needle, size_t needleLength) {
+    if (needleLength == 0) {
+        return haystack;
+    }
+    if (haystackLength < needleLength) {
+        return NULL;
+    }
+    if (needleLength == 1) {
+        return static_cast<const char*>(::memchr(haystack, needle[0], haystackLength));
+    }
+
+    const size_t lastStart = haystackLength - needleLength;
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i firstByte = _mm_set1_epi8(needle[0]);
+    const __m128i lastByte = _mm_set1_epi8(needle[needleLength - 1]);
+    for (; i + 16 <= lastStart + 1; i += 16) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        const __m128i blockLast =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needleLength - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(firstByte, blockFirst), _mm_cmpeq_epi8(lastByte, blockLast))));
+        while (mask != 0) {
+            const size_t candidate = i + __builtin_ctz(mask);
+            if (::memcmp(haystack + candidate + 1, needle + 1, needleLength - 2) == 0) {
+                return haystack + candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    while (i <= lastStart) {
+        const char *candidate = static_cast<const char*>(::memchr(haystack + i, needle[0], lastStart - i + 1));
+        if (candidate == NULL) {
+            return NULL;
+        }
+        if (::memcmp(candidate + 1, needle + 1, needleLength - 1) == 0) {
+            return candidate;
+        }
+        i = (candidate - haystack) + 1;
+    }
+    return NULL;
+}
+
+}
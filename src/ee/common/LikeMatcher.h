@@ -0,0 +1,78 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIKEMATCHER_H_
+#define LIKEMATCHER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * A LIKE pattern analyzed once and then matched against many values.
+ * Patterns made of literals and '%' are matched on the UTF-8 bytes
+ * with memcmp and a substring search; since UTF-8 is self
+ * synchronizing a byte match of valid UTF-8 always falls on character
+ * boundaries.  Patterns with '_', which has to count characters, are
+ * left to NValue::like (isGeneral()).
+ */
+class LikeMatcher {
+public:
+    enum Kind {
+        EXACT,     // 'abc'
+        PREFIX,    // 'abc%'
+        SUFFIX,    // '%abc'
+        CONTAINS,  // '%abc%'
+        SEGMENTS,  // any other mix of literals and '%'
+        GENERAL    // has '_'
+    };
+
+    LikeMatcher() : m_kind(GENERAL), m_prepared(false) {}
+
+    /** Analyze the pattern, unless it is the one analyzed last. */
+    void prepare(const char *pattern, int32_t length);
+
+    Kind kind() const { return m_kind; }
+    bool isGeneral() const { return m_kind == GENERAL; }
+
+    /** Match a value against a prepared pattern that is not general. */
+    bool matches(const char *value, int32_t length) const;
+
+    /**
+     * The first occurrence of needle in haystack, or NULL.  Filters
+     * 16 positions at a time on the needle's first and last bytes
+     * where SSE2 is available.
+     */
+    static const char *findSubstring(const char *haystack, size_t haystackLength,
+                                     const char *needle, size_t needleLength);
+
+private:
+    std::string m_pattern;
+    Kind m_kind;
+    bool m_prepared;
+    bool m_anchoredStart;
+    bool m_anchoredEnd;
+    // the literals between the '%'s, as offsets and lengths in m_pattern
+    std::vector<std::pair<size_t, size_t> > m_segments;
+};
+
+}
+
+#endif /* LIKEMATCHER_H_ */
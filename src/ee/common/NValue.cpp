@@ -120,6 +120,12 @@ const double NValue::s_ltMinDecimalAsDouble = -1E26;
 TTInt NValue::s_maxInt64AsDecimal(TTInt(INT64_MAX) * kMaxScaleFactor);
 TTInt NValue::s_minInt64AsDecimal(TTInt(-INT64_MAX) * kMaxScaleFactor);
 
+#ifdef VOLT_NATIVE_DECIMAL
+// 10**38 - 1, built from 10**19 as there are no 128 bit literals
+const NativeDecimal NValue::s_maxNativeDecimal =
+    static_cast<NativeDecimal>(10000000000000000000ULL) * 10000000000000000000ULL - 1;
+#endif
+
 /*
  * Produce a debugging string describing an NValue.
  */
@@ -503,21 +509,17 @@ void NValue::castAndSortAndDedupArrayForInList(const ValueType outputType, std::
 void NValue::streamTimestamp(std::stringstream& value) const
 {
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-
-    long micro = epoch_micros % 1000000;
-    if (epoch_micros < 0 && micro < 0) {
-        // deal with negative micros (for dates before 1970)
-        // by taking back the 1 whole second that was rounded down from the formatted date/time
-        // and converting it to 1000000 micros
-        micro += 1000000;
-    }
-    char mbstr[27];    // Format: "YYYY-MM-DD HH:MM:SS."- 20 characters + terminator
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    int64_t micros = micros_of_day(epoch_micros);
+
+    // Format: "YYYY-MM-DD HH:MM:SS.UUUUUU" - 26 characters + terminator.
+    // Sized for any int fields, so the compiler can see nothing is truncated.
+    char mbstr[64];
     snprintf(mbstr, sizeof(mbstr), "%04d-%02d-%02d %02d:%02d:%02d.%06d",
-             (int)as_date.year(), (int)as_date.month(), (int)as_date.day(),
-             (int)as_time.hours(), (int)as_time.minutes(), (int)as_time.seconds(), (int)micro);
+             year, month, day,
+             (int)(micros / MICROS_PER_HOUR), (int)(micros % MICROS_PER_HOUR / MICROS_PER_MINUTE),
+             (int)(micros % MICROS_PER_MINUTE / MICROS_PER_SECOND), (int)(micros % MICROS_PER_SECOND));
     value << mbstr;
 }
 
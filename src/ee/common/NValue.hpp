@@ -69,6 +69,15 @@ typedef ttmath::Int<2> TTInt;
 //Long integer with space for multiplication and division without carry/overflow
 typedef ttmath::Int<4> TTLInt;
 
+#if defined(__SIZEOF_INT128__) && defined(TTMATH_PLATFORM64)
+// On x86-64 a TTInt is two 64 bit words in two's complement, least
+// significant first, which is exactly how the compiler lays out its
+// own 128 bit integer.  Decimal arithmetic uses that when it can.
+#define VOLT_NATIVE_DECIMAL
+__extension__ typedef __int128 NativeDecimal;
+__extension__ typedef unsigned __int128 NativeUDecimal;
+#endif
+
 template<typename T>
 void throwCastSQLValueOutOfRangeException(
         const T value,
@@ -380,6 +389,8 @@ class NValue {
     NValue op_decrement() const;
     NValue op_subtract(const NValue& rhs) const;
     NValue op_add(const NValue& rhs) const;
+    /* Same as *this = op_add(rhs), but without temporaries for two decimals; for SUM and AVG */
+    void op_add_in_place(const NValue& rhs);
     NValue op_multiply(const NValue& rhs) const;
     NValue op_divide(const NValue& rhs) const;
     /*
@@ -760,6 +771,10 @@ private:
     // These are the bound of converting decimal
     static TTInt s_maxInt64AsDecimal;
     static TTInt s_minInt64AsDecimal;
+#ifdef VOLT_NATIVE_DECIMAL
+    // s_maxDecimalValue; the minimum is its negation
+    static const NativeDecimal s_maxNativeDecimal;
+#endif
 
     /**
      * 16 bytes of storage for NValue data.
@@ -942,6 +957,21 @@ private:
         return *reinterpret_cast<TTInt*>(retval);
     }
 
+#ifdef VOLT_NATIVE_DECIMAL
+    // m_data is not aligned for the compiler's 128 bit loads and stores
+    NativeDecimal getNativeDecimal() const {
+        assert(getValueType() == VALUE_TYPE_DECIMAL);
+        NativeDecimal retval;
+        ::memcpy(&retval, m_data, sizeof(retval));
+        return retval;
+    }
+
+    void setNativeDecimal(NativeDecimal value) {
+        assert(getValueType() == VALUE_TYPE_DECIMAL);
+        ::memcpy(m_data, &value, sizeof(value));
+    }
+#endif
+
     const bool& getBoolean() const {
         assert(getValueType() == VALUE_TYPE_BOOLEAN);
         return *reinterpret_cast<const bool*>(m_data);
@@ -2024,7 +2054,11 @@ private:
         assert(m_valueType == VALUE_TYPE_DECIMAL);
         switch (rhs.getValueType()) {
         case VALUE_TYPE_DECIMAL:
+#ifdef VOLT_NATIVE_DECIMAL
+            return compareValue<NativeDecimal>(getNativeDecimal(), rhs.getNativeDecimal());
+#else
             return compareValue<TTInt>(getDecimal(), rhs.getDecimal());
+#endif
         case VALUE_TYPE_DOUBLE: {
             const double rhsValue = rhs.getDouble();
             TTInt scaledValue = getDecimal();
@@ -2216,12 +2250,90 @@ private:
         return getDoubleValue(result);
     }
 
+#ifdef VOLT_NATIVE_DECIMAL
+    /*
+     * The native decimal operations return false, leaving the result
+     * unset, when it overflows or is out of the decimal range; the
+     * ttmath versions then produce the error, so that its message
+     * does not change.  Division and scaling truncate toward zero,
+     * as ttmath does.
+     */
+    static bool nativeDecimalInRange(NativeDecimal value) {
+        return value <= s_maxNativeDecimal && value >= -s_maxNativeDecimal;
+    }
+
+    static NativeUDecimal nativeDecimalMagnitude(NativeDecimal value) {
+        return value < 0 ? -static_cast<NativeUDecimal>(value) : static_cast<NativeUDecimal>(value);
+    }
+
+    static bool addNativeDecimals(NativeDecimal lhs, NativeDecimal rhs, NativeDecimal& result) {
+        result = static_cast<NativeDecimal>(static_cast<NativeUDecimal>(lhs) + static_cast<NativeUDecimal>(rhs));
+        // overflow turns the sign of the sum against that of both operands
+        if (((lhs ^ result) & (rhs ^ result)) < 0) {
+            return false;
+        }
+        return nativeDecimalInRange(result);
+    }
+
+    static bool subtractNativeDecimals(NativeDecimal lhs, NativeDecimal rhs, NativeDecimal& result) {
+        result = static_cast<NativeDecimal>(static_cast<NativeUDecimal>(lhs) - static_cast<NativeUDecimal>(rhs));
+        if (((lhs ^ rhs) & (lhs ^ result)) < 0) {
+            return false;
+        }
+        return nativeDecimalInRange(result);
+    }
+
+    static bool multiplyNativeDecimals(NativeDecimal lhs, NativeDecimal rhs, NativeDecimal& result) {
+        NativeUDecimal lhsMagnitude = nativeDecimalMagnitude(lhs);
+        NativeUDecimal rhsMagnitude = nativeDecimalMagnitude(rhs);
+        if ((lhsMagnitude >> 64) != 0 || (rhsMagnitude >> 64) != 0) {
+            return false;
+        }
+        NativeUDecimal magnitude = lhsMagnitude * rhsMagnitude / kMaxScaleFactor;
+        if (magnitude > static_cast<NativeUDecimal>(s_maxNativeDecimal)) {
+            return false;
+        }
+        result = ((lhs < 0) != (rhs < 0)) ? -static_cast<NativeDecimal>(magnitude)
+                                          : static_cast<NativeDecimal>(magnitude);
+        return true;
+    }
+
+    static bool divideNativeDecimals(NativeDecimal lhs, NativeDecimal rhs, NativeDecimal& result) {
+        NativeUDecimal lhsMagnitude = nativeDecimalMagnitude(lhs);
+        NativeUDecimal rhsMagnitude = nativeDecimalMagnitude(rhs);
+        // leave division by zero to ttmath too
+        if (rhsMagnitude == 0 ||
+            lhsMagnitude > static_cast<NativeUDecimal>(-1) / static_cast<NativeUDecimal>(kMaxScaleFactor)) {
+            return false;
+        }
+        NativeUDecimal magnitude = lhsMagnitude * kMaxScaleFactor / rhsMagnitude;
+        if (magnitude > static_cast<NativeUDecimal>(s_maxNativeDecimal)) {
+            return false;
+        }
+        result = ((lhs < 0) != (rhs < 0)) ? -static_cast<NativeDecimal>(magnitude)
+                                          : static_cast<NativeDecimal>(magnitude);
+        return true;
+    }
+
+    static NValue getNativeDecimalValue(NativeDecimal value) {
+        NValue retval(VALUE_TYPE_DECIMAL);
+        retval.setNativeDecimal(value);
+        return retval;
+    }
+#endif
+
     static NValue opAddDecimals(const NValue& lhs, const NValue& rhs) {
         assert(lhs.isNull() == false);
         assert(rhs.isNull() == false);
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_NATIVE_DECIMAL
+        NativeDecimal sum;
+        if (addNativeDecimals(lhs.getNativeDecimal(), rhs.getNativeDecimal(), sum)) {
+            return getNativeDecimalValue(sum);
+        }
+#endif
         TTInt retval(lhs.getDecimal());
         if (retval.Add(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
             char message[4096];
@@ -2240,6 +2352,12 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_NATIVE_DECIMAL
+        NativeDecimal difference;
+        if (subtractNativeDecimals(lhs.getNativeDecimal(), rhs.getNativeDecimal(), difference)) {
+            return getNativeDecimalValue(difference);
+        }
+#endif
         TTInt retval(lhs.getDecimal());
         if (retval.Sub(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
             char message[4096];
@@ -2264,6 +2382,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_NATIVE_DECIMAL
+        // Operands under 2**64 in magnitude, which is any decimal with
+        // fewer than 8 whole digits, have a product that fits 128 bits.
+        NativeDecimal product;
+        if (multiplyNativeDecimals(lhs.getNativeDecimal(), rhs.getNativeDecimal(), product)) {
+            return getNativeDecimalValue(product);
+        }
+#endif
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= rhs.getDecimal();
@@ -2299,6 +2425,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_NATIVE_DECIMAL
+        // The scaled dividend fits 128 bits for any decimal with fewer
+        // than 15 whole digits.
+        NativeDecimal quotient;
+        if (divideNativeDecimals(lhs.getNativeDecimal(), rhs.getNativeDecimal(), quotient)) {
+            return getNativeDecimalValue(quotient);
+        }
+#endif
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= kMaxScaleFactor;
@@ -3669,6 +3803,20 @@ inline NValue NValue::op_add(const NValue& rhs) const {
             rhs.getValueTypeString().c_str());
 }
 
+inline void NValue::op_add_in_place(const NValue& rhs) {
+#ifdef VOLT_NATIVE_DECIMAL
+    if (getValueType() == VALUE_TYPE_DECIMAL && rhs.getValueType() == VALUE_TYPE_DECIMAL &&
+        ! isNull() && ! rhs.isNull()) {
+        NativeDecimal sum;
+        if (addNativeDecimals(getNativeDecimal(), rhs.getNativeDecimal(), sum)) {
+            setNativeDecimal(sum);
+            return;
+        }
+    }
+#endif
+    *this = op_add(rhs);
+}
+
 inline NValue NValue::op_multiply(const NValue& rhs) const {
     ValueType vt = promoteForOp(getValueType(), rhs.getValueType());
     if (isNull() || rhs.isNull()) {
@@ -3828,6 +3976,10 @@ inline NValue NValue::like(const NValue& rhs) const {
                 const uint32_t nextPatternCodePoint = m_pattern.extractCodePoint();
                 switch (nextPatternCodePoint) {
                 case '%': {
+                    // Stacked %s match the same as one, even at the end of the value.
+                    while ( ! m_pattern.atEnd() && *m_pattern.getCursor() == '%') {
+                        m_pattern.extractCodePoint();
+                    }
                     if (m_pattern.atEnd()) {
                         return true;
                     }
@@ -155,6 +155,14 @@ namespace voltdb {
             return m_value[index];
         }
 
+        /**
+         * The parsed value itself, for walking or serializing a whole
+         * subtree rather than reading it key by key.
+         */
+        rapidjson::Value& getRawValue() const {
+            return m_value;
+        }
+
     private:
         PlannerDomValue(rapidjson::Value &value) : m_value(value) {}
 
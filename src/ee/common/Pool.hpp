@@ -78,7 +78,7 @@ class Pool {
 public:
 
     Pool() :
-        m_allocationSize(TEMP_POOL_CHUNK_SIZE), m_maxChunkCount(1), m_currentChunkIndex(0)
+        m_allocationSize(TEMP_POOL_CHUNK_SIZE), m_maxChunkCount(1), m_currentChunkIndex(0), m_purgeCount(0)
     {
         init();
     }
@@ -90,7 +90,8 @@ public:
         m_allocationSize(allocationSize),
 #endif
         m_maxChunkCount(static_cast<std::size_t>(maxChunkCount)),
-        m_currentChunkIndex(0)
+        m_currentChunkIndex(0),
+        m_purgeCount(0)
     {
         init();
     }
@@ -219,6 +220,7 @@ public:
     inline void* allocateZeroes(std::size_t size) { return ::memset(allocate(size), 0, size); }
 
     inline void purge() {
+        ++m_purgeCount;
         /*
          * Erase any oversize chunks that were allocated
          */
@@ -275,10 +277,20 @@ public:
         return total;
     }
 
+    /*
+     * The number of purges so far; anything allocated before the count
+     * last changed has been released.
+     */
+    uint64_t getPurgeCount() const
+    {
+        return m_purgeCount;
+    }
+
 private:
     const uint64_t m_allocationSize;
     std::size_t m_maxChunkCount;
     std::size_t m_currentChunkIndex;
+    uint64_t m_purgeCount;
     std::vector<Chunk> m_chunks;
     /*
      * Oversize chunks that will be freed and not reused.
@@ -294,12 +306,13 @@ private:
  */
 class Pool {
 public:
-    Pool()
+    Pool() :
+        m_memTotal(0), m_purgeCount(0)
     {
     }
 
     Pool(uint64_t allocationSize, uint64_t maxChunkCount) :
-        m_memTotal(0)
+        m_memTotal(0), m_purgeCount(0)
     {
     }
 
@@ -323,6 +336,7 @@ public:
     inline void* allocateZeroes(std::size_t size) { return ::memset(allocate(size), 0, size); }
 
     inline void purge() {
+        ++m_purgeCount;
         for (std::size_t ii = 0; ii < m_allocations.size(); ii++) {
             delete [] m_allocations[ii];
         }
@@ -335,9 +349,15 @@ public:
         return m_memTotal;
     }
 
+    uint64_t getPurgeCount() const
+    {
+        return m_purgeCount;
+    }
+
 private:
     std::vector<char*> m_allocations;
     int64_t m_memTotal;
+    uint64_t m_purgeCount;
     // No implicit copies
     Pool(const Pool&);
     Pool& operator=(const Pool&);
@@ -79,6 +79,37 @@ class TheHashinator {
      */
     virtual int32_t partitionForToken(int32_t hashCode) const = 0;
 
+    /*
+     * Batch forms of partitionForToken and hashinate(NValue) for callers that
+     * route a whole column of values at once, e.g. when validating partitioning.
+     * partitions must have room for count entries.
+     */
+    virtual void partitionsForTokens(const int32_t *hashCodes, int32_t count, int32_t *partitions) const
+    {
+        for (int32_t ii = 0; ii < count; ii++) {
+            partitions[ii] = partitionForToken(hashCodes[ii]);
+        }
+    }
+
+    virtual void partitionsForValues(const NValue *values, int32_t count, int32_t *partitions) const
+    {
+        for (int32_t ii = 0; ii < count; ii++) {
+            partitions[ii] = hashinate(values[ii]);
+        }
+    }
+
+    // A reasonable number of values to route per partitionsForValues call
+    static const int32_t HASHINATE_BATCH_SIZE = 256;
+
+    /*
+     * True if this hashinator routes with the token array Java shares at
+     * configPtr, so it can stand in for a new instance built from that config.
+     */
+    virtual bool sharesConfig(const int32_t *configPtr, uint32_t tokenCount) const
+    {
+        return false;
+    }
+
     virtual std::string debug() const = 0;
 
     virtual ~TheHashinator() {}
@@ -76,6 +76,16 @@ class Topend {
 
     virtual void fallbackToEEAllocatedBuffer(char *buffer, size_t length) = 0;
 
+    /**
+     * Hand out a buffer owned by the topend for the results of the current
+     * batch once they overflow the reused result buffer.  The topend can
+     * build its result tables directly on top of such a buffer instead of
+     * copying them out.  Returns NULL if the topend does not provide result
+     * buffers, in which case the EE allocates one itself and calls
+     * fallbackToEEAllocatedBuffer().
+     */
+    virtual char* allocateResultBuffer(size_t length) { return NULL; }
+
     /** Calls the java method in org.voltdb.utils.Encoder */
     virtual std::string decodeBase64AndDecompress(const std::string& buffer) = 0;
 
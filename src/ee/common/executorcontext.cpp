@@ -18,6 +18,8 @@
 
 #include "common/debuglog.h"
 #include "executors/abstractexecutor.h"
+#include "expressions/JsonPathEvaluator.h"
+#include "expressions/RegexpPatternCache.h"
 #include "storage/AbstractDRTupleStream.h"
 #include "storage/DRTupleStream.h"
 #include "storage/DRTupleStreamUndoAction.h"
@@ -92,8 +94,11 @@ ExecutorContext::ExecutorContext(int64_t siteId,
     m_drStream(drStream),
     m_drReplicatedStream(drReplicatedStream),
     m_engine(engine),
+    m_regexpPatternCache(NULL),
+    m_jsonPathEvaluator(NULL),
     m_txnId(0),
     m_spHandle(0),
+    m_executionCount(0),
     m_lastCommittedSpHandle(0),
     m_siteId(siteId),
     m_partitionId(partitionId),
@@ -106,9 +111,10 @@ ExecutorContext::ExecutorContext(int64_t siteId,
 }
 
 ExecutorContext::~ExecutorContext() {
-    // currently does not own any of its pointers
+    // currently owns only the regular expression cache and the JSON path evaluator
+    delete m_regexpPatternCache;
+    delete m_jsonPathEvaluator;
 
-    // ... or none, now that the one is going away.
     VOLT_DEBUG("De-installing EC(%ld)", (long)this);
 
     pthread_setspecific(static_key, NULL);
@@ -121,6 +127,20 @@ void ExecutorContext::bindToThread()
 }
 
 
+RegexpPatternCache& ExecutorContext::regexpPatternCache() {
+    if (m_regexpPatternCache == NULL) {
+        m_regexpPatternCache = new RegexpPatternCache();
+    }
+    return *m_regexpPatternCache;
+}
+
+JsonPathEvaluator& ExecutorContext::jsonPathEvaluator() {
+    if (m_jsonPathEvaluator == NULL) {
+        m_jsonPathEvaluator = new JsonPathEvaluator();
+    }
+    return *m_jsonPathEvaluator;
+}
+
 ExecutorContext* ExecutorContext::getExecutorContext() {
     (void)pthread_once(&static_keyOnce, globalInitOrCreateOncePerProcess);
     return static_cast<ExecutorContext*>(pthread_getspecific(static_key));
@@ -141,6 +161,7 @@ Table* ExecutorContext::executeExecutors(const std::vector<AbstractExecutor*>& e
     // therefore dependency tracking is not needed here.
     size_t ttl = executorList.size();
     int ctr = 0;
+    ++m_executionCount;
 
     try {
         BOOST_FOREACH (AbstractExecutor *executor, executorList) {
@@ -28,6 +28,8 @@
 #include <vector>
 #include <map>
 
+struct FunctionTest;
+
 namespace voltdb {
 
 extern const int64_t VOLT_EPOCH;
@@ -35,6 +37,8 @@ extern const int64_t VOLT_EPOCH_IN_MILLIS;
 
 class AbstractExecutor;
 class AbstractDRTupleStream;
+class JsonPathEvaluator;
+class RegexpPatternCache;
 class VoltDBEngine;
 
 /*
@@ -49,6 +53,7 @@ class VoltDBEngine;
  * you see a preferable refactoring.
  */
 class ExecutorContext {
+    friend struct ::FunctionTest; // to start an execution without executors
   public:
     ExecutorContext(int64_t siteId,
                     CatalogId partitionId,
@@ -186,6 +191,14 @@ class ExecutorContext {
         return m_currentDRTimestamp;
     }
 
+    /**
+     * Bumped each time a list of executors starts executing, so after
+     * the parameters may have been set for a fragment or a subquery
+     */
+    int64_t executionCount() const {
+        return m_executionCount;
+    }
+
     /** Executor List for a given sub statement id */
     const std::vector<AbstractExecutor*>& getExecutors(int subqueryId) const
     {
@@ -249,6 +262,12 @@ class ExecutorContext {
 
     bool allOutputTempTablesAreEmpty() const;
 
+    /** The site's cache of compiled regular expressions, created on first use */
+    RegexpPatternCache& regexpPatternCache();
+
+    /** The site's JSON path evaluator and path cache, created on first use */
+    JsonPathEvaluator& jsonPathEvaluator();
+
     void checkTransactionForDR();
 
   private:
@@ -266,11 +285,14 @@ class ExecutorContext {
     AbstractDRTupleStream *m_drStream;
     AbstractDRTupleStream *m_drReplicatedStream;
     VoltDBEngine *m_engine;
+    RegexpPatternCache *m_regexpPatternCache;
+    JsonPathEvaluator *m_jsonPathEvaluator;
     int64_t m_txnId;
     int64_t m_spHandle;
     int64_t m_uniqueId;
     int64_t m_currentTxnTimestamp;
     int64_t m_currentDRTimestamp;
+    int64_t m_executionCount;
   public:
     int64_t m_lastCommittedSpHandle;
     int64_t m_siteId;
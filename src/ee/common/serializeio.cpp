@@ -17,6 +17,9 @@
 #include "common/serializeio.h"
 #include "common/executorcontext.hpp"
 
+#include <algorithm>
+#include <memory>
+
 using namespace voltdb;
 
 void FallbackSerializeOutput::expand(size_t minimum_desired) {
@@ -24,7 +27,7 @@ void FallbackSerializeOutput::expand(size_t minimum_desired) {
      * Leave some space for message headers and such, almost 50 megabytes
      */
     size_t maxAllocationSize = ((1024 * 1024 *50) - (1024 * 32));
-    if (fallbackBuffer_ != NULL || minimum_desired > maxAllocationSize) {
+    if (minimum_desired > maxAllocationSize) {
         if (fallbackBuffer_ != NULL) {
             char *temp = fallbackBuffer_;
             fallbackBuffer_ = NULL;
@@ -34,11 +37,27 @@ void FallbackSerializeOutput::expand(size_t minimum_desired) {
             "Output from SQL stmt overflowed output/network buffer of 50mb (-32k for message headers). "
             "Try a \"limit\" clause or a stronger predicate.");
     }
-    fallbackBuffer_ = new char[maxAllocationSize];
-    ::memcpy(fallbackBuffer_, data(), position_);
+    // Grow geometrically rather than jumping to the limit: a topend buffer
+    // stays referenced by the result tables, so keep it close to their size.
+    size_t newCapacity = std::min(std::max(capacity_ * 2, minimum_desired), maxAllocationSize);
+    Topend *topend = ExecutorContext::getExecutorContext()->getTopend();
+    // Results written into a buffer of the topend are handed over without another copy.
+    // The previous fallback buffer stays owned by fallbackBuffer_ until the new buffer
+    // is in place, so it is released by the destructor if the topend call throws.
+    std::unique_ptr<char[]> eeBuffer;
+    char *buffer = topend->allocateResultBuffer(newCapacity);
+    if (buffer == NULL) {
+        eeBuffer.reset(new char[newCapacity]);
+        buffer = eeBuffer.get();
+    }
+    ::memcpy(buffer, data(), position_);
     setPosition(position_);
-    initialize(fallbackBuffer_, maxAllocationSize);
-    ExecutorContext::getExecutorContext()->getTopend()->fallbackToEEAllocatedBuffer(fallbackBuffer_, maxAllocationSize);
+    initialize(buffer, newCapacity);
+    delete []fallbackBuffer_;
+    fallbackBuffer_ = eeBuffer.release();
+    if (fallbackBuffer_ != NULL) {
+        topend->fallbackToEEAllocatedBuffer(fallbackBuffer_, newCapacity);
+    }
 }
 
 template<voltdb::Endianess E>
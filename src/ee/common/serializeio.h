@@ -527,7 +527,7 @@ protected:
 };
 
 /*
- * A serialize output class that falls back to allocating a 50 meg buffer
+ * A serialize output class that falls back to allocating buffers of up to 50 megs
  * if the regular allocation runs out of space. The topend is notified when this occurs.
  */
 class FallbackSerializeOutput : public ReferenceSerializeOutput {
@@ -552,7 +552,12 @@ public:
         delete []fallbackBuffer_;
     }
 
-    /** Expand once to a fallback size, and if that doesn't work abort */
+    /**
+     * Expand to a fallback buffer, doubling its size on every expansion,
+     * and abort once the results would exceed the fallback size.  The
+     * fallback buffer comes from the topend if it provides result buffers,
+     * otherwise it is allocated here and owned by this object.
+     */
     void expand(size_t minimum_desired);
 private:
     char *fallbackBuffer_;
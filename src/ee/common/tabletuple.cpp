@@ -106,4 +106,65 @@ std::string TableTuple::debugNoHeader() const {
     return debug("");
 }
 
+TupleKeyLayout::TupleKeyLayout(const TupleSchema *schema) {
+    const int columnCount = schema->columnCount();
+    for (int ii = 0; ii < columnCount; ii++) {
+        const TupleSchema::ColumnInfo *columnInfo = schema->getColumnInfo(ii);
+        const ValueType type = columnInfo->getVoltType();
+        m_columnTypes.push_back(type);
+        switch (type) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+        case VALUE_TYPE_DECIMAL: {
+            // Equal values of these types, nulls included, have equal bytes.
+            const uint32_t length = static_cast<uint32_t>(NValue::getTupleStorageSize(type));
+            if ( ! m_blocks.empty() &&
+                 m_blocks.back().offset + m_blocks.back().length == columnInfo->offset) {
+                m_blocks.back().length += length;
+            }
+            else {
+                Block block;
+                block.offset = columnInfo->offset;
+                block.length = length;
+                m_blocks.push_back(block);
+            }
+            break;
+        }
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY:
+            m_objectColumns.push_back(ii);
+            break;
+        default:
+            m_otherColumns.push_back(ii);
+            break;
+        }
+    }
+}
+
+bool TupleKeyLayout::fits(const TupleSchema *schema) const {
+    if (schema->columnCount() != m_columnTypes.size()) {
+        return false;
+    }
+    for (int ii = 0; ii < schema->columnCount(); ii++) {
+        if (schema->getColumnInfo(ii)->getVoltType() != m_columnTypes[ii]) {
+            return false;
+        }
+    }
+    // The blocks must be where they are in the schema of the layout.
+    TupleKeyLayout other(schema);
+    if (other.m_blocks.size() != m_blocks.size()) {
+        return false;
+    }
+    for (size_t ii = 0; ii < m_blocks.size(); ii++) {
+        if (other.m_blocks[ii].offset != m_blocks[ii].offset ||
+            other.m_blocks[ii].length != m_blocks[ii].length) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }
@@ -54,11 +54,15 @@
 #include "common/FatalException.hpp"
 #include "common/ExportSerializeIo.h"
 
+#include "boost/shared_ptr.hpp"
+
 #include <cassert>
+#include <cstring>
 #include <ostream>
 #include <iostream>
 #include <vector>
 #include <jsoncpp/jsoncpp.h>
+#include <murmur3/MurmurHash3.h>
 
 #ifndef NDEBUG
 #include "debuglog.h"
@@ -1075,25 +1079,154 @@ inline void TableTuple::freeObjectColumns() const {
 }
 
 /**
- * Hasher for use with boost::unordered_map and similar
+ * Hashes and compares the tuples of one schema as keys of a hash table,
+ * without going through an NValue for each column.  Columns of the
+ * integer, timestamp and decimal types that lie side by side in the
+ * tuple are hashed and compared as one block of bytes.  VARCHAR and
+ * VARBINARY columns are hashed and compared by their length and bytes,
+ * so the out-of-line ones are only followed when not null.  The other
+ * columns (FLOAT, whose equal values may differ in their bytes, and the
+ * geospatial types) are hashed and compared as NValues.
+ *
+ * The hashes differ from TableTuple::hashCode(), and from one layout
+ * to another, so all the keys of a table must be hashed with the same
+ * layout, and so have schemas that fit it.
  */
-struct TableTupleHasher : std::unary_function<TableTuple, std::size_t>
+class TupleKeyLayout {
+public:
+    explicit TupleKeyLayout(const TupleSchema *schema);
+
+    /** Whether tuples of the schema can be hashed and compared with this layout */
+    bool fits(const TupleSchema *schema) const;
+
+    inline size_t hash(const TableTuple &tuple) const;
+    inline bool equals(const TableTuple &lhs, const TableTuple &rhs) const;
+
+private:
+    struct Block {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::vector<Block> m_blocks;
+    std::vector<int> m_objectColumns;
+    std::vector<int> m_otherColumns;
+    std::vector<ValueType> m_columnTypes;
+};
+
+inline size_t TupleKeyLayout::hash(const TableTuple &tuple) const {
+    const char *data = tuple.address() + TUPLE_HEADER_SIZE;
+    uint64_t seed = 0;
+    for (std::vector<Block>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+        seed = MurmurHash64A(data + it->offset, it->length, seed);
+    }
+    for (std::vector<int>::const_iterator it = m_objectColumns.begin(); it != m_objectColumns.end(); ++it) {
+        const NValue value = tuple.getNValue(*it);
+        if (value.isNull()) {
+            // set apart from the empty string
+            seed = MurmurHash64A(NULL, 0, ~seed);
+            continue;
+        }
+        int32_t length;
+        const char *buf = ValuePeeker::peekObject_withoutNull(value, &length);
+        seed = MurmurHash64A(buf, length, seed);
+    }
+    if ( ! m_otherColumns.empty()) {
+        size_t otherSeed = static_cast<size_t>(seed);
+        for (std::vector<int>::const_iterator it = m_otherColumns.begin(); it != m_otherColumns.end(); ++it) {
+            tuple.getNValue(*it).hashCombine(otherSeed);
+        }
+        seed = otherSeed;
+    }
+    return static_cast<size_t>(seed);
+}
+
+inline bool TupleKeyLayout::equals(const TableTuple &lhs, const TableTuple &rhs) const {
+    const char *lhsData = lhs.address() + TUPLE_HEADER_SIZE;
+    const char *rhsData = rhs.address() + TUPLE_HEADER_SIZE;
+    for (std::vector<Block>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+        if (::memcmp(lhsData + it->offset, rhsData + it->offset, it->length) != 0) {
+            return false;
+        }
+    }
+    for (std::vector<int>::const_iterator it = m_objectColumns.begin(); it != m_objectColumns.end(); ++it) {
+        const NValue lhsValue = lhs.getNValue(*it);
+        const NValue rhsValue = rhs.getNValue(*it);
+        if (lhsValue.isNull() || rhsValue.isNull()) {
+            if (lhsValue.isNull() != rhsValue.isNull()) {
+                return false;
+            }
+            continue;
+        }
+        int32_t lhsLength;
+        int32_t rhsLength;
+        const char *lhsBuf = ValuePeeker::peekObject_withoutNull(lhsValue, &lhsLength);
+        const char *rhsBuf = ValuePeeker::peekObject_withoutNull(rhsValue, &rhsLength);
+        if (lhsLength != rhsLength || ::memcmp(lhsBuf, rhsBuf, lhsLength) != 0) {
+            return false;
+        }
+    }
+    for (std::vector<int>::const_iterator it = m_otherColumns.begin(); it != m_otherColumns.end(); ++it) {
+        if (lhs.getNValue(*it).compare(rhs.getNValue(*it)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Hasher for use with boost::unordered_map and similar.  Hashes with
+ * the key layout, if given one, else with TableTuple::hashCode().
+ */
+class TableTupleHasher : public std::unary_function<TableTuple, std::size_t>
 {
+public:
+    TableTupleHasher() {}
+
+    explicit TableTupleHasher(const boost::shared_ptr<const TupleKeyLayout> &layout)
+        : m_layout(layout)
+    {
+    }
+
     /** Generate a 64-bit number for the key value */
     inline size_t operator()(TableTuple tuple) const
     {
+        if (m_layout) {
+            return m_layout->hash(tuple);
+        }
         return tuple.hashCode();
     }
+
+    const TupleKeyLayout *getLayout() const {
+        return m_layout.get();
+    }
+
+private:
+    boost::shared_ptr<const TupleKeyLayout> m_layout;
 };
 
 /**
- * Equality operator for use with boost::unrodered_map and similar
+ * Equality operator for use with boost::unrodered_map and similar.
+ * Must be given the same key layout, if any, as the hasher.
  */
 class TableTupleEqualityChecker {
 public:
+    TableTupleEqualityChecker() {}
+
+    explicit TableTupleEqualityChecker(const boost::shared_ptr<const TupleKeyLayout> &layout)
+        : m_layout(layout)
+    {
+    }
+
     inline bool operator()(const TableTuple lhs, const TableTuple rhs) const {
+        if (m_layout) {
+            return m_layout->equals(lhs, rhs);
+        }
         return lhs.equalsNoSchemaCheck(rhs);
     }
+
+private:
+    boost::shared_ptr<const TupleKeyLayout> m_layout;
 };
 
 }
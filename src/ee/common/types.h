@@ -448,9 +448,11 @@ inline bool tableStreamTypeAppliesToPreTruncateTable(TableStreamType streamType)
 // ------------------------------------------------------------------
 // Statistics Selector Types
 // ------------------------------------------------------------------
+// Values are the ordinals of the matching org.voltdb.StatsSelector.
 enum StatisticsSelectorType {
-    STATISTICS_SELECTOR_TYPE_TABLE,
-    STATISTICS_SELECTOR_TYPE_INDEX
+    STATISTICS_SELECTOR_TYPE_TABLE = 0,
+    STATISTICS_SELECTOR_TYPE_INDEX = 1,
+    STATISTICS_SELECTOR_TYPE_PLAN_NODE = 30
 };
 
 // ------------------------------------------------------------------
@@ -491,7 +493,8 @@ enum TaskType {
     TASK_TYPE_SP_JAVA_GET_DRID_TRACKER = 4,      // not supported in EE
     TASK_TYPE_SET_DRID_TRACKER = 5,              // not supported in EE
     TASK_TYPE_GENERATE_DR_EVENT = 6,
-    TASK_TYPE_RESET_DR_APPLIED_TRACKER = 7       // not supported in EE
+    TASK_TYPE_RESET_DR_APPLIED_TRACKER = 7,      // not supported in EE
+    TASK_TYPE_SET_DR_REPLICATED_APPLIED_SEQUENCE_NUMBERS = 8
 };
 
 // ------------------------------------------------------------------
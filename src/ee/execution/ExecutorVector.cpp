@@ -51,6 +51,7 @@
 #include "plannodes/abstractplannode.h"
 #include "plannodes/abstractplannode.h"
 #include "executors/executorfactory.h"
+#include "stats/StatsAgent.h"
 
 #include "boost/foreach.hpp"
 
@@ -191,6 +192,29 @@ const std::vector<AbstractExecutor*>& ExecutorVector::getExecutorList(int planId
     return *(m_subplanExecListMap.find(planId)->second);
 }
 
+void ExecutorVector::registerPlanNodeStats(StatsAgent* statsAgent) {
+    std::map<int, std::vector<AbstractExecutor*>* >::const_iterator it;
+    for (it = m_subplanExecListMap.begin(); it != m_subplanExecListMap.end(); ++it) {
+        BOOST_FOREACH (AbstractExecutor* executor, *it->second) {
+            PlanNodeStats* stats = executor->getPlanNodeStats();
+            AbstractPlanNode* node = executor->getPlanNode();
+            stats->configure(m_fragId, node->getPlanNodeId(),
+                             planNodeToString(node->getPlanNodeType()));
+            statsAgent->registerStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE, 0, stats);
+        }
+    }
+}
+
+void ExecutorVector::unregisterPlanNodeStats(StatsAgent* statsAgent) {
+    std::map<int, std::vector<AbstractExecutor*>* >::const_iterator it;
+    for (it = m_subplanExecListMap.begin(); it != m_subplanExecListMap.end(); ++it) {
+        BOOST_FOREACH (AbstractExecutor* executor, *it->second) {
+            statsAgent->unregisterStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE, 0,
+                                              executor->getPlanNodeStats());
+        }
+    }
+}
+
 void ExecutorVector::getRidOfSendExecutor(int planId) {
     std::map<int, std::vector<AbstractExecutor*>* >::iterator it = m_subplanExecListMap.find(planId);
     assert(it != m_subplanExecListMap.end());
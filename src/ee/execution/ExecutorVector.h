@@ -46,6 +46,7 @@
 #ifndef EXECUTORVECTOR_H
 #define EXECUTORVECTOR_H
 
+#include "common/ids.h"
 #include "storage/TempTableLimits.h"
 #include "plannodes/plannodefragment.h"
 #include "boost/scoped_ptr.hpp"
@@ -63,6 +64,7 @@ class VoltDBEngine;
 class AbstractPlanNode;
 class AbstractExecutor;
 class ExecutorContext;
+class StatsAgent;
 
 /**
  * A list of executors for runtime.
@@ -100,6 +102,16 @@ public:
 
     void getRidOfSendExecutor(int planId = 0);
 
+    /**
+     * Register the execution profile of each plan node of this
+     * fragment, including those of subqueries, with the stats agent,
+     * all under locator 0.  Done once when the plan is cached, and
+     * undone when it is evicted.
+     */
+    void registerPlanNodeStats(StatsAgent* statsAgent);
+
+    void unregisterPlanNodeStats(StatsAgent* statsAgent);
+
     ~ExecutorVector();
 
 private:
@@ -20,6 +20,7 @@
 
 #include "common/debuglog.h"
 #include "common/StreamBlock.h"
+#include "logging/LogManager.h"
 #include "storage/table.h"
 
 using namespace std;
@@ -91,6 +92,17 @@ JNITopend::JNITopend(JNIEnv *env, jobject caller) : m_jniEnv(env), m_javaExecuti
         throw std::exception();
     }
 
+    m_allocateResultBufferMID =
+            m_jniEnv->GetMethodID(
+                    jniClass,
+                    "allocateResultBuffer",
+                    "(I)Ljava/nio/ByteBuffer;");
+    if (m_allocateResultBufferMID == NULL) {
+        m_jniEnv->ExceptionDescribe();
+        assert(m_allocateResultBufferMID != 0);
+        throw std::exception();
+    }
+
     m_nextDependencyMID = m_jniEnv->GetMethodID(jniClass, "nextDependencyAsBytes", "(I)[B");
     if (m_nextDependencyMID == NULL) {
         m_jniEnv->ExceptionDescribe();
@@ -237,6 +249,26 @@ void JNITopend::fallbackToEEAllocatedBuffer(char *buffer, size_t length) {
     }
 }
 
+char* JNITopend::allocateResultBuffer(size_t length) {
+    JNILocalFrameBarrier jni_frame = JNILocalFrameBarrier(m_jniEnv, 1);
+    if (jni_frame.checkResult() < 0) {
+        VOLT_ERROR("Unable to allocate result buffer: jni frame error.");
+        throw std::exception();
+    }
+
+    // The Java engine holds on to the buffer until it has consumed the results
+    jobject jbuffer = m_jniEnv->CallObjectMethod(m_javaExecutionEngine, m_allocateResultBufferMID,
+                                                 static_cast<jint>(length));
+    if (m_jniEnv->ExceptionCheck()) {
+        m_jniEnv->ExceptionDescribe();
+        throw std::exception();
+    }
+    if (jbuffer == NULL) {
+        return NULL;
+    }
+    return static_cast<char*>(m_jniEnv->GetDirectBufferAddress(jbuffer));
+}
+
 int JNITopend::loadNextDependency(int32_t dependencyId, voltdb::Pool *stringPool, Table* destination) {
     VOLT_DEBUG("iterating java dependency for id %d", dependencyId);
 
@@ -345,6 +377,8 @@ std::string JNITopend::decodeBase64AndDecompress(const std::string& base64Str) {
 }
 
 void JNITopend::crashVoltDB(FatalException e) {
+    // Get out the debug output leading up to the crash
+    LogManager::drainThreadLogRing();
     //Enough references for the reason string, traces array, and traces strings
     JNILocalFrameBarrier jni_frame =
             JNILocalFrameBarrier(
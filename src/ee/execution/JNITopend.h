@@ -59,6 +59,8 @@ public:
 
     void fallbackToEEAllocatedBuffer(char *buffer, size_t length);
 
+    char* allocateResultBuffer(size_t length);
+
     std::string decodeBase64AndDecompress(const std::string& buffer);
 
 private:
@@ -70,6 +72,7 @@ private:
     */
     jobject m_javaExecutionEngine;
     jmethodID m_fallbackToEEAllocatedBufferMID;
+    jmethodID m_allocateResultBufferMID;
     jmethodID m_nextDependencyMID;
     jmethodID m_fragmentProgressUpdateMID;
     jmethodID m_planForFragmentIdMID;
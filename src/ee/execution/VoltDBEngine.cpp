@@ -149,6 +149,7 @@ VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy)
       m_currentUndoQuantum(NULL),
       m_partitionId(-1),
       m_hashinator(NULL),
+      m_configHashinator(NULL),
       m_isActiveActiveDREnabled(false),
       m_staticParams(MAX_PARAM_COUNT),
       m_pfCount(0),
@@ -903,16 +904,15 @@ VoltDBEngine::processCatalogAdditions(int64_t timestamp)
             //////////////////////////////////////////
 
             if (haveDifferentSchema(catalogTable, persistentTable)) {
-                char msg[512];
-                snprintf(msg, sizeof(msg), "Table %s has changed schema and will be rebuilt.",
-                         catalogTable->name().c_str());
-                LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_DEBUG, msg);
+                LogManager::getThreadLogger(LOGGERID_HOST)->logFormat(LOGLEVEL_DEBUG,
+                        "Table %s has changed schema and will be rebuilt.",
+                        catalogTable->name().c_str());
 
                 tcd->processSchemaChanges(*m_database, *catalogTable, m_delegatesByName);
 
-                snprintf(msg, sizeof(msg), "Table %s was successfully rebuilt with new schema.",
-                         catalogTable->name().c_str());
-                LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_DEBUG, msg);
+                LogManager::getThreadLogger(LOGGERID_HOST)->logFormat(LOGLEVEL_DEBUG,
+                        "Table %s was successfully rebuilt with new schema.",
+                        catalogTable->name().c_str());
 
                 // don't continue on to modify/add/remove indexes, because the
                 // call above should rebuild them all anyway
@@ -1087,6 +1087,7 @@ VoltDBEngine::updateCatalog(const int64_t timestamp, const std::string &catalogP
 {
     // clean up execution plans when the tables underneath might change
     if (m_plans) {
+        m_statsManager.unregisterStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE);
         m_plans->clear();
     }
 
@@ -1289,6 +1290,7 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId)
     }
 
     boost::shared_ptr<ExecutorVector> ev_guard = ExecutorVector::fromJsonPlan(this, plan, fragId);
+    ev_guard->registerPlanNodeStats(&m_statsManager);
 
     // add the plan to the back
     //
@@ -1299,6 +1301,7 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId)
     // remove a plan from the front if the cache is full
     if (plans.size() > PLAN_CACHE_SIZE) {
         PlanSet::iterator iter = plans.get<0>().begin();
+        (*iter)->unregisterPlanNodeStats(&m_statsManager);
         plans.erase(iter);
     }
 
@@ -1465,6 +1468,7 @@ typedef std::pair<std::string, StreamedTable*> LabeledStream;
 
 /** Perform once per second, non-transactional work. */
 void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
+    m_logManager.drainLogRing();
     m_executorContext->setupForTick(lastCommittedSpHandle);
     BOOST_FOREACH (LabeledStream table, m_exportingTables) {
         table.second->flushOldTuples(timeInMillis);
@@ -1477,6 +1481,7 @@ void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
 
 /** Bring the Export and DR system to a steady state with no pending committed data */
 void VoltDBEngine::quiesce(int64_t lastCommittedSpHandle) {
+    m_logManager.drainLogRing();
     m_executorContext->setupForQuiesce(lastCommittedSpHandle);
     BOOST_FOREACH (LabeledStream table, m_exportingTables) {
         table.second->flushOldTuples(-1L);
@@ -1562,6 +1567,15 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
                 }
             }
 
+            resultTable = m_statsManager.getStats(
+                (StatisticsSelectorType) selector,
+                locatorIds, interval, now);
+            break;
+        case STATISTICS_SELECTOR_TYPE_PLAN_NODE:
+            // Locators are ignored: report every plan node of every
+            // fragment in the plan cache, which registers them all
+            // under locator 0.
+            locatorIds.assign(1, 0);
             resultTable = m_statsManager.getStats(
                 (StatisticsSelectorType) selector,
                 locatorIds, interval, now);
@@ -1876,6 +1890,31 @@ void VoltDBEngine::updateHashinator(HashinatorType type, const char *config, int
     }
 }
 
+TheHashinator* VoltDBEngine::hashinatorForConfig(HashinatorType type, const char *config,
+                                                 int32_t *configPtr, uint32_t numTokens) {
+    if (type == HASHINATOR_ELASTIC && configPtr != NULL) {
+        if (m_hashinator && m_hashinator->sharesConfig(configPtr, numTokens)) {
+            return m_hashinator.get();
+        }
+        if (m_configHashinator && m_configHashinator->sharesConfig(configPtr, numTokens)) {
+            return m_configHashinator.get();
+        }
+    }
+
+    switch (type) {
+    case HASHINATOR_LEGACY:
+        m_configHashinator.reset(LegacyHashinator::newInstance(config));
+        break;
+    case HASHINATOR_ELASTIC:
+        m_configHashinator.reset(ElasticHashinator::newInstance(config, configPtr, numTokens));
+        break;
+    default:
+        throwFatalException("Unknown hashinator type %d", type);
+        break;
+    }
+    return m_configHashinator.get();
+}
+
 void VoltDBEngine::dispatchValidatePartitioningTask(ReferenceSerializeInputBE &taskInfo) {
     std::vector<CatalogId> tableIds;
     const int32_t numTables = taskInfo.readInt();
@@ -1980,6 +2019,19 @@ void VoltDBEngine::executeTask(TaskType taskType, ReferenceSerializeInputBE &tas
         m_resultOutput.writeInt(0);
         break;
     }
+    case TASK_TYPE_SET_DR_REPLICATED_APPLIED_SEQUENCE_NUMBERS: {
+        // Last applied replicated stream sequence number per remote cluster,
+        // as persisted by the consumer's applied DR id trackers
+        boost::unordered_map<int32_t, int64_t> sequenceNumbers;
+        int32_t clusterCount = taskInfo.readInt();
+        for (int32_t i = 0; i < clusterCount; ++i) {
+            int32_t remoteClusterId = taskInfo.readInt();
+            sequenceNumbers[remoteClusterId] = taskInfo.readLong();
+        }
+        m_wrapper.setReplicatedSequenceNumbers(sequenceNumbers);
+        m_resultOutput.writeInt(0);
+        break;
+    }
     case TASK_TYPE_SET_DR_PROTOCOL_VERSION: {
         uint32_t drVersion = taskInfo.readInt();
         if (drVersion != DRTupleStream::PROTOCOL_VERSION) {
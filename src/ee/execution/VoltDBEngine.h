@@ -387,6 +387,15 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         void updateHashinator(HashinatorType type, const char *config,
                               int32_t *configPtr, uint32_t numTokens);
 
+        /**
+         * The hashinator for a config passed to a one-off hashinate call.
+         * An elastic config shared by address reuses the installed
+         * hashinator, or the one built for the previous call, instead of
+         * laying its tokens out again.  The engine owns the result.
+         */
+        TheHashinator* hashinatorForConfig(HashinatorType type, const char *config,
+                                           int32_t *configPtr, uint32_t numTokens);
+
         int64_t applyBinaryLog(int64_t txnId,
                             int64_t spHandle,
                             int64_t lastCommittedSpHandle,
@@ -395,6 +404,14 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                             int64_t undoToken,
                             const char *log);
 
+        /*
+         * The replicated stream DR txns from a remote cluster are applied
+         * in sequence on every site; this is the last one applied here.
+         */
+        int64_t getLastAppliedReplicatedDRSequenceNumber(int32_t remoteClusterId) const {
+            return m_wrapper.lastAppliedReplicatedSequenceNumber(remoteClusterId);
+        }
+
         /*
          * Execute an arbitrary task represented by the task id and serialized parameters.
          * Returns serialized representation of the results
@@ -486,6 +503,8 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         int32_t m_partitionId;
         int32_t m_clusterIndex;
         boost::scoped_ptr<TheHashinator> m_hashinator;
+        // Built by hashinatorForConfig for a config other than the installed one
+        boost::scoped_ptr<TheHashinator> m_configHashinator;
         size_t m_startOfResultBuffer;
         int64_t m_tempTableMemoryLimit;
 
@@ -0,0 +1,176 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include "executors/PlanNodeStats.h"
+#include "stats/StatsSource.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> PlanNodeStats::generatePlanNodeStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("FRAGMENT_ID");
+    columnNames.push_back("PLAN_NODE_ID");
+    columnNames.push_back("PLAN_NODE_TYPE");
+    columnNames.push_back("INVOCATIONS");
+    columnNames.push_back("ROWS_IN");
+    columnNames.push_back("ROWS_OUT");
+    columnNames.push_back("CPU_CYCLES");
+    columnNames.push_back("PEAK_TEMP_TABLE_BYTES");
+    columnNames.push_back("INDEX_PROBES");
+    return columnNames;
+}
+
+void PlanNodeStats::populatePlanNodeStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+
+    // fragment id
+    types.push_back(VALUE_TYPE_BIGINT);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // plan node id
+    types.push_back(VALUE_TYPE_INTEGER);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // plan node type
+    types.push_back(VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(64);
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // invocations, rows in, rows out, cycles, peak temp table bytes, index probes
+    for (int ii = 0; ii < 6; ++ii) {
+        types.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        allowNull.push_back(false);
+        inBytes.push_back(false);
+    }
+}
+
+TempTable* PlanNodeStats::generateEmptyPlanNodeStatsTable() {
+    string name = "Plan node aggregated stats temp table";
+    vector<string> columnNames = PlanNodeStats::generatePlanNodeStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    PlanNodeStats::populatePlanNodeStatsSchema(columnTypes, columnLengths,
+                                               columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+PlanNodeStats::PlanNodeStats()
+    : StatsSource(), m_configured(false), m_fragmentId(0), m_planNodeId(0),
+      m_invocations(0), m_rowsIn(0), m_rowsOut(0), m_cycles(0), m_indexProbes(0),
+      m_peakTempTableBytes(0),
+      m_lastInvocations(0), m_lastRowsIn(0), m_lastRowsOut(0), m_lastCycles(0),
+      m_lastIndexProbes(0)
+{
+}
+
+void PlanNodeStats::configure(int64_t fragmentId, int32_t planNodeId, const string& planNodeType) {
+    ostringstream name;
+    name << "Plan node " << planNodeId << " of fragment " << fragmentId;
+    StatsSource::configure(name.str());
+    m_fragmentId = fragmentId;
+    m_planNodeId = planNodeId;
+    m_planNodeType = ValueFactory::getStringValue(planNodeType);
+    m_configured = true;
+}
+
+vector<string> PlanNodeStats::generateStatsColumnNames()
+{
+    return PlanNodeStats::generatePlanNodeStatsColumnNames();
+}
+
+void PlanNodeStats::updateStatsTuple(TableTuple *tuple) {
+    int64_t invocations = m_invocations;
+    int64_t rowsIn = m_rowsIn;
+    int64_t rowsOut = m_rowsOut;
+    uint64_t cycles = m_cycles;
+    int64_t indexProbes = m_indexProbes;
+    int64_t peakTempTableBytes = m_peakTempTableBytes;
+
+    if (interval()) {
+        invocations -= m_lastInvocations;
+        rowsIn -= m_lastRowsIn;
+        rowsOut -= m_lastRowsOut;
+        cycles -= m_lastCycles;
+        indexProbes -= m_lastIndexProbes;
+        m_lastInvocations = m_invocations;
+        m_lastRowsIn = m_rowsIn;
+        m_lastRowsOut = m_rowsOut;
+        m_lastCycles = m_cycles;
+        m_lastIndexProbes = m_indexProbes;
+        m_peakTempTableBytes = 0;
+    }
+
+    tuple->setNValue(StatsSource::m_columnName2Index["FRAGMENT_ID"],
+                     ValueFactory::getBigIntValue(m_fragmentId));
+    tuple->setNValue(StatsSource::m_columnName2Index["PLAN_NODE_ID"],
+                     ValueFactory::getIntegerValue(m_planNodeId));
+    tuple->setNValue(StatsSource::m_columnName2Index["PLAN_NODE_TYPE"], m_planNodeType);
+    tuple->setNValue(StatsSource::m_columnName2Index["INVOCATIONS"],
+                     ValueFactory::getBigIntValue(invocations));
+    tuple->setNValue(StatsSource::m_columnName2Index["ROWS_IN"],
+                     ValueFactory::getBigIntValue(rowsIn));
+    tuple->setNValue(StatsSource::m_columnName2Index["ROWS_OUT"],
+                     ValueFactory::getBigIntValue(rowsOut));
+    tuple->setNValue(StatsSource::m_columnName2Index["CPU_CYCLES"],
+                     ValueFactory::getBigIntValue(static_cast<int64_t>(cycles)));
+    tuple->setNValue(StatsSource::m_columnName2Index["PEAK_TEMP_TABLE_BYTES"],
+                     ValueFactory::getBigIntValue(peakTempTableBytes));
+    tuple->setNValue(StatsSource::m_columnName2Index["INDEX_PROBES"],
+                     ValueFactory::getBigIntValue(indexProbes));
+}
+
+void PlanNodeStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    PlanNodeStats::populatePlanNodeStatsSchema(types, columnLengths, allowNull, inBytes);
+}
+
+PlanNodeStats::~PlanNodeStats() {
+    if (m_configured) {
+        m_planNodeType.free();
+    }
+}
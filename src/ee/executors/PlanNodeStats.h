@@ -0,0 +1,141 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLANNODESTATS_H_
+#define PLANNODESTATS_H_
+
+#include "stats/StatsSource.h"
+
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+namespace voltdb {
+class TableTuple;
+class TempTable;
+
+/**
+ * StatsSource extension for the executors of plan nodes.  Every
+ * executor counts its invocations, the rows it consumed from its
+ * children and produced into its output table, the time it spent in
+ * p_execute, the peak size of its output temp table and the index
+ * probes it made.  The time of a node does not include that of its
+ * children, which run before it, so the times of the nodes of a
+ * fragment add up to the time of the fragment.  Rows of the stats
+ * table carry the fragment id so they can be aggregated by fragment.
+ */
+class PlanNodeStats : public StatsSource {
+public:
+    /**
+     * Static method to generate the column names for the tables which
+     * contain plan node stats.
+     */
+    static std::vector<std::string> generatePlanNodeStatsColumnNames();
+
+    /**
+     * Static method to generate the remaining schema information for
+     * the tables which contain plan node stats.
+     */
+    static void populatePlanNodeStatsSchema(std::vector<voltdb::ValueType>& types,
+                                            std::vector<int32_t>& columnLengths,
+                                            std::vector<bool>& allowNull,
+                                            std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyPlanNodeStatsTable();
+
+    /**
+     * A cheap, monotonic time stamp: the CPU cycle counter on x86,
+     * nanoseconds elsewhere.
+     */
+    static uint64_t readCycleCounter()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+    }
+
+    PlanNodeStats();
+
+    ~PlanNodeStats();
+
+    /**
+     * Configure the StatsSource superclass, once, when the plan of the
+     * executor is cached and its stats are registered.
+     */
+    void configure(int64_t fragmentId, int32_t planNodeId, const std::string& planNodeType);
+
+    bool isConfigured() const { return m_configured; }
+
+    void recordExecution(int64_t rowsIn, int64_t rowsOut, uint64_t cycles, int64_t tempTableBytes)
+    {
+        ++m_invocations;
+        m_rowsIn += rowsIn;
+        m_rowsOut += rowsOut;
+        m_cycles += cycles;
+        if (tempTableBytes > m_peakTempTableBytes) {
+            m_peakTempTableBytes = tempTableBytes;
+        }
+    }
+
+    void countIndexProbes(int64_t probes)
+    {
+        m_indexProbes += probes;
+    }
+
+protected:
+
+    /**
+     * Update the stats tuple with the latest statistics available to this StatsSource.
+     */
+    virtual void updateStatsTuple(TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    bool m_configured;
+    int64_t m_fragmentId;
+    int32_t m_planNodeId;
+    voltdb::NValue m_planNodeType;
+
+    int64_t m_invocations;
+    int64_t m_rowsIn;
+    int64_t m_rowsOut;
+    uint64_t m_cycles;
+    int64_t m_indexProbes;
+    // Reset whenever interval stats are read
+    int64_t m_peakTempTableBytes;
+
+    int64_t m_lastInvocations;
+    int64_t m_lastRowsIn;
+    int64_t m_lastRowsOut;
+    uint64_t m_lastCycles;
+    int64_t m_lastIndexProbes;
+};
+
+}
+
+#endif /* PLANNODESTATS_H_ */
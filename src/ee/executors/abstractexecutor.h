@@ -50,6 +50,7 @@
 #include "common/tabletuple.h"
 #include "common/types.h"
 #include "execution/VoltDBEngine.h"
+#include "executors/PlanNodeStats.h"
 #include "plannodes/abstractplannode.h"
 #include "storage/temptable.h"
 
@@ -80,6 +81,9 @@ class AbstractExecutor {
      */
     inline AbstractPlanNode* getPlanNode() { return m_abstractNode; }
 
+    /** Execution profile of this executor, collected by execute() */
+    PlanNodeStats* getPlanNodeStats() { return &m_planNodeStats; }
+
     inline void cleanupTempOutputTable()
     {
         if (m_tmpOutputTable) {
@@ -148,6 +152,9 @@ class AbstractExecutor {
      */
     void setDMLCountOutputTable(TempTableLimits* limits);
 
+    /** Executors that look up index keys report each lookup here. */
+    void countIndexProbes(int64_t probes) { m_planNodeStats.countIndexProbes(probes); }
+
     // execution engine owns the plannode allocation.
     AbstractPlanNode* m_abstractNode;
     TempTable* m_tmpOutputTable;
@@ -155,6 +162,8 @@ class AbstractExecutor {
     /** reference to the engine to call up to the top end */
     VoltDBEngine* m_engine;
 
+private:
+    PlanNodeStats m_planNodeStats;
 };
 
 
@@ -163,8 +172,25 @@ inline bool AbstractExecutor::execute(const NValueArray& params)
     assert(m_abstractNode);
     VOLT_TRACE("Starting execution of plannode(id=%d)...",  m_abstractNode->getPlanNodeId());
 
+    // The children have run, and their output tables are our input.
+    int64_t rowsIn = 0;
+    for (size_t ii = 0; ii < m_abstractNode->getInputTableCount(); ++ii) {
+        rowsIn += m_abstractNode->getInputTable(static_cast<int>(ii))->activeTupleCount();
+    }
+    uint64_t startCycles = PlanNodeStats::readCycleCounter();
+
     // run the executor
-    return p_execute(params);
+    bool result = p_execute(params);
+
+    uint64_t cycles = PlanNodeStats::readCycleCounter() - startCycles;
+    int64_t rowsOut = 0;
+    int64_t tempTableBytes = 0;
+    if (m_tmpOutputTable != NULL) {
+        rowsOut = m_tmpOutputTable->activeTupleCount();
+        tempTableBytes = m_tmpOutputTable->allocatedTupleMemory();
+    }
+    m_planNodeStats.recordExecution(rowsIn, rowsOut, cycles, tempTableBytes);
+    return result;
 }
 
 }
@@ -45,6 +45,7 @@
 
 #include "executors/aggregateexecutor.h"
 
+#include "common/HyperLogLogSketch.h"
 #include "common/ValueFactory.hpp"
 #include "common/common.h"
 #include "common/debuglog.h"
@@ -58,13 +59,11 @@
 
 #include "boost/foreach.hpp"
 #include "boost/unordered_map.hpp"
-#include "hyperloglog/hyperloglog.hpp" // for APPROX_COUNT_DISTINCT
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
 #include <set>
-#include <sstream>
 #include <stdint.h>
 #include <utility>
 
@@ -158,7 +157,7 @@ class SumAgg : public Agg
             m_haveAdvanced = true;
         }
         else {
-            m_value = m_value.op_add(val);
+            m_value.op_add_in_place(val);
         }
     }
 
@@ -196,7 +195,7 @@ public:
             m_value = val;
         }
         else {
-            m_value = m_value.op_add(val);
+            m_value.op_add_in_place(val);
         }
         ++m_count;
     }
@@ -388,11 +387,6 @@ private:
 
 class ApproxCountDistinctAgg : public Agg {
 public:
-    ApproxCountDistinctAgg()
-        : m_hyperLogLog(registerBitWidth())
-    {
-    }
-
     virtual void advance(const NValue& val)
     {
         if (val.isNull()) {
@@ -415,12 +409,12 @@ public:
         const char* data = ValuePeeker::peekPointerToDataBytes(val, &valLength);
         assert(valLength != 0);
 
-        m_hyperLogLog.add(data, static_cast<uint32_t>(valLength));
+        m_sketch.add(data, static_cast<uint32_t>(valLength));
     }
 
     virtual NValue finalize(ValueType type)
     {
-        double estimate = m_hyperLogLog.estimate();
+        double estimate = m_sketch.estimate();
         estimate = ::round(estimate); // round to nearest integer
         m_value = ValueFactory::getBigIntValue(static_cast<int64_t>(estimate));
         return m_value;
@@ -428,34 +422,21 @@ public:
 
     virtual void resetAgg()
     {
-        hyperLogLog().clear();
+        m_sketch.clear();
         Agg::resetAgg();
     }
 
 protected:
-    hll::HyperLogLog& hyperLogLog() {
-        return m_hyperLogLog;
-    }
-
-    static uint8_t registerBitWidth() {
-        // Setting this value higher makes for a more accurate
-        // estimate but means that the hyperloglogs sent to the
-        // coordinator from each partition will be larger.
-        //
-        // This value is called "b" in the hyperloglog code
-        // and papers.  Size of the hyperloglog will be
-        // 2^b + 1 bytes.
-        //
-        // For the version of hyperloglog we use in VoltDB, the max
-        // value allowed for b is 16, so the hyperloglogs sent to the
-        // coordinator will be 65537 bytes apiece, which seems
-        // reasonable.
-        return 16;
+    // The sketch stays sparse, a few bytes per distinct value, until it
+    // has enough values to be worth its 64KB of dense registers.  So a
+    // GROUP BY with many small groups no longer pays 64KB per group.
+    HyperLogLogSketch& sketch() {
+        return m_sketch;
     }
 
 private:
 
-    hll::HyperLogLog m_hyperLogLog;
+    HyperLogLogSketch m_sketch;
 };
 
 /// When APPROX_COUNT_DISTINCT is split across two fragments of a
@@ -469,15 +450,11 @@ public:
     {
         assert (type == VALUE_TYPE_VARBINARY);
         // serialize the hyperloglog as varbinary, to send to
-        // coordinator.
-        //
-        // TODO: We're doing a fair bit of copying here, first to the
-        // string stream, then to the temp varbinary object.  We could
-        // get away with just one copy here.
-        std::ostringstream oss;
-        hyperLogLog().dump(oss);
-        return ValueFactory::getTempBinaryValue(oss.str().c_str(),
-                                                static_cast<int32_t>(oss.str().length()));
+        // coordinator.  A sparse sketch takes a couple of bytes per
+        // distinct value, a dense one 40KB.
+        std::vector<char> buffer(sketch().serializedSize());
+        sketch().serializeTo(&buffer[0]);
+        return ValueFactory::getTempBinaryValue(&buffer[0], static_cast<int32_t>(buffer.size()));
     }
 };
 
@@ -492,18 +469,18 @@ public:
         assert (ValuePeeker::peekValueType(val) == VALUE_TYPE_VARBINARY);
         assert (!val.isNull());
 
-        // TODO: we're doing some unnecessary copying here to
-        // deserialize the hyperloglog and merge it with the
-        // agg's HLL instance.
-
         int32_t length;
         const char* buf = ValuePeeker::peekObject_withoutNull(val, &length);
         assert (length > 0);
-        std::istringstream iss(std::string(buf, length));
-        hll::HyperLogLog distHll(registerBitWidth());
-        distHll.restore(iss);
-        hyperLogLog().merge(distHll);
+        if (! m_partial.deserializeFrom(buf, length)) {
+            throwDynamicSQLException("Received an invalid hyperloglog of %d bytes", length);
+        }
+        sketch().merge(m_partial);
     }
+
+private:
+    // Reused for each partition's sketch
+    HyperLogLogSketch m_partial;
 };
 
 /**
@@ -856,6 +833,19 @@ bool AggregateExecutorBase::outputForEachInputRow() const {
     return false;
 }
 
+/**
+ * Hash and compare the group by keys by the layout of their schema,
+ * rather than column by column through NValues.
+ */
+static void useKeyLayout(HashAggregateMapType& hash, const TupleSchema* keySchema)
+{
+    if (hash.hash_function().getLayout() != NULL) {
+        return;
+    }
+    boost::shared_ptr<const TupleKeyLayout> layout(new TupleKeyLayout(keySchema));
+    HashAggregateMapType(0, TableTupleHasher(layout), TableTupleEqualityChecker(layout)).swap(hash);
+}
+
 AggregateHashExecutor::~AggregateHashExecutor() {}
 
 TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
@@ -863,6 +853,7 @@ TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
 {
     VOLT_TRACE("hash aggregate executor init..");
     m_hash.clear();
+    useKeyLayout(m_hash, m_groupByKeySchema);
 
     return AggregateExecutorBase::p_execute_init(params, pmp, schema, newTempTable, parentPostfilter);
 }
@@ -1101,6 +1092,7 @@ TableTuple AggregatePartialExecutor::p_execute_init(const NValueArray& params,
     nextPartialGroupByKeyTuple.move(NULL);
 
     m_hash.clear();
+    useKeyLayout(m_hash, m_groupByKeyPartialHashSchema);
 
     // for next input tuple
     return nextInputTuple;
@@ -322,6 +322,7 @@ bool IndexCountExecutor::p_execute(const NValueArray &params)
     int leftIncluded = 0, rightIncluded = 0;
 
     if (m_numOfSearchkeys != 0) {
+        countIndexProbes(1);
         // Deal with multi-map
         VOLT_DEBUG("INDEX_LOOKUP_TYPE(%d) m_numSearchkeys(%d) key:%s",
                    localLookupType, activeNumOfSearchKeys, searchKey.debugNoHeader().c_str());
@@ -366,6 +367,7 @@ bool IndexCountExecutor::p_execute(const NValueArray &params)
     }
 
     if (m_numOfEndkeys != 0) {
+        countIndexProbes(1);
         if (endKeyOverflow) {
             rkEnd = tableIndex->getCounterGET(&endKey, true, indexCursor);
         } else {
@@ -81,11 +81,31 @@ struct SetOperator {
     static void printTupleSet(const char* nonce, TupleSet &tuples);
 
 protected:
+    // The key layout shared by all the input tables, or NULL if their
+    // tuples must be hashed and compared column by column.
+    boost::shared_ptr<const TupleKeyLayout> getKeyLayout() const;
+
     const std::vector<TableReference>& m_input_tablerefs;
     TempTable* const m_output_table;
     bool const m_is_all;
 };
 
+boost::shared_ptr<const TupleKeyLayout> SetOperator::getKeyLayout() const
+{
+    boost::shared_ptr<const TupleKeyLayout> layout;
+    if (m_input_tablerefs.empty()) {
+        return layout;
+    }
+    layout.reset(new TupleKeyLayout(m_input_tablerefs[0].getTable()->schema()));
+    for (size_t ii = 1; ii < m_input_tablerefs.size(); ++ii) {
+        if ( ! layout->fits(m_input_tablerefs[ii].getTable()->schema())) {
+            layout.reset();
+            break;
+        }
+    }
+    return layout;
+}
+
 struct UnionSetOperator : public SetOperator {
     UnionSetOperator(const std::vector<TableReference>& input_tablerefs,
                      TempTable* output_table,
@@ -108,7 +128,8 @@ private:
 bool UnionSetOperator::processTuples()
 {
     // Set to keep candidate tuples.
-    TupleSet tuples;
+    boost::shared_ptr<const TupleKeyLayout> layout = getKeyLayout();
+    TupleSet tuples(0, TableTupleHasher(layout), TableTupleEqualityChecker(layout));
 
     //
     // For each input table, grab their TableIterator and then append all of its tuples
@@ -183,7 +204,8 @@ bool ExceptIntersectSetOperator::processTuples()
 {
     // Map to keep candidate tuples. The key is the tuple itself
     // The value - tuple's repeat count in the final table.
-    TupleMap tuples;
+    boost::shared_ptr<const TupleKeyLayout> layout = getKeyLayout();
+    TupleMap tuples(0, TableTupleHasher(layout), TableTupleEqualityChecker(layout));
 
     assert( ! m_input_tables.empty());
 
@@ -206,7 +228,7 @@ bool ExceptIntersectSetOperator::processTuples()
     // For each remaining input table, collect its tuple into a separate map
     // and substract/intersect it from/with the first one
     //
-    TupleMap next_tuples;
+    TupleMap next_tuples(0, TableTupleHasher(layout), TableTupleEqualityChecker(layout));
     for (size_t ctr = 1, cnt = m_input_tables.size(); ctr < cnt; ctr++) {
         next_tuples.clear();
         input_table = m_input_tables[ctr];
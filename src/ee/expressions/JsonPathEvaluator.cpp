@@ -0,0 +1,434 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/JsonPathEvaluator.h"
+
+#include "common/SQLException.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <inttypes.h>
+
+namespace voltdb {
+
+std::vector<JsonPathNode> JsonPathParser::resolve(const char* pathChars, int32_t lenPath,
+                                                  bool enforceArrayIndexLimitForSet) {
+    // NULL path refers directly to the doc root
+    if (pathChars == NULL) {
+        return std::vector<JsonPathNode>();
+    }
+    JsonPathParser parser(pathChars, lenPath);
+    return parser.resolve(lenPath, enforceArrayIndexLimitForSet);
+}
+
+std::vector<JsonPathNode> JsonPathParser::resolve(int32_t lenPath, bool enforceArrayIndexLimitForSet) {
+    std::vector<JsonPathNode> path;
+    char c;
+    bool first = true;
+    bool expectArrayIndex = false;
+    bool expectField = false;
+    char strField[lenPath + 1];
+    while (readChar(c)) {
+        if (expectArrayIndex) {
+            // -1 index to refer to the tail of the array
+            bool neg = false;
+            if (c == '-') {
+                neg = true;
+                if (!readChar(c)) {
+                    throwInvalidPathError("Unexpected termination (unterminated array access)");
+                }
+            }
+            if (c < '0' || c > '9') {
+                throwInvalidPathError("Unexpected character in array index");
+            }
+            // atoi while advancing our pointer
+            int64_t arrayIndex = c - '0';
+            bool terminated = false;
+            while (readChar(c)) {
+                if (c == ']') {
+                    terminated = true;
+                    break;
+                } else if (c < '0' || c > '9') {
+                    throwInvalidPathError("Unexpected character in array index");
+                }
+                arrayIndex = 10 * arrayIndex + (c - '0');
+                if (enforceArrayIndexLimitForSet) {
+                    // This 500000 is a mostly arbitrary maximum JSON array index enforced for practical
+                    // purposes. We enforce this up front to avoid excessive delays, ridiculous short-term
+                    // memory growth, and/or bad_alloc errors that the jsoncpp library could produce
+                    // essentially for nothing since our supported JSON document columns are typically not
+                    // wide enough to hold the string representations of arrays this large.
+                    if (arrayIndex > 500000) {
+                        if (neg) {
+                            // other than the special '-1' case, negative indices aren't allowed
+                            throwInvalidPathError("Array index less than -1");
+                        }
+                        throwInvalidPathError("Array index greater than the maximum allowed value of 500000");
+                    }
+                } else {
+                    if (arrayIndex > static_cast<int64_t>(INT32_MAX)) {
+                        if (neg) {
+                            // other than the special '-1' case, negative indices aren't allowed
+                            throwInvalidPathError("Array index less than -1");
+                        }
+                        throwInvalidPathError("Array index greater than the maximum integer value");
+                    }
+                }
+            }
+            if ( ! terminated ) {
+                throwInvalidPathError("Missing ']' after array index");
+            }
+            if (neg) {
+                // other than the special '-1' case, negative indices aren't allowed
+                if (arrayIndex != 1) {
+                    throwInvalidPathError("Array index less than -1");
+                }
+                arrayIndex = ARRAY_TAIL;
+            }
+            path.push_back(static_cast<int32_t>(arrayIndex));
+            expectArrayIndex = false;
+        } else if (c == '[') {
+            // handle the case of empty field names. for example, getting the first element of the array
+            // in { "a": { "": [ true, false ] } } would be the path 'a.[0]'
+            if (expectField) {
+                path.push_back(JsonPathNode(""));
+                expectField = false;
+            }
+            expectArrayIndex = true;
+        } else if (c == '.') {
+            // a leading '.' also involves accessing the "" property of the root...
+            if (expectField || first) {
+                path.push_back(JsonPathNode(""));
+            }
+            expectField = true;
+        } else {
+            expectField = false;
+            // read a literal field name
+            int32_t i = 0;
+            do {
+                if (c == '\\') {
+                    if (!readChar(c) || (c != '[' && c != ']' && c != '.' && c != '\\')) {
+                        throwInvalidPathError("Unescaped backslash (double escaping required for path)");
+                    }
+                } else if (c == '.') {
+                    expectField = true;
+                    break;
+                } else if (c == '[') {
+                    expectArrayIndex = true;
+                    break;
+                }
+                strField[i++] = c;
+            } while (readChar(c));
+            strField[i] = '\0';
+            path.push_back(JsonPathNode(strField));
+        }
+        first = false;
+    }
+    // trailing '['
+    if (expectArrayIndex) {
+        throwInvalidPathError("Unexpected termination (unterminated array access)");
+    }
+    // if we're either empty or ended on a trailing '.', add an empty field name
+    if (expectField || first) {
+        path.push_back(JsonPathNode(""));
+    }
+    return path;
+}
+
+bool JsonPathParser::readChar(char& c) {
+    assert(m_head != NULL && m_tail != NULL);
+    if (m_head == m_tail) {
+        return false;
+    }
+    c = *m_head++;
+    m_pos++;
+    return true;
+}
+
+void JsonPathParser::throwInvalidPathError(const char* err) const {
+    char msg[1024];
+    snprintf(msg, sizeof(msg), "Invalid JSON path: %s [position %d]", err, m_pos);
+    throw SQLException(SQLException::
+                       data_exception_invalid_parameter,
+                       msg);
+}
+
+namespace {
+
+/** what the reader expects next in each open container */
+enum Container {
+    OBJECT_KEY,
+    OBJECT_VALUE,
+    ARRAY_ELEMENT
+};
+
+/**
+ * Receives the reader's events, following the open containers whose
+ * keys and indexes match the path so far.  When the last path node
+ * matches, the value is kept: strings, booleans and integers as the
+ * text FIELD returns, other numbers, objects and arrays as the span of
+ * the document that holds them.
+ *
+ * A later match at any level replaces what was found under an earlier
+ * one, just as jsoncpp keeps the last of duplicate keys, and as '[-1]'
+ * picks the last element of an array.
+ */
+class PathHandler {
+public:
+    typedef char Ch;
+
+    PathHandler(const std::vector<JsonPathNode>& path, const rapidjson::StringStream& stream,
+                std::vector<char>& containers, std::vector<int32_t>& indexes, std::string& text)
+        : m_path(path), m_stream(stream), m_containers(containers), m_indexes(indexes), m_text(text),
+          m_matched(0), m_keyMatched(false), m_targetDepth(0), m_targetStart(0),
+          m_found(false), m_isSpan(false), m_spanStart(0), m_spanEnd(0)
+    {
+        m_containers.clear();
+        m_indexes.clear();
+    }
+
+    void Null() { beginValue(); }
+    void Bool(bool b) {
+        if (beginValue() == TARGET) {
+            found(b ? "true" : "false");
+        }
+    }
+    void Int(int i) { Int64(i); }
+    void Uint(unsigned u) { Uint64(u); }
+    void Int64(int64_t i) {
+        if (beginValue() == TARGET) {
+            char digits[32];
+            snprintf(digits, sizeof(digits), "%" PRId64, i);
+            found(digits);
+        }
+    }
+    void Uint64(uint64_t u) {
+        if (beginValue() == TARGET) {
+            char digits[32];
+            snprintf(digits, sizeof(digits), "%" PRIu64, u);
+            found(digits);
+        }
+    }
+    void Double(double) {
+        if (beginValue() == TARGET) {
+            // the reader moves the stream past the number only after the
+            // event, and the number is all sign, digits, '.' and exponent
+            size_t start = m_stream.Tell();
+            size_t end = start + strspn(m_stream.head_ + start, "0123456789+-.eE");
+            foundSpan(start, end);
+        }
+    }
+    void String(const Ch* str, rapidjson::SizeType, bool) {
+        if ( ! m_containers.empty() && m_containers.back() == OBJECT_KEY) {
+            key(str);
+        } else if (beginValue() == TARGET) {
+            // like jsoncpp, strings end at an escaped nul
+            found(str);
+        }
+    }
+    void StartObject() { beginContainer(OBJECT_KEY); }
+    void EndObject(rapidjson::SizeType) { endContainer(); }
+    void StartArray() { beginContainer(ARRAY_ELEMENT); }
+    void EndArray(rapidjson::SizeType) { endContainer(); }
+
+    bool isFound() const { return m_found; }
+    bool isSpan() const { return m_isSpan; }
+    size_t spanStart() const { return m_spanStart; }
+    size_t spanEnd() const { return m_spanEnd; }
+
+private:
+    enum Match {
+        SKIP,
+        DESCEND,
+        TARGET
+    };
+
+    /** Account for a value in the innermost container and say whether it is on the path */
+    Match beginValue() {
+        if (m_containers.empty()) {
+            // the root
+            return SKIP;
+        }
+        bool candidate = false;
+        char& container = m_containers.back();
+        if (container == OBJECT_VALUE) {
+            container = OBJECT_KEY;
+            candidate = m_keyMatched;
+            m_keyMatched = false;
+        } else {
+            int32_t index = m_indexes.back()++;
+            if (m_targetDepth == 0 && m_containers.size() == m_matched + 1) {
+                int32_t wanted = m_path[m_matched].m_arrayIndex;
+                candidate = wanted == index || wanted == JsonPathParser::ARRAY_TAIL;
+            }
+        }
+        if ( ! candidate) {
+            return SKIP;
+        }
+        m_found = false;
+        return m_matched + 1 == m_path.size() ? TARGET : DESCEND;
+    }
+
+    void key(const Ch* str) {
+        m_containers.back() = OBJECT_VALUE;
+        if (m_targetDepth == 0 && m_containers.size() == m_matched + 1) {
+            const JsonPathNode& node = m_path[m_matched];
+            // compared as C strings, as jsoncpp keys are
+            m_keyMatched = node.m_arrayIndex == -1 && strcmp(str, node.m_field.c_str()) == 0;
+        }
+    }
+
+    void beginContainer(Container container) {
+        Match match = beginValue();
+        m_containers.push_back(static_cast<char>(container));
+        m_indexes.push_back(0);
+        if (match == TARGET) {
+            m_targetDepth = m_containers.size();
+            // the event comes after the opening brace or bracket
+            m_targetStart = m_stream.Tell() - 1;
+        } else if (match == DESCEND) {
+            ++m_matched;
+        }
+    }
+
+    void endContainer() {
+        size_t depth = m_containers.size();
+        if (depth == m_targetDepth) {
+            foundSpan(m_targetStart, m_stream.Tell());
+            m_targetDepth = 0;
+        } else if (m_targetDepth == 0 && depth > 1 && depth == m_matched + 1) {
+            --m_matched;
+        }
+        m_containers.pop_back();
+        m_indexes.pop_back();
+    }
+
+    void found(const char* text) {
+        m_text.assign(text);
+        m_found = true;
+        m_isSpan = false;
+    }
+
+    void foundSpan(size_t start, size_t end) {
+        m_spanStart = start;
+        m_spanEnd = end;
+        m_found = true;
+        m_isSpan = true;
+    }
+
+    const std::vector<JsonPathNode>& m_path;
+    const rapidjson::StringStream& m_stream;
+    std::vector<char>& m_containers;
+    std::vector<int32_t>& m_indexes;
+    std::string& m_text;
+
+    // path nodes matched by the open containers
+    size_t m_matched;
+    bool m_keyMatched;
+    // depth and offset of the object or array being found, if any
+    size_t m_targetDepth;
+    size_t m_targetStart;
+
+    bool m_found;
+    bool m_isSpan;
+    size_t m_spanStart;
+    size_t m_spanEnd;
+};
+
+}
+
+JsonPathEvaluator::JsonPathEvaluator()
+    : m_pathCount(0), m_nextPath(0), m_pathParseCount(0)
+{
+    m_elementPath.push_back(JsonPathNode(0));
+}
+
+const std::vector<JsonPathNode>* JsonPathEvaluator::path(const char* pathChars, int32_t lenPath, bool forSet) {
+    for (int i = 0; i < m_pathCount; ++i) {
+        const CachedPath& cached = m_paths[i];
+        if (cached.forSet == forSet &&
+            cached.text.size() == static_cast<size_t>(lenPath) &&
+            memcmp(cached.text.data(), pathChars, lenPath) == 0) {
+            return cached.valid ? &cached.nodes : NULL;
+        }
+    }
+
+    // replace the paths in turn once the cache is full
+    CachedPath& cached = m_paths[m_nextPath];
+    m_nextPath = (m_nextPath + 1) % PATH_CACHE_SIZE;
+    if (m_pathCount < PATH_CACHE_SIZE) {
+        ++m_pathCount;
+    }
+    cached.text.assign(pathChars, lenPath);
+    cached.forSet = forSet;
+    ++m_pathParseCount;
+    try {
+        cached.nodes = JsonPathParser::resolve(pathChars, lenPath, forSet);
+        cached.valid = true;
+    }
+    catch (const SQLException&) {
+        cached.nodes.clear();
+        cached.valid = false;
+    }
+    return cached.valid ? &cached.nodes : NULL;
+}
+
+JsonPathEvaluator::Outcome JsonPathEvaluator::find(const char* docChars, int32_t lenDoc,
+                                                   const std::vector<JsonPathNode>& path) {
+    // the reader stops at a nul, where jsoncpp would not
+    if (path.empty() || lenDoc <= 0 || memchr(docChars, '\0', lenDoc) != NULL) {
+        return NOT_READ;
+    }
+    m_buffer.assign(docChars, docChars + lenDoc);
+    m_buffer.push_back('\0');
+
+    rapidjson::StringStream stream(&m_buffer[0]);
+    PathHandler handler(path, stream, m_containers, m_indexes, m_result);
+    if ( ! m_eventReader.Parse<rapidjson::kParseDefaultFlags>(stream, handler)) {
+        return NOT_READ;
+    }
+    if ( ! handler.isFound()) {
+        return NOT_FOUND;
+    }
+    if ( ! handler.isSpan()) {
+        return FOUND;
+    }
+
+    // render the value as JsonDocument::get does
+    const char* span = &m_buffer[handler.spanStart()];
+    if ( ! m_reader.parse(span, &m_buffer[handler.spanEnd()], m_value) || m_value.isNull()) {
+        return NOT_READ;
+    }
+    if (m_value.isConvertibleTo(Json::stringValue)) {
+        m_result = m_value.asString();
+    } else {
+        m_result = m_writer.write(m_value);
+        // the writer always appends a trailing new line
+        m_result.resize(m_result.size() - 1);
+    }
+    return FOUND;
+}
+
+JsonPathEvaluator::Outcome JsonPathEvaluator::findArrayElement(const char* docChars, int32_t lenDoc,
+                                                               int32_t index) {
+    assert(index >= 0);
+    m_elementPath[0].m_arrayIndex = index;
+    return find(docChars, lenDoc, m_elementPath);
+}
+
+}
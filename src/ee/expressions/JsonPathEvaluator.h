@@ -0,0 +1,139 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONPATHEVALUATOR_H_
+#define JSONPATHEVALUATOR_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <jsoncpp/jsoncpp.h>
+#include <jsoncpp/jsoncpp-forwards.h>
+#include "rapidjson/reader.h"
+
+namespace voltdb {
+
+/** a path node is either a field name or an array index */
+struct JsonPathNode {
+    JsonPathNode(int32_t arrayIndex) : m_arrayIndex(arrayIndex) {}
+    JsonPathNode(const char* field) : m_arrayIndex(-1), m_field(field) {}
+
+    int32_t m_arrayIndex;
+    std::string m_field;
+};
+
+/** parser for our path syntax: fields separated by '.', array indexes in [] */
+class JsonPathParser {
+public:
+    /** the array index of '[-1]', the last element of an array */
+    static const int32_t ARRAY_TAIL = -10;
+
+    /** parse our path to its vector representation */
+    static std::vector<JsonPathNode> resolve(const char* pathChars, int32_t lenPath,
+                                             bool enforceArrayIndexLimitForSet = false);
+
+private:
+    JsonPathParser(const char* pathChars, int32_t lenPath)
+        : m_head(pathChars), m_tail(pathChars + lenPath), m_pos(-1) {}
+
+    std::vector<JsonPathNode> resolve(int32_t lenPath, bool enforceArrayIndexLimitForSet);
+    bool readChar(char& c);
+    void throwInvalidPathError(const char* err) const;
+
+    const char* m_head;
+    const char* m_tail;
+    int32_t m_pos;
+};
+
+/**
+ * Finds the value at a path in a JSON document with rapidjson's event
+ * reader, so that no DOM is built for the document; only the value
+ * found, when it is a fractional number, an object or an array, is
+ * read again with jsoncpp so that it is rendered exactly as FIELD
+ * always has.  Parsed paths are kept in a small cache keyed by the
+ * path text, since the path is almost always a constant or a
+ * parameter.  One evaluator is kept per site, in the ExecutorContext.
+ */
+class JsonPathEvaluator {
+public:
+    enum Outcome {
+        FOUND,
+        NOT_FOUND,
+        // the reader only takes well formed documents with an object or
+        // array at the root; anything else is left to JsonDocument, for
+        // the answer as well as for the error message
+        NOT_READ
+    };
+
+    static const int PATH_CACHE_SIZE = 8;
+
+    JsonPathEvaluator();
+
+    /**
+     * The parsed path, from the cache when it was seen recently.
+     * Returns NULL for an invalid path, so that the error is raised by
+     * JsonDocument in the order it always has been.
+     */
+    const std::vector<JsonPathNode>* path(const char* pathChars, int32_t lenPath, bool forSet);
+
+    /**
+     * Find the value at the path.  When FOUND, result() is the value
+     * as FIELD returns it: strings without their quotes, other values
+     * as JSON.  JSON nulls are NOT_FOUND.
+     */
+    Outcome find(const char* docChars, int32_t lenDoc, const std::vector<JsonPathNode>& path);
+
+    /** Find the element at a (non negative) index of a top level array */
+    Outcome findArrayElement(const char* docChars, int32_t lenDoc, int32_t index);
+
+    /** The value found by the last find, valid until the next one */
+    const std::string& result() const { return m_result; }
+
+    /** Number of paths parsed so far */
+    int64_t pathParseCount() const { return m_pathParseCount; }
+
+private:
+    struct CachedPath {
+        CachedPath() : forSet(false), valid(false) {}
+        std::string text;
+        bool forSet;
+        bool valid;
+        std::vector<JsonPathNode> nodes;
+    };
+
+    CachedPath m_paths[PATH_CACHE_SIZE];
+    int m_pathCount;
+    int m_nextPath;
+    int64_t m_pathParseCount;
+
+    std::vector<JsonPathNode> m_elementPath;
+    // the document, nul terminated for the reader
+    std::vector<char> m_buffer;
+    // the reader's stack of open containers, kept across documents
+    std::vector<char> m_containers;
+    std::vector<int32_t> m_indexes;
+    std::string m_result;
+    rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::CrtAllocator> m_eventReader;
+    Json::Value m_value;
+    Json::Reader m_reader;
+    Json::FastWriter m_writer;
+};
+
+}
+
+#endif /* JSONPATHEVALUATOR_H_ */
@@ -0,0 +1,103 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/RegexpPatternCache.h"
+
+#include <cstring>
+
+namespace voltdb {
+
+RegexpPatternCache::RegexpPatternCache()
+    : m_size(0), m_clock(0), m_lastHit(0), m_compileCount(0)
+{}
+
+RegexpPatternCache::~RegexpPatternCache() {
+    for (size_t i = 0; i < m_size; ++i) {
+        release(m_entries[i]);
+    }
+}
+
+void RegexpPatternCache::release(Entry &entry) {
+    pcre2_match_data_free(entry.matchData);
+    pcre2_code_free(entry.code);
+    entry.matchData = NULL;
+    entry.code = NULL;
+}
+
+pcre2_code *RegexpPatternCache::get(const char *pattern, size_t length, uint32_t options,
+                                    pcre2_match_data **matchData, int *errorCode) {
+    ++m_clock;
+    if (m_size > 0) {
+        Entry &last = m_entries[m_lastHit];
+        if (last.options == options && last.pattern.size() == length &&
+            ::memcmp(last.pattern.data(), pattern, length) == 0) {
+            last.lastUse = m_clock;
+            *matchData = last.matchData;
+            return last.code;
+        }
+    }
+
+    size_t victim = 0;
+    for (size_t i = 0; i < m_size; ++i) {
+        Entry &entry = m_entries[i];
+        if (entry.options == options && entry.pattern.size() == length &&
+            ::memcmp(entry.pattern.data(), pattern, length) == 0) {
+            entry.lastUse = m_clock;
+            m_lastHit = i;
+            *matchData = entry.matchData;
+            return entry.code;
+        }
+        if (entry.lastUse < m_entries[victim].lastUse) {
+            victim = i;
+        }
+    }
+
+    PCRE2_SIZE errorOffset = 0;
+    pcre2_code *code = pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern), length, options,
+                                     errorCode, &errorOffset, NULL);
+    if (code == NULL) {
+        return NULL;
+    }
+    // PCRE2 is built with JIT support.  If the JIT can not handle a
+    // pattern this fails and pcre2_match interprets it instead.
+    (void)pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+    pcre2_match_data *data = pcre2_match_data_create_from_pattern(code, NULL);
+    if (data == NULL) {
+        pcre2_code_free(code);
+        *errorCode = PCRE2_ERROR_NOMEMORY;
+        return NULL;
+    }
+    ++m_compileCount;
+
+    if (m_size < CAPACITY) {
+        victim = m_size++;
+    }
+    else {
+        release(m_entries[victim]);
+    }
+    Entry &entry = m_entries[victim];
+    entry.pattern.assign(pattern, length);
+    entry.options = options;
+    entry.code = code;
+    entry.matchData = data;
+    entry.lastUse = m_clock;
+    m_lastHit = victim;
+    *matchData = data;
+    return code;
+}
+
+}
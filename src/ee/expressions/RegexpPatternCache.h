@@ -0,0 +1,82 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGEXPPATTERNCACHE_H
+#define REGEXPPATTERNCACHE_H
+
+#ifndef PCRE2_CODE_UNIT_WIDTH
+#define PCRE2_CODE_UNIT_WIDTH 8
+#endif
+#include "pcre2.h"
+
+#include <stdint.h>
+#include <string>
+
+namespace voltdb {
+
+/**
+ * A small per-site cache of compiled regular expressions, keyed by
+ * the pattern bytes and the compile options, so that a function
+ * applied to many rows with the same pattern compiles it only once.
+ * Patterns are also JIT compiled, and each keeps match data for
+ * reuse.  The least recently used pattern is evicted when the cache
+ * is full.
+ */
+class RegexpPatternCache {
+public:
+    static const int CAPACITY = 16;
+
+    RegexpPatternCache();
+    ~RegexpPatternCache();
+
+    /**
+     * Return the compiled pattern and its match data, compiling it on a
+     * miss.  Both stay owned by the cache and are valid until the next
+     * call.  Returns NULL, with the PCRE2 error in errorCode, if the
+     * pattern does not compile.
+     */
+    pcre2_code *get(const char *pattern, size_t length, uint32_t options,
+                    pcre2_match_data **matchData, int *errorCode);
+
+    /** Number of patterns compiled so far */
+    int64_t compileCount() const { return m_compileCount; }
+
+    size_t size() const { return m_size; }
+
+private:
+    struct Entry {
+        Entry() : options(0), code(NULL), matchData(NULL), lastUse(0) {}
+        std::string pattern;
+        uint32_t options;
+        pcre2_code *code;
+        pcre2_match_data *matchData;
+        uint64_t lastUse;
+    };
+
+    static void release(Entry &entry);
+
+    Entry m_entries[CAPACITY];
+    size_t m_size;
+    uint64_t m_clock;
+    // the entry returned last, checked first
+    size_t m_lastHit;
+    int64_t m_compileCount;
+};
+
+}
+
+#endif /* REGEXPPATTERNCACHE_H */
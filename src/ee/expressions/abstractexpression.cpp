@@ -48,6 +48,7 @@
 #include "common/debuglog.h"
 #include "common/serializeio.h"
 #include "common/types.h"
+#include "expressions/expressionoptimizer.h"
 #include "expressions/expressionutil.h"
 
 #include <sstream>
@@ -145,6 +146,11 @@ AbstractExpression::buildExpressionTree(PlannerDomValue obj)
     AbstractExpression * exp =
       AbstractExpression::buildExpressionTree_recurse(obj);
 
+    ExpressionOptimizer* optimizer = ExpressionOptimizer::current();
+    if (optimizer) {
+        exp = optimizer->optimize(exp, obj, NULL);
+    }
+
     if (exp)
         exp->initParamShortCircuits();
     return exp;
@@ -187,15 +193,22 @@ AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj)
         valueSize = NValue::getTupleStorageSize(value_type);
     }
 
-    // recurse to children
+    // recurse to children, which the optimizer, if any, may replace
+    ExpressionOptimizer* optimizer = ExpressionOptimizer::current();
     try {
         if (obj.hasNonNullKey("LEFT")) {
             PlannerDomValue leftValue = obj.valueForKey("LEFT");
             left_child = AbstractExpression::buildExpressionTree_recurse(leftValue);
+            if (optimizer) {
+                left_child = optimizer->optimize(left_child, leftValue, &obj);
+            }
         }
         if (obj.hasNonNullKey("RIGHT")) {
             PlannerDomValue rightValue = obj.valueForKey("RIGHT");
             right_child = AbstractExpression::buildExpressionTree_recurse(rightValue);
+            if (optimizer) {
+                right_child = optimizer->optimize(right_child, rightValue, &obj);
+            }
         }
 
         // NULL argsVector corresponds to a missing ARGS value
@@ -207,6 +220,9 @@ AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj)
             for (int i = 0; i < argsArray.arrayLen(); i++) {
                 PlannerDomValue argValue = argsArray.valueAtIndex(i);
                 AbstractExpression* argExpr = AbstractExpression::buildExpressionTree_recurse(argValue);
+                if (optimizer) {
+                    argExpr = optimizer->optimize(argExpr, argValue, &obj);
+                }
                 argsVector->push_back(argExpr);
             }
         }
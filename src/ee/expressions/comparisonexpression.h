@@ -47,8 +47,10 @@
 #define HSTORECOMPARISONEXPRESSION_H
 
 #include "common/common.h"
+#include "common/LikeMatcher.h"
 #include "common/serializeio.h"
 #include "common/valuevector.h"
+#include "common/ValuePeeker.hpp"
 
 #include "expressions/abstractexpression.h"
 #include "expressions/parametervalueexpression.h"
@@ -286,5 +288,60 @@ public:
     {}
 };
 
+/**
+ * LIKE keeps its pattern analyzed between rows.  It is only used when the
+ * right side is a constant or a parameter, so the pattern is analyzed again
+ * only when its bytes change, at most once per execution.  Patterns the
+ * matcher does not handle go to CmpLike as before.
+ */
+class LikeExpression : public AbstractExpression {
+public:
+    LikeExpression(ExpressionType type, AbstractExpression *left, AbstractExpression *right)
+        : AbstractExpression(type, left, right)
+    {
+        m_left = left;
+        m_right = right;
+    }
+
+    inline NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        assert(m_left != NULL);
+        assert(m_right != NULL);
+
+        NValue lnv = m_left->eval(tuple1, tuple2);
+        if (lnv.isNull()) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+        NValue rnv = m_right->eval(tuple1, tuple2);
+        if (rnv.isNull()) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+        if (ValuePeeker::peekValueType(lnv) != VALUE_TYPE_VARCHAR ||
+            ValuePeeker::peekValueType(rnv) != VALUE_TYPE_VARCHAR) {
+            // let NValue::like report the type error
+            return CmpLike::compare(lnv, rnv);
+        }
+
+        int32_t patternLength;
+        const char *pattern = ValuePeeker::peekObject_withoutNull(rnv, &patternLength);
+        m_matcher.prepare(pattern, patternLength);
+        if (m_matcher.isGeneral()) {
+            return CmpLike::compare(lnv, rnv);
+        }
+        int32_t valueLength;
+        const char *value = ValuePeeker::peekObject_withoutNull(lnv, &valueLength);
+        return m_matcher.matches(value, valueLength) ? NValue::getTrue() : NValue::getFalse();
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        return (spacer + "LikeExpression\n");
+    }
+
+private:
+    AbstractExpression *m_left;
+    AbstractExpression *m_right;
+    mutable LikeMatcher m_matcher;
+};
+
 }
 #endif
@@ -62,33 +62,126 @@ static inline void checkRangeOfEpochMicros(int64_t epochMicros) {
     }
 }
 
-/** Convert from epoch_micros to date **/
-static inline void micros_to_date(int64_t epoch_micros_in, boost::gregorian::date& date_out) {
-    checkRangeOfEpochMicros(epoch_micros_in);
-    boost::posix_time::ptime input_ptime = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
-    date_out = input_ptime.date();
+static const int64_t MICROS_PER_SECOND = 1000000;
+static const int64_t MICROS_PER_MINUTE = MICROS_PER_SECOND * 60;
+static const int64_t MICROS_PER_HOUR = MICROS_PER_MINUTE * 60;
+static const int64_t MICROS_PER_DAY = MICROS_PER_HOUR * 24;
+
+/** Divide, rounding down also for negative values **/
+static inline int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    if (value % divisor < 0) {
+        --quotient;
+    }
+    return quotient;
 }
 
-/** Convert from epoch_micros to time **/
-static inline void micros_to_time(int64_t epoch_micros_in, boost::posix_time::time_duration& time_out) {
+/**
+ * Days since 1970-01-01 of a date of the proleptic Gregorian calendar.
+ * This and civil_from_days follow Howard Hinnant's table-free
+ * algorithms, which count in 400-year eras of 146097 days from
+ * 0000-03-01, so that February ends each year of an era.
+ */
+static inline int64_t days_from_civil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = floor_div(year, 400);
+    const int64_t year_of_era = year - era * 400;
+    const int64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+/** Convert from days since 1970-01-01 to year, month and day **/
+static inline void civil_from_days(int64_t days, int& year_out, int& month_out, int& day_out) {
+    days += 719468;
+    const int64_t era = floor_div(days, 146097);
+    const int64_t day_of_era = days - era * 146097;
+    const int64_t year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int64_t month_of_era = (5 * day_of_year + 2) / 153;
+    day_out = static_cast<int>(day_of_year - (153 * month_of_era + 2) / 5 + 1);
+    month_out = static_cast<int>(month_of_era < 10 ? month_of_era + 3 : month_of_era - 9);
+    year_out = static_cast<int>(year_of_era + era * 400 + (month_out <= 2));
+}
+
+static inline int last_day_of_month(int year, int month) {
+    static const int8_t DAYS_IN_MONTH[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+        return 29;
+    }
+    return DAYS_IN_MONTH[month - 1];
+}
+
+/** Convert from epoch_micros to year, month and day, without boost **/
+static inline void micros_to_civil(int64_t epoch_micros_in, int& year_out, int& month_out, int& day_out) {
     checkRangeOfEpochMicros(epoch_micros_in);
-    boost::posix_time::ptime input_ptime = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
-    time_out = input_ptime.time_of_day();
+    civil_from_days(floor_div(epoch_micros_in, MICROS_PER_DAY), year_out, month_out, day_out);
 }
 
-/** Convert from epoch_micros to ptime **/
-static inline void micros_to_ptime(int64_t epoch_micros_in, boost::posix_time::ptime& ptime_out) {
+/** Convert from epoch_micros to the microseconds since midnight **/
+static inline int64_t micros_of_day(int64_t epoch_micros_in) {
     checkRangeOfEpochMicros(epoch_micros_in);
-    ptime_out = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
+    return epoch_micros_in - floor_div(epoch_micros_in, MICROS_PER_DAY) * MICROS_PER_DAY;
 }
 
-/** Convert from epoch_micros to date and time **/
-static inline void micros_to_date_and_time(int64_t epoch_micros_in, boost::gregorian::date& date_out,
-                                           boost::posix_time::time_duration& time_out) {
-    checkRangeOfEpochMicros(epoch_micros_in);
-    boost::posix_time::ptime input_ptime = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
-    date_out = input_ptime.date();
-    time_out = input_ptime.time_of_day();
+/** Truncate epoch_micros to a whole number of units of a day or less **/
+static inline int64_t truncate_micros(int64_t epoch_micros, int64_t unit) {
+    checkRangeOfEpochMicros(epoch_micros);
+    return floor_div(epoch_micros, unit) * unit;
+}
+
+static inline int64_t truncate_micros_to_minute(int64_t epoch_micros) {
+    return truncate_micros(epoch_micros, MICROS_PER_MINUTE);
+}
+
+static inline int64_t truncate_micros_to_hour(int64_t epoch_micros) {
+    return truncate_micros(epoch_micros, MICROS_PER_HOUR);
+}
+
+static inline int64_t truncate_micros_to_day(int64_t epoch_micros) {
+    return truncate_micros(epoch_micros, MICROS_PER_DAY);
+}
+
+/** Truncate to the Monday starting the (ISO 8601) week **/
+static inline int64_t truncate_micros_to_week(int64_t epoch_micros) {
+    checkRangeOfEpochMicros(epoch_micros);
+    const int64_t days = floor_div(epoch_micros, MICROS_PER_DAY);
+    // 1970-01-01 was a Thursday, 3 days into its week.
+    const int64_t days_into_week = days + 3 - floor_div(days + 3, 7) * 7;
+    return (days - days_into_week) * MICROS_PER_DAY;
+}
+
+static inline int64_t truncate_micros_to_month(int64_t epoch_micros) {
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return days_from_civil(year, month, 1) * MICROS_PER_DAY;
+}
+
+static inline int64_t truncate_micros_to_quarter(int64_t epoch_micros) {
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return days_from_civil(year, QUARTER_START_MONTH_BY_MONTH[month], 1) * MICROS_PER_DAY;
+}
+
+static inline int64_t truncate_micros_to_year(int64_t epoch_micros) {
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return days_from_civil(year, 1, 1) * MICROS_PER_DAY;
+}
+
+typedef int64_t (*MicrosTruncation)(int64_t epoch_micros);
+
+/**
+ * Truncate count timestamps at once with one of the above, for
+ * evaluation over a column of values.  Nulls stay null.  in and out
+ * may be the same array.
+ */
+static inline void truncate_micros_batch(MicrosTruncation truncation,
+                                         const int64_t* in, int64_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = in[i] == INT64_NULL ? INT64_NULL : truncation(in[i]);
+    }
 }
 
 /** Convert from timestamp to micros since epoch **/
@@ -103,17 +196,29 @@ static inline int64_t epoch_microseconds_from_components(unsigned short int year
     return epoch_seconds * 1000000;
 }
 
+/**
+ * Add months to epoch_micros as boost::gregorian::months does: the last
+ * day of a month moves to the last day of the resulting month, other
+ * days are cut back to it if past it.
+ */
 static inline int64_t addMonths(int64_t epoch_micros, int64_t months) {
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epoch_micros, ts);
-
-    try {
-        ts += boost::gregorian::months(static_cast<int>(months));
-    } catch (std::out_of_range &e) {
+    checkRangeOfEpochMicros(epoch_micros);
+    const int64_t days = floor_div(epoch_micros, MICROS_PER_DAY);
+    const int64_t time_of_day = epoch_micros - days * MICROS_PER_DAY;
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+
+    const int64_t month_index = year * 12 + (month - 1) + months;
+    const int64_t new_year = floor_div(month_index, 12);
+    if (new_year < PTIME_MIN_YEARS || new_year > PTIME_MAX_YEARS) {
         throw voltdb::SQLException(voltdb::SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
     }
-    boost::posix_time::time_duration td = ts - EPOCH;
-    return td.total_microseconds();
+    const int new_month = static_cast<int>(month_index - new_year * 12) + 1;
+    const int new_last_day = last_day_of_month(static_cast<int>(new_year), new_month);
+    if (day == last_day_of_month(year, month) || day > new_last_day) {
+        day = new_last_day;
+    }
+    return days_from_civil(new_year, new_month, day) * MICROS_PER_DAY + time_of_day;
 }
 
 namespace voltdb {
@@ -136,9 +241,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_YEAR>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getIntegerValue(as_date.year());
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return getIntegerValue(year);
 }
 
 /** implement the timestamp MONTH extract function **/
@@ -152,9 +257,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_MONTH>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)as_date.month());
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return getTinyIntValue((int8_t)month);
 }
 
 /** implement the timestamp DAY extract function **/
@@ -168,9 +273,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_DAY>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)as_date.day());
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return getTinyIntValue((int8_t)day);
 }
 
 /** implement the timestamp DAY OF WEEK extract function **/
@@ -184,9 +289,10 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_DAY_OF_WEEK>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)(as_date.day_of_week() + 1)); // Have 0-based, want 1-based.
+    checkRangeOfEpochMicros(epoch_micros);
+    int64_t days = floor_div(epoch_micros, MICROS_PER_DAY);
+    // 1970-01-01 was a Thursday, the 5th day of a week starting on Sunday.
+    return getTinyIntValue((int8_t)(days + 4 - floor_div(days + 4, 7) * 7 + 1));
 }
 
 /** implement the timestamp WEEKDAY extract function **/
@@ -202,9 +308,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_WEEKDAY>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)((as_date.day_of_week() + 6) % 7));
+    checkRangeOfEpochMicros(epoch_micros);
+    int64_t days = floor_div(epoch_micros, MICROS_PER_DAY);
+    return getTinyIntValue((int8_t)(days + 3 - floor_div(days + 3, 7) * 7));
 }
 
 /** implement the timestamp WEEK OF YEAR extract function **/
@@ -218,9 +324,11 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_WEEK_OF_YEAR>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)as_date.week_number());
+    // The ISO 8601 week, numbered within the year of its Thursday.
+    int64_t thursday = truncate_micros_to_week(epoch_micros) / MICROS_PER_DAY + 3;
+    int year, month, day;
+    civil_from_days(thursday, year, month, day);
+    return getTinyIntValue((int8_t)((thursday - days_from_civil(year, 1, 1)) / 7 + 1));
 }
 
 /** implement the timestamp DAY OF YEAR extract function **/
@@ -234,9 +342,10 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_DAY_OF_YEAR>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getSmallIntValue((int16_t)as_date.day_of_year());
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    int64_t days = floor_div(epoch_micros, MICROS_PER_DAY);
+    return getSmallIntValue((int16_t)(days - days_from_civil(year, 1, 1) + 1));
 }
 
 /** implement the timestamp QUARTER extract function **/
@@ -250,9 +359,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_QUARTER>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)((as_date.month() + 2) / 3));
+    int year, month, day;
+    micros_to_civil(epoch_micros, year, month, day);
+    return getTinyIntValue((int8_t)((month + 2) / 3));
 }
 
 /** implement the timestamp HOUR extract function **/
@@ -266,9 +375,7 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_HOUR>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::posix_time::time_duration as_time;
-    micros_to_time(epoch_micros, as_time);
-    return getTinyIntValue((int8_t)as_time.hours());
+    return getTinyIntValue((int8_t)(micros_of_day(epoch_micros) / MICROS_PER_HOUR));
 }
 
 /** implement the timestamp MINUTE extract function **/
@@ -282,9 +389,7 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_MINUTE>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::posix_time::time_duration as_time;
-    micros_to_time(epoch_micros, as_time);
-    return getTinyIntValue((int8_t)as_time.minutes());
+    return getTinyIntValue((int8_t)(micros_of_day(epoch_micros) % MICROS_PER_HOUR / MICROS_PER_MINUTE));
 }
 
 /** implement the timestamp SECOND extract function **/
@@ -298,13 +403,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_SECOND>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::posix_time::time_duration as_time;
-    micros_to_time(epoch_micros, as_time);
-    int second = as_time.seconds();
-    int fraction = static_cast<int>(epoch_micros % 1000000);
-    if (epoch_micros < 0 && fraction != 0) {
-        fraction = 1000000 + fraction;
-    }
+    int64_t micros_of_minute = micros_of_day(epoch_micros) % MICROS_PER_MINUTE;
+    int second = static_cast<int>(micros_of_minute / MICROS_PER_SECOND);
+    int fraction = static_cast<int>(micros_of_minute % MICROS_PER_SECOND);
     TTInt ttSecond(second);
     ttSecond *= NValue::kMaxScaleFactor;
     TTInt ttMicro(fraction);
@@ -417,10 +518,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_YEAR>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros_to_year(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to QUARTER function **/
@@ -434,11 +532,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_QUARTER>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int8_t quarter_start_month = QUARTER_START_MONTH_BY_MONTH[as_date.month()];
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(), quarter_start_month);
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros_to_quarter(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to MONTH function **/
@@ -452,10 +546,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_MONTH>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros_to_month(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to DAY function **/
@@ -469,11 +560,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_DAY>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int64_t truncate_epoch_micros =
-            epoch_microseconds_from_components(as_date.year(),as_date.month(), as_date.day());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros_to_day(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to HOUR function **/
@@ -487,12 +574,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_HOUR>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month(),
-            as_date.day(), as_time.hours());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros_to_hour(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to MINUTE function **/
@@ -506,12 +588,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_MINUTE>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month(),
-            as_date.day(), as_time.hours(), as_time.minutes());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros_to_minute(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to SECOND function **/
@@ -525,12 +602,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_SECOND>() const {
     }
 
     int64_t epoch_micros = getTimestamp();
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month(),
-            as_date.day(), as_time.hours(), as_time.minutes(),as_time.seconds());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_micros(epoch_micros, MICROS_PER_SECOND));
 }
 
 /** implement the timestamp TRUNCATE to MILLIS function **/
@@ -597,16 +669,7 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_YEAR>(const std::vector<
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::gregorian::years(static_cast<int>(interval));
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
-    }
+    return getTimestampValue(addMonths(date.getTimestamp(), 12 * interval));
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_QUARTER>(const std::vector<NValue>& arguments) {
@@ -681,16 +744,9 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_DAY>(const std::vector<N
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::gregorian::days(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
-    }
+    int64_t epoch_micros = date.getTimestamp();
+    checkRangeOfEpochMicros(epoch_micros);
+    return getTimestampValue(epoch_micros + interval * MICROS_PER_DAY);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_HOUR>(const std::vector<NValue>& arguments) {
@@ -715,16 +771,9 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_HOUR>(const std::vector<
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::posix_time::hours(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
-    }
+    int64_t epoch_micros = date.getTimestamp();
+    checkRangeOfEpochMicros(epoch_micros);
+    return getTimestampValue(epoch_micros + interval * MICROS_PER_HOUR);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MINUTE>(const std::vector<NValue>& arguments) {
@@ -749,16 +798,9 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MINUTE>(const std::vecto
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::posix_time::minutes(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
-    }
+    int64_t epoch_micros = date.getTimestamp();
+    checkRangeOfEpochMicros(epoch_micros);
+    return getTimestampValue(epoch_micros + interval * MICROS_PER_MINUTE);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_SECOND>(const std::vector<NValue>& arguments) {
@@ -783,16 +825,9 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_SECOND>(const std::vecto
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::posix_time::seconds(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large in DATEADD function");
-    }
+    int64_t epoch_micros = date.getTimestamp();
+    checkRangeOfEpochMicros(epoch_micros);
+    return getTimestampValue(epoch_micros + interval * MICROS_PER_SECOND);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MILLISECOND>(const std::vector<NValue>& arguments) {
@@ -817,16 +852,9 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MILLISECOND>(const std::
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::posix_time::milliseconds(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large in DATEADD function");
-    }
+    int64_t epoch_micros = date.getTimestamp();
+    checkRangeOfEpochMicros(epoch_micros);
+    return getTimestampValue(epoch_micros + interval * 1000);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MICROSECOND>(const std::vector<NValue>& arguments) {
@@ -851,16 +879,9 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MICROSECOND>(const std::
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::posix_time::microseconds(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        return getTimestampValue(td.total_microseconds());
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large in DATEADD function");
-    }
+    int64_t epoch_micros = date.getTimestamp();
+    checkRangeOfEpochMicros(epoch_micros);
+    return getTimestampValue(epoch_micros + interval);
 }
 
 const int64_t MIN_VALID_TIMESTAMP_VALUE = GREGORIAN_EPOCH;
@@ -0,0 +1,513 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/expressionoptimizer.h"
+
+#include "common/executorcontext.hpp"
+#include "common/SerializableEEException.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "expressions/abstractexpression.h"
+#include "expressions/constantvalueexpression.h"
+#include "expressions/functionexpression.h"
+#include "expressions/memoizedexpression.h"
+#include "expressions/tuplevalueexpression.h"
+
+#include "boost/functional/hash.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <pthread.h>
+#include <vector>
+
+static pthread_key_t static_key;
+static pthread_once_t static_keyOnce = PTHREAD_ONCE_INIT;
+
+namespace voltdb {
+
+static void createThreadLocalKey() {
+    (void)pthread_key_create(&static_key, NULL);
+}
+
+namespace {
+
+bool hasChild(rapidjson::Value& obj, const char* key) {
+    return obj.HasMember(key) && ! obj[key].IsNull();
+}
+
+/** Whether a member of an expression holds its child expressions */
+bool isChildMember(const rapidjson::Value::Member& member) {
+    const char* name = member.name.GetString();
+    return ! member.value.IsNull() &&
+        (::strcmp(name, "LEFT") == 0 || ::strcmp(name, "RIGHT") == 0 || ::strcmp(name, "ARGS") == 0);
+}
+
+size_t hashString(const rapidjson::Value& value) {
+    const char* chars = value.GetString();
+    return boost::hash_range(chars, chars + value.GetStringLength());
+}
+
+/** Hash a JSON value that is not an expression, like a constant's VALUE */
+size_t hashJson(const rapidjson::Value& value) {
+    size_t hash = static_cast<size_t>(value.GetType());
+    if (value.IsString()) {
+        boost::hash_combine(hash, hashString(value));
+    }
+    else if (value.IsDouble()) {
+        const double number = value.GetDouble();
+        uint64_t bits;
+        ::memcpy(&bits, &number, sizeof(bits));
+        boost::hash_combine(hash, bits);
+    }
+    else if (value.IsInt64()) {
+        boost::hash_combine(hash, value.GetInt64());
+    }
+    else if (value.IsUint64()) {
+        boost::hash_combine(hash, value.GetUint64());
+    }
+    else if (value.IsArray()) {
+        for (rapidjson::SizeType ii = 0; ii < value.Size(); ++ii) {
+            boost::hash_combine(hash, hashJson(value[ii]));
+        }
+    }
+    else if (value.IsObject()) {
+        for (rapidjson::Value::ConstMemberIterator it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+            boost::hash_combine(hash, hashString(it->name));
+            boost::hash_combine(hash, hashJson(it->value));
+        }
+    }
+    return hash;
+}
+
+bool isSameString(const rapidjson::Value& lhs, const rapidjson::Value& rhs) {
+    return lhs.GetStringLength() == rhs.GetStringLength() &&
+        ::memcmp(lhs.GetString(), rhs.GetString(), lhs.GetStringLength()) == 0;
+}
+
+/** Compare JSON values that are not expressions, as their JSON text would */
+bool isSameJson(const rapidjson::Value& lhs, const rapidjson::Value& rhs) {
+    if (lhs.GetType() != rhs.GetType()) {
+        return false;
+    }
+    if (lhs.IsString()) {
+        return isSameString(lhs, rhs);
+    }
+    if (lhs.IsNumber()) {
+        if (lhs.IsDouble() || rhs.IsDouble()) {
+            if ( ! lhs.IsDouble() || ! rhs.IsDouble()) {
+                return false;
+            }
+            const double left = lhs.GetDouble();
+            const double right = rhs.GetDouble();
+            return ::memcmp(&left, &right, sizeof(left)) == 0;
+        }
+        if (lhs.IsInt64() && rhs.IsInt64()) {
+            return lhs.GetInt64() == rhs.GetInt64();
+        }
+        return lhs.IsUint64() && rhs.IsUint64() && lhs.GetUint64() == rhs.GetUint64();
+    }
+    if (lhs.IsArray()) {
+        if (lhs.Size() != rhs.Size()) {
+            return false;
+        }
+        for (rapidjson::SizeType ii = 0; ii < lhs.Size(); ++ii) {
+            if ( ! isSameJson(lhs[ii], rhs[ii])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (lhs.IsObject()) {
+        rapidjson::Value::ConstMemberIterator left = lhs.MemberBegin();
+        rapidjson::Value::ConstMemberIterator right = rhs.MemberBegin();
+        for (; left != lhs.MemberEnd() && right != rhs.MemberEnd(); ++left, ++right) {
+            if ( ! isSameString(left->name, right->name) || ! isSameJson(left->value, right->value)) {
+                return false;
+            }
+        }
+        return left == lhs.MemberEnd() && right == rhs.MemberEnd();
+    }
+    // null, true and false
+    return true;
+}
+
+/** Build the columns the subtree reads */
+void collectColumns(PlannerDomValue obj, std::vector<TupleValueExpression*>& columns) {
+    ExpressionType type = static_cast<ExpressionType>(obj.valueForKey("TYPE").asInt());
+    if (type == EXPRESSION_TYPE_VALUE_TUPLE) {
+        columns.push_back(static_cast<TupleValueExpression*>(AbstractExpression::buildExpressionTree(obj)));
+        return;
+    }
+    if (obj.hasNonNullKey("LEFT")) {
+        collectColumns(obj.valueForKey("LEFT"), columns);
+    }
+    if (obj.hasNonNullKey("RIGHT")) {
+        collectColumns(obj.valueForKey("RIGHT"), columns);
+    }
+    if (obj.hasNonNullKey("ARGS")) {
+        PlannerDomValue args = obj.valueForKey("ARGS");
+        for (int ii = 0; ii < args.arrayLen(); ++ii) {
+            collectColumns(args.valueAtIndex(ii), columns);
+        }
+    }
+}
+
+/**
+ * Functions which cost far more than keying a row's inputs does, so
+ * that sharing one result between uses within a row pays off.
+ */
+bool isExpensiveFunction(int functionId) {
+    switch (functionId) {
+    case FUNC_VOLT_FIELD:
+    case FUNC_VOLT_ARRAY_ELEMENT:
+    case FUNC_VOLT_ARRAY_LENGTH:
+    case FUNC_VOLT_SET_FIELD:
+    case FUNC_VOLT_REGEXP_POSITION:
+        return true;
+    default:
+        return false;
+    }
+}
+
+}
+
+ExpressionOptimizer::ExpressionOptimizer(PlannerDomValue fragment)
+    : m_foldedCount(0)
+    , m_memoizedCount(0)
+    , m_sharedCount(0)
+{
+    countSubtrees(fragment.getRawValue());
+    (void)pthread_once(&static_keyOnce, createThreadLocalKey);
+    m_previous = current();
+    pthread_setspecific(static_key, this);
+}
+
+ExpressionOptimizer::~ExpressionOptimizer()
+{
+    pthread_setspecific(static_key, m_previous);
+}
+
+ExpressionOptimizer* ExpressionOptimizer::current()
+{
+    (void)pthread_once(&static_keyOnce, createThreadLocalKey);
+    return static_cast<ExpressionOptimizer*>(pthread_getspecific(static_key));
+}
+
+void ExpressionOptimizer::countSubtrees(rapidjson::Value& value)
+{
+    if (value.IsArray()) {
+        for (rapidjson::SizeType ii = 0; ii < value.Size(); ++ii) {
+            countSubtrees(value[ii]);
+        }
+        return;
+    }
+    if ( ! value.IsObject()) {
+        return;
+    }
+    if (value.HasMember("TYPE") && value["TYPE"].IsInt()) {
+        const Summary& summary = summarize(value);
+        if (summary.inputs == INPUTS_COLUMNS && summary.callsExpensiveFunction) {
+            ++m_counts[summary.canonical];
+        }
+    }
+    for (rapidjson::Value::MemberIterator it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+        countSubtrees(it->value);
+    }
+}
+
+int ExpressionOptimizer::countOf(const Summary& summary) const
+{
+    std::map<const rapidjson::Value*, int>::const_iterator it = m_counts.find(summary.canonical);
+    return it == m_counts.end() ? 0 : it->second;
+}
+
+const ExpressionOptimizer::Summary& ExpressionOptimizer::summarize(rapidjson::Value& obj)
+{
+    std::map<const rapidjson::Value*, Summary>::iterator it = m_summaries.find(&obj);
+    if (it != m_summaries.end()) {
+        return it->second;
+    }
+
+    Summary summary;
+    if ( ! obj.IsObject() || ! obj.HasMember("TYPE") || ! obj["TYPE"].IsInt()) {
+        return m_summaries[&obj] = summary;
+    }
+    ExpressionType type = static_cast<ExpressionType>(obj["TYPE"].GetInt());
+    summary.inputs = INPUTS_CONSTANTS;
+    summary.isReplaceable = true;
+    switch (type) {
+    case EXPRESSION_TYPE_VALUE_CONSTANT:
+        summary.isLeaf = true;
+        break;
+    case EXPRESSION_TYPE_VALUE_PARAMETER:
+        summary.inputs = INPUTS_PARAMETERS;
+        summary.isLeaf = true;
+        break;
+    case EXPRESSION_TYPE_VALUE_TUPLE:
+        summary.inputs = INPUTS_COLUMNS;
+        summary.isLeaf = true;
+        break;
+    case EXPRESSION_TYPE_FUNCTION:
+        if (hasChild(obj, "FUNCTION_ID") && obj["FUNCTION_ID"].IsInt()) {
+            const int functionId = obj["FUNCTION_ID"].GetInt();
+            summary.callsExpensiveFunction = isExpensiveFunction(functionId);
+            if (functionId == FUNC_CURRENT_TIMESTAMP) {
+                // the same throughout a transaction
+                summary.inputs = INPUTS_PARAMETERS;
+            }
+        }
+        break;
+    case EXPRESSION_TYPE_COMPARE_LIKE:
+    case EXPRESSION_TYPE_OPERATOR_ALTERNATIVE:
+        summary.isReplaceable = false;
+        break;
+    case EXPRESSION_TYPE_OPERATOR_PLUS:
+    case EXPRESSION_TYPE_OPERATOR_MINUS:
+    case EXPRESSION_TYPE_OPERATOR_MULTIPLY:
+    case EXPRESSION_TYPE_OPERATOR_DIVIDE:
+    case EXPRESSION_TYPE_OPERATOR_CAST:
+    case EXPRESSION_TYPE_OPERATOR_NOT:
+    case EXPRESSION_TYPE_OPERATOR_IS_NULL:
+    case EXPRESSION_TYPE_OPERATOR_CASE_WHEN:
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_NOTDISTINCT:
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+        break;
+    default:
+        // IN lists, subqueries, aggregates, ...
+        summary.inputs = INPUTS_OTHER;
+        summary.isReplaceable = false;
+        break;
+    }
+
+    if (summary.inputs != INPUTS_OTHER) {
+        std::vector<rapidjson::Value*> children;
+        if (hasChild(obj, "LEFT")) {
+            children.push_back(&obj["LEFT"]);
+        }
+        if (hasChild(obj, "RIGHT")) {
+            children.push_back(&obj["RIGHT"]);
+        }
+        if (hasChild(obj, "ARGS")) {
+            rapidjson::Value& args = obj["ARGS"];
+            for (rapidjson::SizeType ii = 0; ii < args.Size(); ++ii) {
+                children.push_back(&args[ii]);
+            }
+        }
+        for (size_t ii = 0; ii < children.size(); ++ii) {
+            const Summary& child = summarize(*children[ii]);
+            summary.inputs = std::max(summary.inputs, child.inputs);
+            summary.callsExpensiveFunction |= child.callsExpensiveFunction;
+        }
+
+        if (summary.inputs != INPUTS_OTHER) {
+            summary.canonical = canonicalSubtree(obj, hashNode(obj));
+        }
+    }
+
+    return m_summaries[&obj] = summary;
+}
+
+/**
+ * Hash an expression whose children are summarized already: its own
+ * members, and for each child, the child's canonical subtree.
+ */
+size_t ExpressionOptimizer::hashNode(rapidjson::Value& obj)
+{
+    size_t hash = 0;
+    for (rapidjson::Value::MemberIterator it = obj.MemberBegin(); it != obj.MemberEnd(); ++it) {
+        boost::hash_combine(hash, hashString(it->name));
+        if ( ! isChildMember(*it)) {
+            boost::hash_combine(hash, hashJson(it->value));
+        }
+        else if (it->value.IsArray()) {
+            boost::hash_combine(hash, it->value.Size());
+            for (rapidjson::SizeType ii = 0; ii < it->value.Size(); ++ii) {
+                boost::hash_combine(hash, canonicalOf(it->value[ii]));
+            }
+        }
+        else {
+            boost::hash_combine(hash, canonicalOf(it->value));
+        }
+    }
+    return hash;
+}
+
+/** Compare two expressions whose children are summarized already, as hashNode hashes them */
+bool ExpressionOptimizer::isSameNode(rapidjson::Value& lhs, rapidjson::Value& rhs)
+{
+    rapidjson::Value::MemberIterator left = lhs.MemberBegin();
+    rapidjson::Value::MemberIterator right = rhs.MemberBegin();
+    for (; left != lhs.MemberEnd() && right != rhs.MemberEnd(); ++left, ++right) {
+        if ( ! isSameString(left->name, right->name) || isChildMember(*left) != isChildMember(*right)) {
+            return false;
+        }
+        if ( ! isChildMember(*left)) {
+            if ( ! isSameJson(left->value, right->value)) {
+                return false;
+            }
+        }
+        else if (left->value.IsArray() || right->value.IsArray()) {
+            if ( ! left->value.IsArray() || ! right->value.IsArray() ||
+                left->value.Size() != right->value.Size()) {
+                return false;
+            }
+            for (rapidjson::SizeType ii = 0; ii < left->value.Size(); ++ii) {
+                if (canonicalOf(left->value[ii]) != canonicalOf(right->value[ii])) {
+                    return false;
+                }
+            }
+        }
+        else if (canonicalOf(left->value) != canonicalOf(right->value)) {
+            return false;
+        }
+    }
+    return left == lhs.MemberEnd() && right == rhs.MemberEnd();
+}
+
+/** The first subtree seen that is equal to obj, which may be obj itself */
+const rapidjson::Value* ExpressionOptimizer::canonicalSubtree(rapidjson::Value& obj, size_t hash)
+{
+    typedef std::multimap<size_t, const rapidjson::Value*>::iterator Iterator;
+    std::pair<Iterator, Iterator> candidates = m_subtrees.equal_range(hash);
+    for (Iterator it = candidates.first; it != candidates.second; ++it) {
+        if (isSameNode(obj, const_cast<rapidjson::Value&>(*it->second))) {
+            return it->second;
+        }
+    }
+    m_subtrees.insert(std::make_pair(hash, &obj));
+    return &obj;
+}
+
+const rapidjson::Value* ExpressionOptimizer::canonicalOf(rapidjson::Value& child) const
+{
+    std::map<const rapidjson::Value*, Summary>::const_iterator it = m_summaries.find(&child);
+    assert(it != m_summaries.end());
+    return it->second.canonical;
+}
+
+AbstractExpression* ExpressionOptimizer::optimize(AbstractExpression* expression, PlannerDomValue obj,
+                                                  const PlannerDomValue* parent)
+{
+    // Without a context, nothing can be evaluated ahead of time or kept.
+    if (expression == NULL || ExecutorContext::getExecutorContext() == NULL) {
+        return expression;
+    }
+    const Summary& summary = summarize(obj.getRawValue());
+    if (summary.isLeaf || ! summary.isReplaceable || summary.inputs == INPUTS_OTHER) {
+        return expression;
+    }
+    const Summary* parentSummary = parent ? &summarize(parent->getRawValue()) : NULL;
+    bool parentTakesAlong = parentSummary && parentSummary->isReplaceable;
+
+    if (summary.inputs != INPUTS_COLUMNS) {
+        if (parentTakesAlong && parentSummary->inputs != INPUTS_COLUMNS) {
+            // folded or memoized with its parent
+            return expression;
+        }
+        if (summary.inputs == INPUTS_CONSTANTS) {
+            return fold(expression);
+        }
+        return memoize(expression, obj, summary);
+    }
+
+    int count = countOf(summary);
+    if ( ! summary.callsExpensiveFunction || count < 2) {
+        return expression;
+    }
+    if (parentTakesAlong && parentSummary->inputs == INPUTS_COLUMNS &&
+        parentSummary->callsExpensiveFunction && countOf(*parentSummary) == count) {
+        // every use is within a use of the parent, which is shared instead
+        return expression;
+    }
+    return memoize(expression, obj, summary);
+}
+
+AbstractExpression* ExpressionOptimizer::fold(AbstractExpression* expression)
+{
+    NValue value;
+    try {
+        value = expression->eval(NULL, NULL);
+    }
+    catch (const SerializableEEException&) {
+        // Leave the error to execution, if the expression is evaluated at all.
+        return expression;
+    }
+
+    // The constant outlives the temp string pool.
+    const ValueType type = ValuePeeker::peekValueType(value);
+    switch (type) {
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+        if (value.isNull()) {
+            value = NValue::getNullValue(type);
+        }
+        else {
+            int32_t length;
+            const char* data = ValuePeeker::peekObject_withoutNull(value, &length);
+            if (type == VALUE_TYPE_VARCHAR) {
+                value = ValueFactory::getStringValue(std::string(data, length));
+            }
+            else {
+                value = ValueFactory::getBinaryValue(reinterpret_cast<const unsigned char*>(data), length);
+            }
+        }
+        break;
+    case VALUE_TYPE_GEOGRAPHY:
+    case VALUE_TYPE_ARRAY:
+        return expression;
+    default:
+        break;
+    }
+
+    AbstractExpression* constant = new ConstantValueExpression(value);
+    constant->setValueType(expression->getValueType());
+    constant->setValueSize(expression->getValueSize());
+    constant->setInBytes(expression->getInBytes());
+    delete expression;
+    ++m_foldedCount;
+    return constant;
+}
+
+AbstractExpression* ExpressionOptimizer::memoize(AbstractExpression* expression, PlannerDomValue obj,
+                                                 const Summary& summary)
+{
+    boost::shared_ptr<ExpressionMemo>& memo = m_memos[summary.canonical];
+    if (memo) {
+        // The same subtree was built before; use that one.
+        delete expression;
+        ++m_sharedCount;
+    }
+    else {
+        std::vector<TupleValueExpression*> columns;
+        if (summary.inputs == INPUTS_COLUMNS) {
+            collectColumns(obj, columns);
+        }
+        memo.reset(new ExpressionMemo(expression, columns));
+        ++m_memoizedCount;
+    }
+    return new MemoizedExpression(memo);
+}
+
+}
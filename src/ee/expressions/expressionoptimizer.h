@@ -0,0 +1,126 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPRESSIONOPTIMIZER_H_
+#define EXPRESSIONOPTIMIZER_H_
+
+#include "common/PlannerDomValue.h"
+
+#include "boost/shared_ptr.hpp"
+
+#include <map>
+
+namespace voltdb {
+
+class AbstractExpression;
+class ExpressionMemo;
+
+/**
+ * Rewrites the expression trees of a plan fragment as they are built:
+ *  - a subtree of constants only is evaluated once, at plan load, and
+ *    replaced by a constant;
+ *  - a subtree of constants and parameters only (NOW counts as one) is
+ *    memoized, so that it is evaluated once per fragment execution
+ *    rather than once per row;
+ *  - a subtree that calls an expensive function, like FIELD or
+ *    REGEXP_POSITION, and appears more than once in the fragment, for
+ *    instance in both a predicate and a projection, is shared, so that
+ *    it is evaluated once per row.
+ * Only the largest such subtrees are rewritten.  Equal subtrees are
+ * found by a hash of each node's own members and its children's
+ * subtrees, computed bottom up as the fragment is scanned up front.
+ *
+ * An optimizer is in effect for the trees built on its thread while it
+ * exists; trees built outside of one are left as they are.
+ */
+class ExpressionOptimizer {
+public:
+    explicit ExpressionOptimizer(PlannerDomValue fragment);
+    ~ExpressionOptimizer();
+
+    /** The optimizer in effect on this thread, or NULL */
+    static ExpressionOptimizer* current();
+
+    /**
+     * Called by AbstractExpression::buildExpressionTree for each
+     * expression built from obj, with the JSON of its parent (NULL for
+     * the root of a tree).  Returns the expression, or its replacement,
+     * having deleted it.
+     */
+    AbstractExpression* optimize(AbstractExpression* expression, PlannerDomValue obj,
+                                 const PlannerDomValue* parent);
+
+    /** Number of subtrees replaced by a constant */
+    int foldedCount() const { return m_foldedCount; }
+
+    /** Number of subtrees memoized, and of those, uses of a shared one */
+    int memoizedCount() const { return m_memoizedCount; }
+    int sharedCount() const { return m_sharedCount; }
+
+private:
+    // What a subtree reads, from least to most variable
+    enum Inputs {
+        INPUTS_CONSTANTS,
+        INPUTS_PARAMETERS,
+        INPUTS_COLUMNS,
+        // subqueries and the like: never rewritten
+        INPUTS_OTHER
+    };
+
+    struct Summary {
+        Summary()
+            : inputs(INPUTS_OTHER), isLeaf(false), isReplaceable(false), callsExpensiveFunction(false)
+            , canonical(NULL)
+        {}
+        Inputs inputs;
+        bool isLeaf;
+        // false for parts of their parent, like the alternatives of a CASE
+        bool isReplaceable;
+        // JSON and regular expression functions; see isExpensiveFunction
+        bool callsExpensiveFunction;
+        // Unless inputs is INPUTS_OTHER: the first subtree seen that is
+        // equal to this one, which stands for all of them
+        const rapidjson::Value* canonical;
+    };
+
+    const Summary& summarize(rapidjson::Value& obj);
+    size_t hashNode(rapidjson::Value& obj);
+    bool isSameNode(rapidjson::Value& lhs, rapidjson::Value& rhs);
+    const rapidjson::Value* canonicalSubtree(rapidjson::Value& obj, size_t hash);
+    const rapidjson::Value* canonicalOf(rapidjson::Value& child) const;
+    void countSubtrees(rapidjson::Value& value);
+    int countOf(const Summary& summary) const;
+
+    AbstractExpression* fold(AbstractExpression* expression);
+    AbstractExpression* memoize(AbstractExpression* expression, PlannerDomValue obj,
+                                const Summary& summary);
+
+    std::map<const rapidjson::Value*, Summary> m_summaries;
+    // The canonical subtrees by structural hash
+    std::multimap<size_t, const rapidjson::Value*> m_subtrees;
+    // Keyed by canonical subtree
+    std::map<const rapidjson::Value*, int> m_counts;
+    std::map<const rapidjson::Value*, boost::shared_ptr<ExpressionMemo> > m_memos;
+    ExpressionOptimizer* m_previous;
+    int m_foldedCount;
+    int m_memoizedCount;
+    int m_sharedCount;
+};
+
+}
+
+#endif /* EXPRESSIONOPTIMIZER_H_ */
@@ -62,5 +62,6 @@
 #include "expressions/subqueryexpression.h"
 #include "expressions/scalarvalueexpression.h"
 #include "expressions/vectorcomparisonexpression.hpp"
+#include "expressions/memoizedexpression.h"
 
 #endif
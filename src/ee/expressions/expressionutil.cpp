@@ -277,6 +277,14 @@ ExpressionUtil::comparisonFactory(PlannerDomValue obj, ExpressionType et, Abstra
 {
     assert(lc);
 
+    // LikeExpression caches its analyzed pattern, which only pays off
+    // when the pattern stays the same from row to row.
+    if (et == EXPRESSION_TYPE_COMPARE_LIKE &&
+        (dynamic_cast<ConstantValueExpression*>(rc) != NULL ||
+         dynamic_cast<ParameterValueExpression*>(rc) != NULL)) {
+        return new LikeExpression(et, lc, rc);
+    }
+
     // more specialization available?
     ConstantValueExpression *l_const =
       dynamic_cast<ConstantValueExpression*>(lc);
@@ -27,22 +27,16 @@
 #include <jsoncpp/jsoncpp.h>
 #include <jsoncpp/jsoncpp-forwards.h>
 
-namespace voltdb {
-
-/** a path node is either a field name or an array index */
-struct JsonPathNode {
-    JsonPathNode(int32_t arrayIndex) : m_arrayIndex(arrayIndex) {}
-    JsonPathNode(const char* field) : m_arrayIndex(-1), m_field(field) {}
+#include "common/executorcontext.hpp"
+#include "expressions/JsonPathEvaluator.h"
 
-    int32_t m_arrayIndex;
-    std::string m_field;
-};
+namespace voltdb {
 
 /** representation of a JSON document that can be accessed and updated via
     our path syntax */
 class JsonDocument {
 public:
-    JsonDocument(const char* docChars, int32_t lenDoc) : m_head(NULL), m_tail(NULL) {
+    JsonDocument(const char* docChars, int32_t lenDoc) {
         if (docChars == NULL) {
             // null documents have null everything, but they turn into objects/arrays
             // if we try to set their properties
@@ -59,9 +53,15 @@ public:
         if (m_doc.isNull()) {
             return false;
         }
+        return get(JsonPathParser::resolve(pathChars, lenPath), serializedValue);
+    }
+
+    bool get(const std::vector<JsonPathNode>& path, std::string& serializedValue) {
+        if (m_doc.isNull()) {
+            return false;
+        }
 
-        // get and traverse the path
-        std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath);
+        // traverse the path
         const Json::Value* node = &m_doc;
         for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
             const JsonPathNode& pathNode = *cit;
@@ -71,7 +71,7 @@ public:
                     return false;
                 }
                 int32_t arrayIndex = pathNode.m_arrayIndex;
-                if (arrayIndex == ARRAY_TAIL) {
+                if (arrayIndex == JsonPathParser::ARRAY_TAIL) {
                     unsigned int arraySize = node->size();
                     arrayIndex = arraySize > 0 ? arraySize - 1 : 0;
                 }
@@ -103,6 +103,12 @@ public:
     }
 
     void set(const char* pathChars, int32_t lenPath, const char* valueChars, int32_t lenValue) {
+        set(NULL, pathChars, lenPath, valueChars, lenValue);
+    }
+
+    /** set with the path already parsed, when it is not NULL */
+    void set(const std::vector<JsonPathNode>* parsedPath, const char* pathChars, int32_t lenPath,
+             const char* valueChars, int32_t lenValue) {
         // translate database nulls into JSON nulls, because that's really all that makes
         // any semantic sense. otherwise, parse the value as JSON
         Json::Value value;
@@ -112,7 +118,12 @@ public:
             throwJsonFormattingError();
         }
 
-        std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath, true /*enforceArrayIndexLimitForSet*/);
+        std::vector<JsonPathNode> resolvedPath;
+        if (parsedPath == NULL) {
+            resolvedPath = JsonPathParser::resolve(pathChars, lenPath, true /*enforceArrayIndexLimitForSet*/);
+            parsedPath = &resolvedPath;
+        }
+        const std::vector<JsonPathNode>& path = *parsedPath;
         // the non-const version of the Json::Value [] operator creates a new, null node on attempted
         // access if none already exists
         Json::Value* node = &m_doc;
@@ -124,7 +135,7 @@ public:
                     return;
                 }
                 int32_t arrayIndex = pathNode.m_arrayIndex;
-                if (arrayIndex == ARRAY_TAIL) {
+                if (arrayIndex == JsonPathParser::ARRAY_TAIL) {
                     arrayIndex = node->size();
                 }
                 // get or create the specified node
@@ -144,157 +155,6 @@ private:
     Json::Reader m_reader;
     Json::FastWriter m_writer;
 
-    const char* m_head;
-    const char* m_tail;
-    int32_t m_pos;
-
-    static const int32_t ARRAY_TAIL = -10;
-
-    /** parse our path to its vector representation */
-    std::vector<JsonPathNode> resolveJsonPath(const char* pathChars, int32_t lenPath,
-                                              bool enforceArrayIndexLimitForSet = false) {
-        std::vector<JsonPathNode> path;
-        // NULL path refers directly to the doc root
-        if (pathChars == NULL) {
-            return path;
-        }
-        m_head = pathChars;
-        m_tail = m_head + lenPath;
-
-        m_pos = -1;
-        char c;
-        bool first = true;
-        bool expectArrayIndex = false;
-        bool expectField = false;
-        char strField[lenPath];
-        while (readChar(c)) {
-            if (expectArrayIndex) {
-                // -1 index to refer to the tail of the array
-                bool neg = false;
-                if (c == '-') {
-                    neg = true;
-                    if (!readChar(c)) {
-                        throwInvalidPathError("Unexpected termination (unterminated array access)");
-                    }
-                }
-                if (c < '0' || c > '9') {
-                    throwInvalidPathError("Unexpected character in array index");
-                }
-                // atoi while advancing our pointer
-                int64_t arrayIndex = c - '0';
-                bool terminated = false;
-                while (readChar(c)) {
-                    if (c == ']') {
-                        terminated = true;
-                        break;
-                    } else if (c < '0' || c > '9') {
-                        throwInvalidPathError("Unexpected character in array index");
-                    }
-                    arrayIndex = 10 * arrayIndex + (c - '0');
-                    if (enforceArrayIndexLimitForSet) {
-                        // This 500000 is a mostly arbitrary maximum JSON array index enforced for practical
-                        // purposes. We enforce this up front to avoid excessive delays, ridiculous short-term
-                        // memory growth, and/or bad_alloc errors that the jsoncpp library could produce
-                        // essentially for nothing since our supported JSON document columns are typically not
-                        // wide enough to hold the string representations of arrays this large.
-                        if (arrayIndex > 500000) {
-                            if (neg) {
-                                // other than the special '-1' case, negative indices aren't allowed
-                                throwInvalidPathError("Array index less than -1");
-                            }
-                            throwInvalidPathError("Array index greater than the maximum allowed value of 500000");
-                        }
-                    } else {
-                        if (arrayIndex > static_cast<int64_t>(INT32_MAX)) {
-                            if (neg) {
-                                // other than the special '-1' case, negative indices aren't allowed
-                                throwInvalidPathError("Array index less than -1");
-                            }
-                            throwInvalidPathError("Array index greater than the maximum integer value");
-                        }
-                    }
-                }
-                if ( ! terminated ) {
-                    throwInvalidPathError("Missing ']' after array index");
-                }
-                if (neg) {
-                    // other than the special '-1' case, negative indices aren't allowed
-                    if (arrayIndex != 1) {
-                        throwInvalidPathError("Array index less than -1");
-                    }
-                    arrayIndex = ARRAY_TAIL;
-                }
-                path.push_back(static_cast<int32_t>(arrayIndex));
-                expectArrayIndex = false;
-            } else if (c == '[') {
-                // handle the case of empty field names. for example, getting the first element of the array
-                // in { "a": { "": [ true, false ] } } would be the path 'a.[0]'
-                if (expectField) {
-                    path.push_back(JsonPathNode(""));
-                    expectField = false;
-                }
-                expectArrayIndex = true;
-            } else if (c == '.') {
-                // a leading '.' also involves accessing the "" property of the root...
-                if (expectField || first) {
-                    path.push_back(JsonPathNode(""));
-                }
-                expectField = true;
-            } else {
-                expectField = false;
-                // read a literal field name
-                int32_t i = 0;
-                do {
-                    if (c == '\\') {
-                        if (!readChar(c) || (c != '[' && c != ']' && c != '.' && c != '\\')) {
-                            throwInvalidPathError("Unescaped backslash (double escaping required for path)");
-                        }
-                    } else if (c == '.') {
-                        expectField = true;
-                        break;
-                    } else if (c == '[') {
-                        expectArrayIndex = true;
-                        break;
-                    }
-                    strField[i++] = c;
-                } while (readChar(c));
-                strField[i] = '\0';
-                path.push_back(JsonPathNode(strField));
-            }
-            first = false;
-        }
-        // trailing '['
-        if (expectArrayIndex) {
-            throwInvalidPathError("Unexpected termination (unterminated array access)");
-        }
-        // if we're either empty or ended on a trailing '.', add an empty field name
-        if (expectField || first) {
-            path.push_back(JsonPathNode(""));
-        }
-
-        m_head = NULL;
-        m_tail = NULL;
-        return path;
-    }
-
-    bool readChar(char& c) {
-        assert(m_head != NULL && m_tail != NULL);
-        if (m_head == m_tail) {
-            return false;
-        }
-        c = *m_head++;
-        m_pos++;
-        return true;
-    }
-
-    void throwInvalidPathError(const char* err) const {
-        char msg[1024];
-        snprintf(msg, sizeof(msg), "Invalid JSON path: %s [position %d]", err, m_pos);
-        throw SQLException(SQLException::
-                           data_exception_invalid_parameter,
-                           msg);
-    }
-
     void throwJsonFormattingError() const {
         char msg[1024];
         // getFormatedErrorMessages returns concise message about location
@@ -329,10 +189,27 @@ template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>
 
     int32_t lenDoc;
     const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    JsonDocument doc(docChars, lenDoc);
-
     int32_t lenPath;
     const char* pathChars = pathNVal.getObject_withoutNull(&lenPath);
+
+    // Look for the field without building the document, when we can
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    if (context != NULL) {
+        JsonPathEvaluator& evaluator = context->jsonPathEvaluator();
+        const std::vector<JsonPathNode>* path = evaluator.path(pathChars, lenPath, false);
+        if (path != NULL) {
+            switch (evaluator.find(docChars, lenDoc, *path)) {
+            case JsonPathEvaluator::FOUND:
+                return getTempStringValue(evaluator.result().c_str(), evaluator.result().length());
+            case JsonPathEvaluator::NOT_FOUND:
+                return getNullStringValue();
+            case JsonPathEvaluator::NOT_READ:
+                break;
+            }
+        }
+    }
+
+    JsonDocument doc(docChars, lenDoc);
     std::string result;
     if (doc.get(pathChars, lenPath, result)) {
         return getTempStringValue(result.c_str(), result.length() - 1);
@@ -358,10 +235,23 @@ template<> inline NValue NValue::call<FUNC_VOLT_ARRAY_ELEMENT>(const std::vector
     }
     int32_t lenDoc;
     const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    const std::string doc(docChars, lenDoc);
 
     int32_t index = indexNVal.castAsIntegerAndGetValue();
 
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    if (context != NULL && index >= 0) {
+        JsonPathEvaluator& evaluator = context->jsonPathEvaluator();
+        switch (evaluator.findArrayElement(docChars, lenDoc, index)) {
+        case JsonPathEvaluator::FOUND:
+            return getTempStringValue(evaluator.result().c_str(), evaluator.result().length());
+        case JsonPathEvaluator::NOT_FOUND:
+            return getNullStringValue();
+        case JsonPathEvaluator::NOT_READ:
+            break;
+        }
+    }
+
+    const std::string doc(docChars, lenDoc);
     Json::Value root;
     Json::Reader reader;
 
@@ -485,8 +375,15 @@ template<> inline NValue NValue::call<FUNC_VOLT_SET_FIELD>(const std::vector<NVa
     int32_t lenValue;
     const char* valueChars = valueNVal.getObject_withoutNull(&lenValue);
 
+    // a parsed path from the site's cache saves parsing it for every row
+    const std::vector<JsonPathNode>* path = NULL;
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    if (context != NULL) {
+        path = context->jsonPathEvaluator().path(pathChars, lenPath, true);
+    }
+
     try {
-        doc.set(pathChars, lenPath, valueChars, lenValue);
+        doc.set(path, pathChars, lenPath, valueChars, lenValue);
         std::string value = doc.value();
         return getTempStringValue(value.c_str(), value.length() - 1);
     }
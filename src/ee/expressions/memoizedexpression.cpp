@@ -0,0 +1,172 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/memoizedexpression.h"
+
+#include "common/executorcontext.hpp"
+#include "common/tabletuple.h"
+#include "common/ValuePeeker.hpp"
+#include "expressions/tuplevalueexpression.h"
+
+#include "boost/foreach.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace voltdb {
+
+namespace {
+
+template <typename T>
+void appendBytes(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/** Append the exact value, with its type, to the key */
+bool appendValue(std::string& key, const NValue& value) {
+    const ValueType type = ValuePeeker::peekValueType(value);
+    key.push_back(static_cast<char>(type));
+    if (value.isNull()) {
+        key.push_back(1);
+        return true;
+    }
+    key.push_back(0);
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_DECIMAL:
+    case VALUE_TYPE_BOOLEAN: {
+        int32_t length;
+        const char* data = ValuePeeker::peekPointerToDataBytes(value, &length);
+        key.append(data, length);
+        return true;
+    }
+    case VALUE_TYPE_DOUBLE:
+        // by bits, so that 0 and -0 differ
+        appendBytes(key, ValuePeeker::peekDouble(value));
+        return true;
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY: {
+        int32_t length;
+        const char* data = ValuePeeker::peekObject_withoutNull(value, &length);
+        appendBytes(key, length);
+        key.append(data, length);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+}
+
+ExpressionMemo::ExpressionMemo(AbstractExpression* expression,
+                               const std::vector<TupleValueExpression*>& columns)
+    : m_expression(expression)
+    , m_columns(columns)
+    , m_executionCount(0)
+    , m_purgeCount(0)
+    , m_hasResult(false)
+{
+}
+
+ExpressionMemo::~ExpressionMemo()
+{
+    BOOST_FOREACH(TupleValueExpression* column, m_columns) {
+        delete column;
+    }
+}
+
+bool ExpressionMemo::buildKey(const TableTuple* tuple1, const TableTuple* tuple2, std::string& key) const
+{
+    key.clear();
+    BOOST_FOREACH(const TupleValueExpression* column, m_columns) {
+        // The expression may not have read a column of a missing tuple.
+        const TableTuple* tuple = column->getTupleId() == 0 ? tuple1 : tuple2;
+        if (tuple == NULL || tuple->isNullTuple() ||
+            ! appendValue(key, tuple->getNValue(column->getColumnId()))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+NValue ExpressionMemo::eval(const TableTuple* tuple1, const TableTuple* tuple2)
+{
+    const int64_t executionCount = ExecutorContext::getExecutorContext()->executionCount();
+    const uint64_t purgeCount = ExecutorContext::getTempStringPool()->getPurgeCount();
+    bool isKept = m_hasResult && m_executionCount == executionCount && m_purgeCount == purgeCount;
+    if ( ! m_columns.empty()) {
+        if ( ! buildKey(tuple1, tuple2, m_nextKey)) {
+            return m_expression->eval(tuple1, tuple2);
+        }
+        isKept = isKept && m_nextKey == m_key;
+    }
+    if (isKept) {
+        return m_result;
+    }
+
+    NValue result = m_expression->eval(tuple1, tuple2);
+    switch (ValuePeeker::peekValueType(result)) {
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+        // The result may point into a tuple, which may change while
+        // the inputs don't; keep a copy in the temp string pool.
+        if ( ! result.isNull()) {
+            if (result.getSourceInlined()) {
+                result.allocateObjectFromInlinedValue(NULL);
+            }
+            else {
+                result.allocateObjectFromOutlinedValue();
+            }
+        }
+        break;
+    case VALUE_TYPE_GEOGRAPHY:
+    case VALUE_TYPE_ARRAY:
+        return result;
+    default:
+        break;
+    }
+    m_key.swap(m_nextKey);
+    m_executionCount = executionCount;
+    m_purgeCount = purgeCount;
+    m_result = result;
+    m_hasResult = true;
+    return result;
+}
+
+MemoizedExpression::MemoizedExpression(const boost::shared_ptr<ExpressionMemo>& memo)
+    : AbstractExpression(memo->getExpression()->getExpressionType())
+    , m_memo(memo)
+{
+    const AbstractExpression* expression = memo->getExpression();
+    setValueType(expression->getValueType());
+    setValueSize(expression->getValueSize());
+    setInBytes(expression->getInBytes());
+}
+
+std::string MemoizedExpression::debugInfo(const std::string& spacer) const
+{
+    std::ostringstream buffer;
+    buffer << spacer << "Memoized\n" << m_memo->getExpression()->debug(spacer);
+    return buffer.str();
+}
+
+}
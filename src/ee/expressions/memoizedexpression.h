@@ -0,0 +1,98 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMOIZEDEXPRESSION_H_
+#define MEMOIZEDEXPRESSION_H_
+
+#include "common/NValue.hpp"
+#include "expressions/abstractexpression.h"
+
+#include "boost/scoped_ptr.hpp"
+#include "boost/shared_ptr.hpp"
+
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+class TupleValueExpression;
+
+/**
+ * Keeps the last result of an expression.  A subtree of constants and
+ * parameters is evaluated again only once its fragment or subquery
+ * executes again, as counted by the ExecutorContext, so once per
+ * execution rather than once per row.  A subtree which also reads
+ * columns, and appears in several places of a fragment (each a
+ * MemoizedExpression sharing one memo), keeps its result along with
+ * the values of those columns, so it is evaluated once per row.  No
+ * result is kept past a purge of the temp string pool, which holds it.
+ * See ExpressionOptimizer.
+ */
+class ExpressionMemo {
+public:
+    /**
+     * The memo owns the expression and the separately built columns
+     * it reads.
+     */
+    ExpressionMemo(AbstractExpression* expression,
+                   const std::vector<TupleValueExpression*>& columns);
+    ~ExpressionMemo();
+
+    NValue eval(const TableTuple* tuple1, const TableTuple* tuple2);
+
+    const AbstractExpression* getExpression() const {
+        return m_expression.get();
+    }
+
+private:
+    /** False if the columns can't be keyed, so the result is not kept */
+    bool buildKey(const TableTuple* tuple1, const TableTuple* tuple2, std::string& key) const;
+
+    boost::scoped_ptr<AbstractExpression> m_expression;
+    std::vector<TupleValueExpression*> m_columns;
+    // the columns read for the kept result, and for this evaluation
+    std::string m_key;
+    std::string m_nextKey;
+    // when the kept result was evaluated
+    int64_t m_executionCount;
+    uint64_t m_purgeCount;
+    NValue m_result;
+    bool m_hasResult;
+};
+
+/** One use of an ExpressionMemo in an expression tree */
+class MemoizedExpression : public AbstractExpression {
+public:
+    MemoizedExpression(const boost::shared_ptr<ExpressionMemo>& memo);
+
+    NValue eval(const TableTuple* tuple1, const TableTuple* tuple2) const {
+        return m_memo->eval(tuple1, tuple2);
+    }
+
+    bool hasParameter() const {
+        return m_memo->getExpression()->hasParameter();
+    }
+
+    std::string debugInfo(const std::string& spacer) const;
+
+private:
+    const boost::shared_ptr<ExpressionMemo> m_memo;
+};
+
+}
+
+#endif /* MEMOIZEDEXPRESSION_H_ */
@@ -19,6 +19,8 @@
 #define STRINGFUNCTIONS_H
 
 #include "common/ThreadLocalPool.h" // for POOLED_MAX_VALUE_LENGTH
+#include "common/executorcontext.hpp"
+#include "expressions/RegexpPatternCache.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/locale.hpp>
@@ -26,10 +28,10 @@
 
 #define PCRE2_CODE_UNIT_WIDTH 8
 #include <string.h>
-#include <boost/shared_ptr.hpp>
 #include "pcre2.h"
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <cstring>
@@ -907,47 +909,50 @@ template<> inline NValue NValue::call<FUNC_VOLT_REGEXP_POSITION>(const std::vect
     int32_t lenPat;
     const unsigned char* patChars = reinterpret_cast<const unsigned char*>
         (pat.getObject_withoutNull(&lenPat));
-    // Compile the pattern.
+    // Compile the pattern, or find it already compiled in the site's cache.
 
     int error_code = 0;
-    PCRE2_SIZE error_offset = 0;
+    pcre2_code *pattern = NULL;
+    pcre2_match_data *match_data = NULL;
     /*
-     * Note: We use a shared_ptr here, even though nothing is really shared.
-     *       We want to make sure the deleter, pcre2_code_free, is called when
-     *       this goes out of scope.  Scoped_ptr is a better choice here,
-     *       but it will not allow a custom deleter.  Unique_ptr is an even
-     *       better choice, but without C++11 move semantics this is not
-     *       really implementable, and this is a C++03 code.  So we are
-     *       stuck with shared_ptr.  The overhead is a reference count,
-     *       and an increment and decrement.  This is pretty small
-     *       compared with regular expression compilation and matching,
-     *       so it's not likely to be expensive.
+     * Note: Without an executor context the pattern is compiled for this
+     *       call only, and freed with pcre2_code_free and
+     *       pcre2_match_data_free when this goes out of scope.
      */
-    boost::shared_ptr<pcre2_code> pattern ( pcre2_compile(patChars,
-                                                          lenPat,
-                                                          syntaxOpts,
-                                                          &error_code,
-                                                          &error_offset,
-                                                          NULL), pcre2_code_free );
-    if (pattern.get() == NULL) {
+    std::unique_ptr<pcre2_code, void (*)(pcre2_code *)> ownedPattern(NULL, pcre2_code_free);
+    std::unique_ptr<pcre2_match_data, void (*)(pcre2_match_data *)>
+        ownedMatchData(NULL, pcre2_match_data_free);
+    ExecutorContext *context = ExecutorContext::getExecutorContext();
+    if (context != NULL) {
+        pattern = context->regexpPatternCache().get(reinterpret_cast<const char *>(patChars), lenPat,
+                                                    syntaxOpts, &match_data, &error_code);
+    }
+    else {
+        PCRE2_SIZE error_offset = 0;
+        ownedPattern.reset(pcre2_compile(patChars, lenPat, syntaxOpts, &error_code, &error_offset, NULL));
+        pattern = ownedPattern.get();
+        if (pattern != NULL) {
+            ownedMatchData.reset(pcre2_match_data_create_from_pattern(pattern, NULL));
+            match_data = ownedMatchData.get();
+            if (match_data == NULL) {
+                throw SQLException(SQLException::data_exception_invalid_parameter, "Internal error: Cannot create PCRE2 match data.");
+            }
+        }
+    }
+    if (pattern == NULL) {
+        if (error_code == PCRE2_ERROR_NOMEMORY) {
+            throw SQLException(SQLException::data_exception_invalid_parameter, "Internal error: Cannot create PCRE2 match data.");
+        }
         std::string emsg = pcre2_error_code_message(error_code, "Regular Expression Compilation Error: ");
         throw SQLException(SQLException::data_exception_invalid_parameter, emsg.c_str());
     }
-    /*
-     * We use a shared_ptr for the same reasons as above.
-     */
-    boost::shared_ptr<pcre2_match_data> match_data(pcre2_match_data_create_from_pattern(pattern.get(), NULL),
-                                                   pcre2_match_data_free);
-    if (match_data.get() == NULL) {
-        throw SQLException(SQLException::data_exception_invalid_parameter, "Internal error: Cannot create PCRE2 match data.");
-    }
     unsigned int matchFlags = 0;
-    error_code = pcre2_match(pattern.get(),
+    error_code = pcre2_match(pattern,
                       sourceChars,
                       lenSource,
                       0ul,
                       matchFlags,
-                      match_data.get(),
+                      match_data,
                       NULL);
     if (error_code < 0) {
         if (error_code == PCRE2_ERROR_NOMATCH) {
@@ -956,7 +961,7 @@ template<> inline NValue NValue::call<FUNC_VOLT_REGEXP_POSITION>(const std::vect
         std::string emsg = pcre2_error_code_message(error_code, "Regular Expression Matching Error: ");
         throw SQLException(SQLException::data_exception_invalid_parameter, emsg.c_str());
     }
-    PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(match_data.get());
+    PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(match_data);
     unsigned long position = ovector[0];
     return getBigIntValue(getCharLength(reinterpret_cast<const char *>(sourceChars), position) + 1);
 }
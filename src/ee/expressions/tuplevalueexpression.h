@@ -91,6 +91,8 @@ class TupleValueExpression : public AbstractExpression {
 
     int getColumnId() const {return this->value_idx;}
 
+    int getTupleId() const {return this->tuple_idx;}
+
   protected:
 
     const int tuple_idx;           // which tuple. defaults to tuple1
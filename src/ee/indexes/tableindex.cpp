@@ -47,6 +47,7 @@
 #include "indexes/tableindex.h"
 #include "expressions/abstractexpression.h"
 #include "expressions/expressionutil.h"
+#include "expressions/tuplevalueexpression.h"
 #include "storage/TableCatalogDelegate.hpp"
 
 using namespace voltdb;
@@ -91,8 +92,152 @@ TableIndex::TableIndex(const TupleSchema *keySchema, const TableIndexScheme &sch
     m_deletes(0),
     m_updates(0),
 
-    m_stats(this)
-{}
+    m_stats(this),
+    m_predicateCompiled(false)
+{
+    if (isPartialIndex()) {
+        m_predicateCompiled = compilePredicateTerms(getPredicate());
+        if (! m_predicateCompiled) {
+            m_predicateTerms.clear();
+        }
+    }
+}
+
+static ExpressionType mirrorComparison(ExpressionType op)
+{
+    switch (op) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+        return op;
+    }
+}
+
+bool TableIndex::compilePredicateTerms(const AbstractExpression *expr)
+{
+    const ExpressionType type = expr->getExpressionType();
+    switch (type) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+        return compilePredicateTerms(expr->getLeft()) && compilePredicateTerms(expr->getRight());
+
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO: {
+        const AbstractExpression *left = expr->getLeft();
+        const AbstractExpression *right = expr->getRight();
+        PredicateTerm term;
+        term.op = type;
+        if (right->getExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE &&
+            left->getExpressionType() == EXPRESSION_TYPE_VALUE_CONSTANT) {
+            std::swap(left, right);
+            term.op = mirrorComparison(type);
+        }
+        if (left->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE ||
+            right->getExpressionType() != EXPRESSION_TYPE_VALUE_CONSTANT) {
+            return false;
+        }
+        term.column = static_cast<const TupleValueExpression*>(left)->getColumnId();
+        term.constant = right->eval(NULL, NULL);
+        m_predicateTerms.push_back(term);
+        return true;
+    }
+
+    case EXPRESSION_TYPE_OPERATOR_IS_NULL:
+    case EXPRESSION_TYPE_OPERATOR_NOT: {
+        // Only IS NULL and NOT (IS NULL) of a column are compiled.
+        const AbstractExpression *operand = expr->getLeft();
+        if (type == EXPRESSION_TYPE_OPERATOR_NOT) {
+            if (operand == NULL || operand->getExpressionType() != EXPRESSION_TYPE_OPERATOR_IS_NULL) {
+                return false;
+            }
+            operand = operand->getLeft();
+        }
+        if (operand == NULL || operand->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE) {
+            return false;
+        }
+        PredicateTerm term;
+        term.op = type;
+        term.column = static_cast<const TupleValueExpression*>(operand)->getColumnId();
+        m_predicateTerms.push_back(term);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+bool TableIndex::predicateAccepts(const TableTuple *tuple) const
+{
+    if (m_predicateCompiled) {
+        return compiledPredicateAccepts(tuple);
+    }
+    return getPredicate()->eval(tuple, NULL).isTrue();
+}
+
+bool TableIndex::compiledPredicateAccepts(const TableTuple *tuple) const
+{
+    for (std::vector<PredicateTerm>::const_iterator it = m_predicateTerms.begin();
+         it != m_predicateTerms.end(); ++it) {
+        const NValue value = tuple->getNValue(it->column);
+        switch (it->op) {
+        case EXPRESSION_TYPE_OPERATOR_IS_NULL:
+            if (! value.isNull()) {
+                return false;
+            }
+            continue;
+        case EXPRESSION_TYPE_OPERATOR_NOT:
+            if (value.isNull()) {
+                return false;
+            }
+            continue;
+        default:
+            break;
+        }
+
+        // As in ComparisonExpression, comparing with NULL is never true.
+        if (value.isNull() || it->constant.isNull()) {
+            return false;
+        }
+
+        const int cmp = value.compare_withoutNull(it->constant);
+        bool accepted;
+        switch (it->op) {
+        case EXPRESSION_TYPE_COMPARE_EQUAL:
+            accepted = cmp == 0;
+            break;
+        case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+            accepted = cmp != 0;
+            break;
+        case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+            accepted = cmp < 0;
+            break;
+        case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+            accepted = cmp > 0;
+            break;
+        case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+            accepted = cmp <= 0;
+            break;
+        default:
+            assert(it->op == EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO);
+            accepted = cmp >= 0;
+            break;
+        }
+        if (! accepted) {
+            return false;
+        }
+    }
+    return true;
+}
 
 TableIndex::~TableIndex()
 {
@@ -166,7 +311,7 @@ bool TableIndex::equals(const TableIndex *other) const
 
 void TableIndex::addEntry(const TableTuple *tuple, TableTuple *conflictTuple)
 {
-    if (isPartialIndex() && !getPredicate()->eval(tuple, NULL).isTrue()) {
+    if (isPartialIndex() && !predicateAccepts(tuple)) {
         // Tuple fails the predicate. Do not add it.
         return;
     }
@@ -175,7 +320,7 @@ void TableIndex::addEntry(const TableTuple *tuple, TableTuple *conflictTuple)
 
 bool TableIndex::deleteEntry(const TableTuple *tuple)
 {
-    if (isPartialIndex() && !getPredicate()->eval(tuple, NULL).isTrue()) {
+    if (isPartialIndex() && !predicateAccepts(tuple)) {
         // Tuple fails the predicate. Nothing to delete
         return true;
     }
@@ -187,22 +332,22 @@ bool TableIndex::replaceEntryNoKeyChange(const TableTuple &destinationTuple, con
     assert(originalTuple.address() != destinationTuple.address());
 
     if (isPartialIndex()) {
-        const AbstractExpression* predicate = getPredicate();
-        if (!predicate->eval(&destinationTuple, NULL).isTrue() && !predicate->eval(&originalTuple, NULL).isTrue()) {
+        const bool destinationAccepted = predicateAccepts(&destinationTuple);
+        const bool originalAccepted = predicateAccepts(&originalTuple);
+        if (!destinationAccepted && !originalAccepted) {
             // both tuples fail the predicate. Nothing to do. Return TRUE
             return true;
-        } else if (predicate->eval(&destinationTuple, NULL).isTrue() && !predicate->eval(&originalTuple, NULL).isTrue()) {
+        } else if (destinationAccepted && !originalAccepted) {
             // The original tuple fails the predicate meaning the tuple is not indexed.
             // Simply add the new tuple
             TableTuple conflict(destinationTuple.getSchema());
             addEntryDo(&destinationTuple, &conflict);
             return conflict.isNullTuple();
-        } else if (!predicate->eval(&destinationTuple, NULL).isTrue() && predicate->eval(&originalTuple, NULL).isTrue()) {
+        } else if (!destinationAccepted && originalAccepted) {
             // The destination tuple fails the predicate. Simply delete the original tuple
             return deleteEntryDo(&originalTuple);
         } else {
             // both tuples pass the predicate.
-            assert(predicate->eval(&destinationTuple, NULL).isTrue() && predicate->eval(&originalTuple, NULL).isTrue());
             return replaceEntryNoKeyChangeDo(destinationTuple, originalTuple);
         }
     } else {
@@ -212,7 +357,7 @@ bool TableIndex::replaceEntryNoKeyChange(const TableTuple &destinationTuple, con
 
 bool TableIndex::exists(const TableTuple *persistentTuple) const
 {
-    if (isPartialIndex() && !getPredicate()->eval(persistentTuple, NULL).isTrue())
+    if (isPartialIndex() && !predicateAccepts(persistentTuple))
     {
         // Tuple fails the predicate.
         return false;
@@ -222,17 +367,16 @@ bool TableIndex::exists(const TableTuple *persistentTuple) const
 
 bool TableIndex::checkForIndexChange(const TableTuple *lhs, const TableTuple *rhs) const {
     if (isPartialIndex()) {
-        const AbstractExpression* predicate = getPredicate();
-        if (!predicate->eval(lhs, NULL).isTrue() && !predicate->eval(rhs, NULL).isTrue()) {
+        const bool lhsAccepted = predicateAccepts(lhs);
+        const bool rhsAccepted = predicateAccepts(rhs);
+        if (!lhsAccepted && !rhsAccepted) {
             // both tuples fail the predicate. Index is unaffected. Return FALSE
             return false;
-        } else if ((predicate->eval(lhs, NULL).isTrue() && !predicate->eval(rhs, NULL).isTrue()) ||
-            (!predicate->eval(lhs, NULL).isTrue() && predicate->eval(rhs, NULL).isTrue())) {
+        } else if (lhsAccepted != rhsAccepted) {
             // only one tuple passes the predicate. Index is affected -
             // either existing tuple needs to be deleted or the new one added from/to the index
             return true;
         } else {
-            assert(predicate->eval(lhs, NULL).isTrue() && predicate->eval(rhs, NULL).isTrue());
             return checkForIndexChangeDo(lhs, rhs);
         }
     }
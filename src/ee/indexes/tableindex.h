@@ -391,6 +391,21 @@ public:
      */
     bool checkForIndexChange(const TableTuple *lhs, const TableTuple *rhs) const;
 
+    /**
+     * Return TRUE if the tuple satisfies the partial index predicate.
+     * Predicates that are conjunctions of simple column tests are
+     * evaluated without walking the expression tree.
+     */
+    bool predicateAccepts(const TableTuple *tuple) const;
+
+    /**
+     * TRUE if predicateAccepts uses the compiled form of the predicate
+     */
+    bool isPredicateCompiled() const
+    {
+        return m_predicateCompiled;
+    }
+
     /**
      * Currently, UniqueIndex is just a TableIndex with additional checks.
      * We might have to make a different class in future for maximizing
@@ -553,6 +568,20 @@ protected:
 
 private:
 
+    // One conjunct of a compiled partial index predicate:
+    // "column <op> constant", "column IS NULL" or "column IS NOT NULL".
+    struct PredicateTerm {
+        int column;
+        ExpressionType op;
+        NValue constant;
+    };
+
+    bool compilePredicateTerms(const AbstractExpression *expr);
+    bool compiledPredicateAccepts(const TableTuple *tuple) const;
+
+    std::vector<PredicateTerm> m_predicateTerms;
+    bool m_predicateCompiled;
+
     // This should always/only be required for unique key indexes used for primary keys.
     virtual TableIndex *cloneEmptyNonCountingTreeIndex() const {
         throwFatalException("Primary key index discovered to be non-unique or missing a cloneEmptyTreeIndex implementation.");
@@ -17,6 +17,7 @@
 
 #ifndef LOGDEFS_H_
 #define LOGDEFS_H_
+#include <stdint.h>
 
 namespace voltdb {
 
@@ -45,6 +46,13 @@ enum LogLevel {
     LOGLEVEL_OFF
 };
 
+/**
+ * Set in the encoded log levels, above the bits of all the loggers, to buffer
+ * TRACE and DEBUG statements in a log ring instead of forwarding each of them
+ * synchronously.  Must match org.voltdb.jni.EELoggers.BUFFER_DEBUG
+ */
+static const int64_t LOGLEVELS_BUFFER_DEBUG = static_cast<int64_t>(1ULL << 63);
+
 }
 
 #endif /* LOGDEFS_H_ */
@@ -48,10 +48,49 @@ const Logger<LOGGERID_HOST>* LogManager::getThreadLogger() {
  * sets up a thread local containing a reference to itself.
  * @param proxy The LogProxy that all the loggers should use
  */
-LogManager::LogManager(LogProxy *proxy) :  m_proxy(proxy), m_sqlLogger(proxy, LOGGERID_SQL), m_hostLogger(proxy, LOGGERID_HOST) {
+LogManager::LogManager(LogProxy *proxy) :  m_proxy(proxy), m_ring(NULL), m_sqlLogger(proxy, LOGGERID_SQL), m_hostLogger(proxy, LOGGERID_HOST) {
     (void)pthread_once(&m_keyOnce, createThreadLocalKey);
     pthread_setspecific( m_key, static_cast<const void *>(this));
 }
 
+void LogManager::enableLogRing(size_t capacity) {
+    if (m_ring != NULL) {
+        return;
+    }
+    m_ring = new LogRing(capacity);
+    m_sqlLogger.m_ring = m_ring;
+    m_hostLogger.m_ring = m_ring;
+}
+
+void LogManager::disableLogRing() {
+    if (m_ring == NULL) {
+        return;
+    }
+    drainLogRing();
+    m_sqlLogger.m_ring = NULL;
+    m_hostLogger.m_ring = NULL;
+    delete m_ring;
+    m_ring = NULL;
+}
+
+void LogManager::setLogLevels(int64_t logLevels) {
+    m_sqlLogger.m_level = static_cast<LogLevel>((7 & logLevels));
+    m_hostLogger.m_level = static_cast<LogLevel>(((7 << 3) & logLevels) >> 3);
+    if ((logLevels & LOGLEVELS_BUFFER_DEBUG) != 0 &&
+        (m_sqlLogger.m_level < LOGLEVEL_INFO || m_hostLogger.m_level < LOGLEVEL_INFO)) {
+        enableLogRing();
+    }
+    else {
+        disableLogRing();
+    }
+}
+
+void LogManager::drainThreadLogRing() {
+    LogManager *logManager = getThreadLogManager();
+    if (logManager != NULL) {
+        logManager->drainLogRing();
+    }
+}
+
 }
 
@@ -20,6 +20,7 @@
 #include "Logger.h"
 #include "LogDefs.h"
 #include "LogProxy.h"
+#include "LogRing.h"
 #include <stdint.h>
 #include <iostream>
 #include <pthread.h>
@@ -55,13 +56,13 @@ public:
     }
 
     /**
-     * Update the log levels of the loggers.
+     * Update the log levels of the loggers.  When LOGLEVELS_BUFFER_DEBUG
+     * is set and TRACE or DEBUG is on for any logger, those statements
+     * are buffered in a log ring; otherwise whatever is buffered is
+     * forwarded and the ring is freed.
      * @param logLevels Integer contaning the log levels for the various loggers
      */
-    inline void setLogLevels(int64_t logLevels) {
-        m_sqlLogger.m_level = static_cast<LogLevel>((7 & logLevels));
-        m_hostLogger.m_level = static_cast<LogLevel>(((7 << 3) & logLevels) >> 3);
-    }
+    void setLogLevels(int64_t logLevels);
 
     /**
      * Retrieve the log proxy used by this LogManager and its Loggers
@@ -72,9 +73,35 @@ public:
     }
 
     /**
-     * Frees the log proxy
+     * Buffer TRACE and DEBUG statements in a ring drained by drainLogRing
+     * instead of forwarding each of them to the log proxy.  setLogLevels
+     * does this when asked to; calling it first only picks the capacity.
+     * @param capacity Size of the ring in bytes
+     */
+    void enableLogRing(size_t capacity = LogRing::DEFAULT_CAPACITY);
+
+    /**
+     * Forward the buffered statements to the log proxy.  Only the thread
+     * that owns this LogManager may call this.
+     * @return Number of statements forwarded
+     */
+    inline size_t drainLogRing() {
+        if (m_ring == NULL || m_ring->isEmpty()) {
+            return 0;
+        }
+        return m_ring->drain(m_proxy);
+    }
+
+    inline const LogRing* getLogRing() const {
+        return m_ring;
+    }
+
+    /**
+     * Forwards any buffered statements, then frees the log ring and the log proxy
      */
     ~LogManager() {
+        drainLogRing();
+        delete m_ring;
         delete m_proxy;
     }
 
@@ -87,14 +114,28 @@ public:
         return getThreadLogManager()->getLogger(id);
     }
 
+    /**
+     * Forward whatever the LogManager associated with this thread has
+     * buffered, if there is one.  Called before crashing the process so
+     * the debug output leading up to the crash is not lost.
+     */
+    static void drainThreadLogRing();
+
 private:
 
     static LogManager* getThreadLogManager();
 
+    void disableLogRing();
+
     /**
      * The log proxy in use by this LogManager and its Loggers
      */
     const LogProxy *m_proxy;
+
+    /**
+     * Buffer for debug output, NULL unless enabled
+     */
+    LogRing *m_ring;
     Logger m_sqlLogger;
     Logger m_hostLogger;
 };
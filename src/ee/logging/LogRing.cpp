@@ -0,0 +1,253 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LogRing.h"
+#include "LogProxy.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+namespace voltdb {
+
+/**
+ * Every record starts with this header and is padded to a multiple of
+ * 8 bytes.  A record never wraps around the end of the buffer; the
+ * space left there is filled with a padding record instead.
+ */
+struct LogRing::Record {
+    enum Kind {
+        PADDING,
+        TEXT
+    };
+
+    uint32_t length;
+    uint8_t kind;
+    uint8_t loggerId;
+    uint8_t level;
+    uint8_t unused;
+    // TEXT: the NUL terminated statement follows
+};
+
+namespace {
+
+// Room for the dropped statements warning
+const size_t MAX_WARNING_LENGTH = 128;
+
+inline size_t align(size_t length) {
+    return (length + 7) & ~static_cast<size_t>(7);
+}
+
+}
+
+LogRing::LogRing(size_t capacity)
+    : m_buffer(NULL), m_capacity(64), m_head(0), m_reservedHead(0), m_dropped(0),
+      m_tail(0), m_reportedDrops(0)
+{
+    while (m_capacity < capacity) {
+        m_capacity <<= 1;
+    }
+    m_buffer = new char[m_capacity];
+}
+
+LogRing::~LogRing() {
+    delete [] m_buffer;
+}
+
+bool LogRing::isEmpty() const {
+    return __atomic_load_n(&m_head, __ATOMIC_ACQUIRE) == __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+}
+
+uint64_t LogRing::droppedCount() const {
+    return __atomic_load_n(&m_dropped, __ATOMIC_RELAXED);
+}
+
+/**
+ * Find room for a record of the given (aligned) length, padding out the
+ * end of the buffer if the record would straddle it.  Nothing becomes
+ * visible to drain() until publish().
+ */
+char *LogRing::reserve(size_t length) {
+    const uint64_t head = m_head;
+    const uint64_t tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+    const size_t offset = static_cast<size_t>(head) & (m_capacity - 1);
+    const size_t toEnd = m_capacity - offset;
+    const size_t needed = length > toEnd ? length + toEnd : length;
+    if (m_capacity - static_cast<size_t>(head - tail) < needed) {
+        __atomic_fetch_add(&m_dropped, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    if (length > toEnd) {
+        Record *padding = reinterpret_cast<Record*>(m_buffer + offset);
+        padding->length = static_cast<uint32_t>(toEnd);
+        padding->kind = Record::PADDING;
+        m_reservedHead = head + needed;
+        return m_buffer;
+    }
+    m_reservedHead = head + length;
+    return m_buffer + offset;
+}
+
+void LogRing::publish() {
+    __atomic_store_n(&m_head, m_reservedHead, __ATOMIC_RELEASE);
+}
+
+/**
+ * Find all the free space that directly follows the head, or that
+ * follows the padding out of the end of the buffer if wrap is set.  room
+ * is set to its length, which may be 0.  Nothing becomes visible to
+ * drain() until publish(); m_reservedHead is left at the start of the
+ * space, for the caller to move past the record it writes there.
+ */
+char *LogRing::reserveFree(bool wrap, size_t &room) {
+    const uint64_t head = m_head;
+    const uint64_t tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+    const size_t offset = static_cast<size_t>(head) & (m_capacity - 1);
+    const size_t toEnd = m_capacity - offset;
+    const size_t free = m_capacity - static_cast<size_t>(head - tail);
+    if (!wrap) {
+        room = free < toEnd ? free : toEnd;
+        m_reservedHead = head;
+        return m_buffer + offset;
+    }
+    if (free <= toEnd) {
+        room = 0;
+        return NULL;
+    }
+    Record *padding = reinterpret_cast<Record*>(m_buffer + offset);
+    padding->length = static_cast<uint32_t>(toEnd);
+    padding->kind = Record::PADDING;
+    room = free - toEnd;
+    m_reservedHead = head + toEnd;
+    return m_buffer;
+}
+
+/** Longest statement kept, leaving room for a few more records even after a huge one */
+size_t LogRing::maxTextLength() const {
+    return m_capacity / 4 - sizeof(Record) - 1;
+}
+
+/**
+ * Fill in the header of a TEXT record for a statement of textLength
+ * characters at space, and terminate the statement.
+ */
+void LogRing::writeText(char *space, LoggerId loggerId, LogLevel level, size_t textLength) {
+    const size_t length = align(sizeof(Record) + textLength + 1);
+    Record *record = reinterpret_cast<Record*>(space);
+    record->length = static_cast<uint32_t>(length);
+    record->kind = Record::TEXT;
+    record->loggerId = static_cast<uint8_t>(loggerId);
+    record->level = static_cast<uint8_t>(level);
+    space[sizeof(Record) + textLength] = '\0';
+}
+
+/**
+ * Reserve a TEXT record for a statement of textLength characters, which
+ * is cut down if the statement is too long, and return where its text goes.
+ */
+char *LogRing::reserveText(LoggerId loggerId, LogLevel level, size_t &textLength) {
+    if (textLength > maxTextLength()) {
+        textLength = maxTextLength();
+    }
+    char *space = reserve(align(sizeof(Record) + textLength + 1));
+    if (space == NULL) {
+        return NULL;
+    }
+    writeText(space, loggerId, level, textLength);
+    return space + sizeof(Record);
+}
+
+bool LogRing::append(LoggerId loggerId, LogLevel level, const char *statement) {
+    size_t textLength = ::strlen(statement);
+    char *text = reserveText(loggerId, level, textLength);
+    if (text == NULL) {
+        return false;
+    }
+    ::memcpy(text, statement, textLength);
+    publish();
+    return true;
+}
+
+/**
+ * Format the statement once, straight into the free space at the head,
+ * and keep only as much of it as was written.  A statement that does not
+ * fit before the end of the buffer is formatted a second time, at its
+ * start.
+ */
+bool LogRing::appendFormat(LoggerId loggerId, LogLevel level, const char *format, va_list arguments) {
+    for (int wrap = 0; wrap < 2; ++wrap) {
+        size_t room = 0;
+        char *space = reserveFree(wrap != 0, room);
+        if (room <= sizeof(Record)) {
+            continue;
+        }
+        size_t textRoom = room - sizeof(Record);
+        if (textRoom > maxTextLength() + 1) {
+            textRoom = maxTextLength() + 1;
+        }
+        va_list formatArguments;
+        va_copy(formatArguments, arguments);
+        const int formattedLength = ::vsnprintf(space + sizeof(Record), textRoom, format, formatArguments);
+        va_end(formatArguments);
+        if (formattedLength < 0) {
+            return false;
+        }
+        size_t textLength = static_cast<size_t>(formattedLength);
+        if (textLength >= textRoom) {
+            if (textRoom <= maxTextLength()) {
+                // Out of room rather than too long
+                continue;
+            }
+            textLength = maxTextLength();
+        }
+        writeText(space, loggerId, level, textLength);
+        m_reservedHead += align(sizeof(Record) + textLength + 1);
+        publish();
+        return true;
+    }
+    __atomic_fetch_add(&m_dropped, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+size_t LogRing::drain(const LogProxy *proxy) {
+    size_t forwarded = 0;
+    uint64_t tail = m_tail;
+    const uint64_t head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+    while (tail != head) {
+        const char *space = m_buffer + (static_cast<size_t>(tail) & (m_capacity - 1));
+        const Record *record = reinterpret_cast<const Record*>(space);
+        const LoggerId loggerId = static_cast<LoggerId>(record->loggerId);
+        const LogLevel level = static_cast<LogLevel>(record->level);
+        if (record->kind == Record::TEXT) {
+            proxy->log(loggerId, level, space + sizeof(Record));
+            ++forwarded;
+        }
+        tail += record->length;
+        __atomic_store_n(&m_tail, tail, __ATOMIC_RELEASE);
+    }
+
+    const uint64_t dropped = droppedCount();
+    if (dropped != m_reportedDrops) {
+        char warning[MAX_WARNING_LENGTH];
+        ::snprintf(warning, sizeof(warning),
+                   "%ju log statements were dropped because the EE log ring was full",
+                   static_cast<uintmax_t>(dropped - m_reportedDrops));
+        proxy->log(LOGGERID_HOST, LOGLEVEL_WARN, warning);
+        m_reportedDrops = dropped;
+    }
+    return forwarded;
+}
+
+}
@@ -0,0 +1,97 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOGRING_H_
+#define LOGRING_H_
+#include "LogDefs.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace voltdb {
+
+class LogProxy;
+
+/**
+ * A bounded ring of binary log records written by one site thread and
+ * drained later to a LogProxy by that same thread, on tick, ahead of a
+ * synchronous statement or before crashing.  Appending never blocks and
+ * never calls out of the EE; a record that does not fit is dropped and
+ * counted, and the next drain reports how many were lost.
+ *
+ * A record only becomes visible once it is complete, so a drain that
+ * interrupts an append (from the SIGSEGV handler) skips that record.
+ */
+class LogRing {
+public:
+    static const size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    /** capacity is rounded up to a power of two */
+    explicit LogRing(size_t capacity = DEFAULT_CAPACITY);
+    ~LogRing();
+
+    /**
+     * Copy a statement into the ring, truncating very long ones.
+     * Returns false if it was dropped.
+     */
+    bool append(LoggerId loggerId, LogLevel level, const char *statement);
+
+    /**
+     * Format a statement straight into the ring, truncating very long
+     * ones.  Statements are formatted once, except those that have to
+     * wrap around the end of the buffer.  Returns false if it was dropped.
+     */
+    bool appendFormat(LoggerId loggerId, LogLevel level, const char *format, va_list arguments);
+
+    /**
+     * Forward all queued records to proxy, followed by a warning if
+     * records were dropped since the last drain.  Returns the number of
+     * records forwarded.
+     */
+    size_t drain(const LogProxy *proxy);
+
+    bool isEmpty() const;
+
+    /** Records dropped since the ring was created */
+    uint64_t droppedCount() const;
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    struct Record;
+
+    char *reserve(size_t length);
+    char *reserveFree(bool wrap, size_t &room);
+    size_t maxTextLength() const;
+    void writeText(char *space, LoggerId loggerId, LogLevel level, size_t textLength);
+    char *reserveText(LoggerId loggerId, LogLevel level, size_t &textLength);
+    void publish();
+
+    char *m_buffer;
+    size_t m_capacity;
+
+    // Written by append
+    uint64_t m_head;
+    uint64_t m_reservedHead;
+    uint64_t m_dropped;
+    // Written by drain
+    uint64_t m_tail;
+    uint64_t m_reportedDrops;
+};
+
+}
+#endif /* LOGRING_H_ */
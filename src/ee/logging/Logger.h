@@ -19,8 +19,12 @@
 #define LOGGER_H_
 #include "LogDefs.h"
 #include "LogProxy.h"
+#include "LogRing.h"
 #include <string>
 #include <cassert>
+#include <cstdio>
+#include <stdarg.h>
+#include <stdint.h>
 
 namespace voltdb {
 
@@ -36,7 +40,7 @@ public:
      * will be forwarded to.
      * @param proxy Log proxy where log statements should be forwarded to
      */
-    inline Logger(LogProxy *proxy, LoggerId id) : m_level(LOGLEVEL_OFF), m_id(id), m_logProxy(proxy) {}
+    inline Logger(LogProxy *proxy, LoggerId id) : m_level(LOGLEVEL_OFF), m_id(id), m_logProxy(proxy), m_ring(NULL) {}
 
     /**
      * Check if a specific log level is loggable
@@ -55,9 +59,7 @@ public:
      */
     inline void log(const voltdb::LogLevel level, const std::string *statement) const {
         assert(level != voltdb::LOGLEVEL_OFF && level != voltdb::LOGLEVEL_ALL); //: "Should never log as ALL or OFF";
-        if (level >= m_level && m_logProxy != NULL) {
-            m_logProxy->log( m_id, level, statement->c_str());
-        }
+        log(level, statement->c_str());
     }
 
     /**
@@ -68,11 +70,38 @@ public:
     inline void log(const voltdb::LogLevel level, const char *statement) const {
         assert (level != voltdb::LOGLEVEL_OFF && level != voltdb::LOGLEVEL_ALL); //: "Should never log as ALL or OFF";
         if (level >= m_level && m_logProxy != NULL) {
+            if (m_ring != NULL && level < LOGLEVEL_INFO) {
+                m_ring->append(m_id, level, statement);
+                return;
+            }
+            flushRing();
             m_logProxy->log( m_id, level, statement);
         }
     }
 
+    /**
+     * Log a printf style statement.  It is only formatted once the level
+     * turns out to be loggable, and then straight into the log ring if the
+     * statement is buffered, so statements below the level cost nothing
+     * but the check.
+     * @param level Log level to attempt to log the statement at
+     * @param format printf format of the statement
+     */
+    inline void logFormat(const voltdb::LogLevel level, const char *format, ...) const
+        __attribute__((format(printf, 3, 4)));
+
 private:
+    /**
+     * Keep statements in order: buffered debug output goes out ahead
+     * of anything logged synchronously.  This runs on the site thread,
+     * which owns the ring and is the only one to drain it.
+     */
+    inline void flushRing() const {
+        if (m_ring != NULL && !m_ring->isEmpty()) {
+            m_ring->drain(m_logProxy);
+        }
+    }
+
     /**
      * Currently active log level containing a cached value of the log level of some logger elsewhere
      */
@@ -83,7 +112,31 @@ private:
      * LogProxy that log statements will be forwarded to.
      */
     const LogProxy *m_logProxy;
+
+    /**
+     * Buffer for TRACE and DEBUG statements, owned by the LogManager; NULL to log them synchronously.
+     */
+    LogRing *m_ring;
 };
 
+inline void Logger::logFormat(const voltdb::LogLevel level, const char *format, ...) const {
+    assert (level != voltdb::LOGLEVEL_OFF && level != voltdb::LOGLEVEL_ALL); //: "Should never log as ALL or OFF";
+    if (level < m_level || m_logProxy == NULL) {
+        return;
+    }
+    va_list arguments;
+    va_start(arguments, format);
+    if (m_ring != NULL && level < LOGLEVEL_INFO) {
+        m_ring->appendFormat(m_id, level, format, arguments);
+    }
+    else {
+        flushRing();
+        char statement[1024];
+        ::vsnprintf(statement, sizeof(statement), format, arguments);
+        m_logProxy->log( m_id, level, statement);
+    }
+    va_end(arguments);
+}
+
 }
 #endif /* LOGGER_H_ */
@@ -50,6 +50,7 @@
 #include <boost/foreach.hpp>
 
 #include "common/FatalException.hpp"
+#include "expressions/expressionoptimizer.h"
 #include "plannodefragment.h"
 #include "catalog/catalog.h"
 #include "abstractplannode.h"
@@ -124,6 +125,8 @@ PlanNodeFragment::fromJSONObject(PlannerDomValue obj)
 {
     PlanNodeFragment *retval = new PlanNodeFragment();
     auto_ptr<PlanNodeFragment> pnf(retval);
+    // fold, memoize and share the expressions of the whole fragment
+    ExpressionOptimizer optimizer(obj);
     // read and construct plannodes from json object
     if (obj.hasNonNullKey("PLAN_NODES_LISTS")) {
         PlannerDomValue planNodesListArray = obj.valueForKey("PLAN_NODES_LISTS");
@@ -20,6 +20,7 @@
 #include "common/ids.h"
 #include "common/tabletuple.h"
 #include "common/TupleSchema.h"
+#include "executors/PlanNodeStats.h"
 #include "indexes/IndexStats.h"
 #include "storage/TableStats.h"
 #include "storage/temptable.h"
@@ -43,6 +44,8 @@ namespace
             return TableStats::generateEmptyTableStatsTable();
         case STATISTICS_SELECTOR_TYPE_INDEX:
             return IndexStats::generateEmptyIndexStatsTable();
+        case STATISTICS_SELECTOR_TYPE_PLAN_NODE:
+            return PlanNodeStats::generateEmptyPlanNodeStatsTable();
         default:
             throwFatalException("Attempted to get unsupported stats type");
         }
@@ -76,6 +79,27 @@ void StatsAgent::unregisterStatsSource(StatisticsSelectorType sst) {
     it1->second.clear();
 }
 
+void StatsAgent::unregisterStatsSource(StatisticsSelectorType sst,
+                                       CatalogId catalogId,
+                                       StatsSource* statsSource) {
+    map<StatisticsSelectorType,
+      multimap<CatalogId, StatsSource*> >::iterator it1 =
+      m_statsCategoryByStatsSelector.find(sst);
+
+    if (it1 == m_statsCategoryByStatsSelector.end()) {
+        return;
+    }
+    multimap<CatalogId, StatsSource*>::iterator iter;
+    for (iter = it1->second.find(catalogId);
+         (iter != it1->second.end()) && (iter->first == catalogId);
+         iter++) {
+        if (iter->second == statsSource) {
+            it1->second.erase(iter);
+            return;
+        }
+    }
+}
+
 /**
  * Get statistics for the specified resources
  * @param sst StatisticsSelectorType of the resources
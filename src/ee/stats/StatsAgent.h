@@ -52,6 +52,12 @@ public:
      */
     void unregisterStatsSource(voltdb::StatisticsSelectorType sst);
 
+    /**
+     * Unassociate the specified StatsSource from the specified CatalogId under the specified StatsSelector
+     */
+    void unregisterStatsSource(voltdb::StatisticsSelectorType sst, voltdb::CatalogId catalogId,
+                               voltdb::StatsSource* statsSource);
+
     /**
      * Get statistics for the specified resources
      * @param sst StatisticsSelectorType of the resources
@@ -22,7 +22,7 @@ using namespace std;
 using namespace voltdb;
 
 AbstractDRTupleStream::AbstractDRTupleStream(int partitionId, int defaultBufferSize)
-        : TupleStreamBase(defaultBufferSize, MAGIC_DR_TRANSACTION_PADDING),
+        : TupleStreamBase(defaultBufferSize, MAGIC_DR_TRANSACTION_PADDING, true),
           m_enabled(true),
           m_guarded(false),
           m_openSequenceNumber(-1),
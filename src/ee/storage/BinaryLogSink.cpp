@@ -16,6 +16,7 @@
  */
 
 #include "BinaryLogSink.h"
+#include "BinaryLogSinkUndoAction.h"
 
 #include "ConstraintFailureException.h"
 #include "persistenttable.h"
@@ -27,6 +28,7 @@
 #include "common/Pool.hpp"
 #include "common/tabletuple.h"
 #include "common/types.h"
+#include "common/UndoQuantum.h"
 #include "common/ValueFactory.hpp"
 #include "common/UniqueId.hpp"
 #include "indexes/tableindex.h"
@@ -507,8 +509,18 @@ int64_t BinaryLogSink::applyTxn(ReferenceSerializeInputLE *taskInfo,
 
     DRTxnPartitionHashFlag hashFlag = static_cast<DRTxnPartitionHashFlag>(taskInfo->readByte());
     isMultiHash = (hashFlag == TXN_PAR_HASH_MULTI || hashFlag == TXN_PAR_HASH_SPECIAL);
-    taskInfo->readInt();  // txnLength
+    int32_t txnLength = taskInfo->readInt();
     partitionHash = taskInfo->readInt();
+
+    if (hashFlag == TXN_PAR_HASH_REPLICATED &&
+        !advanceReplicatedSequenceNumber(remoteClusterId, sequenceNumber)) {
+        // Already applied on this site, skip to the checksum at the end of the txn
+        taskInfo->getRawPointer((txnStart + txnLength - 4) - taskInfo->getRawPointer());
+        uint32_t checksum = taskInfo->readInt();
+        validateChecksum(checksum, txnStart, taskInfo->getRawPointer());
+        return 0;
+    }
+
     if (isMultiHash) {
         skipWrongHashRows = !engine->isLocalSite(partitionHash);
     }
@@ -760,4 +772,30 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
     return static_cast<int64_t>(rowCostForDRRecord(type));
 }
 
+int64_t BinaryLogSink::lastAppliedReplicatedSequenceNumber(int32_t remoteClusterId) const {
+    boost::unordered_map<int32_t, int64_t>::const_iterator it = m_replicatedSequenceNumbers.find(remoteClusterId);
+    return it == m_replicatedSequenceNumbers.end() ? -1 : it->second;
+}
+
+void BinaryLogSink::setReplicatedSequenceNumbers(const boost::unordered_map<int32_t, int64_t> &sequenceNumbers) {
+    m_replicatedSequenceNumbers = sequenceNumbers;
+}
+
+bool BinaryLogSink::advanceReplicatedSequenceNumber(int32_t remoteClusterId, int64_t sequenceNumber) {
+    int64_t lastSequenceNumber = lastAppliedReplicatedSequenceNumber(remoteClusterId);
+    // DR events such as CATALOG_UPDATE take sequence numbers without being
+    // applied as txns, so only the order is checked, gaps are expected.
+    if (lastSequenceNumber >= 0 && sequenceNumber <= lastSequenceNumber) {
+        return false;
+    }
+
+    m_replicatedSequenceNumbers[remoteClusterId] = sequenceNumber;
+    UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
+    if (uq) {
+        uq->registerUndoAction(new (*uq) BinaryLogSinkUndoAction(m_replicatedSequenceNumbers,
+                                                                 remoteClusterId, lastSequenceNumber));
+    }
+    return true;
+}
+
 }
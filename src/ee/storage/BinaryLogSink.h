@@ -40,11 +40,41 @@ public:
                      Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
                      const char *txnStart);
 
+    /**
+     * The sequence number of the last replicated stream txn from the
+     * given remote cluster that was applied here, or -1 if there is none.
+     * Replicated stream txns must be applied in increasing sequence
+     * order: a txn at or below this number was already applied and is
+     * skipped.  Gaps are allowed, DR events consume sequence numbers too.
+     * This barrier lets every site apply its own copy of the replicated
+     * tables independently while still applying them in the same order.
+     * Only this EE side exists so far: the DR consumer still applies the
+     * replicated stream with @ApplyBinaryLogMP, one MP txn per buffer, and
+     * the barrier then only skips redelivered txns.
+     */
+    int64_t lastAppliedReplicatedSequenceNumber(int32_t remoteClusterId) const;
+
+    /**
+     * Replace the barrier for every remote cluster, e.g. with the state of
+     * the consumer's applied DR id trackers after a restore or rejoin.
+     */
+    void setReplicatedSequenceNumbers(const boost::unordered_map<int32_t, int64_t> &sequenceNumbers);
+
 private:
     int64_t apply(ReferenceSerializeInputLE *taskInfo, const DRRecordType type,
                   boost::unordered_map<int64_t, PersistentTable*> &tables,
                   Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
                   const char *txnStart, int64_t sequenceNumber, int64_t uniqueId, bool skipRow);
+
+    /**
+     * Check a replicated stream txn against the ordering barrier.  Returns
+     * false if the txn was already applied, otherwise records it as the
+     * last applied txn, undoably, and returns true.
+     */
+    bool advanceReplicatedSequenceNumber(int32_t remoteClusterId, int64_t sequenceNumber);
+
+    // Remote cluster id -> last applied replicated stream sequence number
+    boost::unordered_map<int32_t, int64_t> m_replicatedSequenceNumbers;
 };
 
 
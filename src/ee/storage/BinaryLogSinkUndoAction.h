@@ -0,0 +1,60 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BINARYLOGSINKUNDOACTION_H
+#define BINARYLOGSINKUNDOACTION_H
+
+#include "common/UndoAction.h"
+
+#include <boost/unordered_map.hpp>
+
+namespace voltdb {
+
+/*
+ * Restores the replicated stream sequence number a BinaryLogSink last
+ * applied for a remote cluster when the txn that advanced it rolls back.
+ */
+class BinaryLogSinkUndoAction : public voltdb::UndoAction {
+public:
+    BinaryLogSinkUndoAction(boost::unordered_map<int32_t, int64_t> &sequenceNumbers,
+                            int32_t remoteClusterId, int64_t previousSequenceNumber)
+        : m_sequenceNumbers(sequenceNumbers), m_remoteClusterId(remoteClusterId),
+          m_previousSequenceNumber(previousSequenceNumber)
+    {
+    }
+
+    void undo() {
+        if (m_previousSequenceNumber < 0) {
+            m_sequenceNumbers.erase(m_remoteClusterId);
+        }
+        else {
+            m_sequenceNumbers[m_remoteClusterId] = m_previousSequenceNumber;
+        }
+    }
+
+    void release() {
+    }
+
+private:
+    boost::unordered_map<int32_t, int64_t> &m_sequenceNumbers;
+    int32_t m_remoteClusterId;
+    int64_t m_previousSequenceNumber;
+};
+
+}
+
+#endif
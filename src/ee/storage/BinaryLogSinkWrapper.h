@@ -38,6 +38,14 @@ public:
 
     int64_t apply(const char* taskParams, boost::unordered_map<int64_t, PersistentTable*> &tables,
                   Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId);
+
+    int64_t lastAppliedReplicatedSequenceNumber(int32_t remoteClusterId) const {
+        return m_sink.lastAppliedReplicatedSequenceNumber(remoteClusterId);
+    }
+
+    void setReplicatedSequenceNumbers(const boost::unordered_map<int32_t, int64_t> &sequenceNumbers) {
+        m_sink.setReplicatedSequenceNumbers(sequenceNumbers);
+    }
 private:
     BinaryLogSink m_sink;
     CompatibleBinaryLogSink m_compatibleSink;
@@ -22,6 +22,7 @@
 #include "common/FixUnusedAssertHack.h"
 #include "expressions/hashrangeexpression.h"
 #include "logging/LogManager.h"
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <limits>
@@ -37,7 +38,10 @@ ElasticContext::ElasticContext(PersistentTable &table,
     TableStreamerContext(table, surgeon, partitionId, serializer, predicateStrings),
     m_predicateStrings(predicateStrings), // retained for cloning here, not in TableStreamerContext.
     m_nTuplesPerCall(nTuplesPerCall),
-    m_indexActive(false)
+    m_indexActive(false),
+    m_hasMergedKey(false),
+    m_replayedChanges(0),
+    m_changesAtLastCall(0)
 {
     if (predicateStrings.size() != 1) {
         throwFatalException("ElasticContext::ElasticContext() expects a single predicate.");
@@ -103,6 +107,7 @@ ElasticContext::handleActivation(TableStreamType streamType)
             return ACTIVATION_SUCCEEDED;
         }
         m_surgeon.createIndex();
+        clearBuild();
         m_scanner.reset(new ElasticScanner(getTable(), m_surgeon.getData()));
         m_indexActive = true;
         return ACTIVATION_SUCCEEDED;
@@ -111,7 +116,8 @@ ElasticContext::handleActivation(TableStreamType streamType)
     // Clear the index?
     if (streamType == TABLE_STREAM_ELASTIC_INDEX_CLEAR) {
         if (m_surgeon.hasIndex()) {
-            if (!m_surgeon.isIndexEmpty()) {
+            if (!m_surgeon.isIndexEmpty() || m_surgeon.isIndexBulkLoading() ||
+                !m_runs.empty() || !m_pendingChanges.empty()) {
 
                 std::ostringstream os;
                 os << "Elastic index clear is not allowed while an index is "
@@ -137,6 +143,7 @@ ElasticContext::handleActivation(TableStreamType streamType)
             //compare against the old predicate
             m_predicates.clear();
             m_surgeon.dropIndex();
+            clearBuild();
             m_scanner.reset();
             m_indexActive = false;
         }
@@ -183,26 +190,41 @@ int64_t ElasticContext::handleStreamMore(TupleOutputStreamProcessor &outputStrea
         return 0;
     }
 
-    // Populate index with current tuples.
-    // Table changes are tracked through notifications.
-    size_t i = 0;
-    TableTuple tuple(getTable().schema());
-    while (m_scanner->next(tuple)) {
-        if (getPredicates()[0].eval(&tuple).isTrue()) {
-            m_surgeon.indexAdd(tuple);
+    // The build runs in three phases, each doing a bounded chunk of work per
+    // call so that no call grows with the size of the table:
+    // 1) Scan a chunk of the tuples and sort their keys into a run.
+    //    Table changes are tracked through notifications.
+    // 2) Once the scan is complete, merge the runs into the index in key order.
+    // 3) Replay the changes made in the meantime on the loaded index.
+    if (!m_scanner->isScanComplete()) {
+        std::vector<ElasticIndexKey> keys;
+        size_t i = 0;
+        TableTuple tuple(getTable().schema());
+        while (m_scanner->next(tuple)) {
+            if (getPredicates()[0].eval(&tuple).isTrue()) {
+                keys.push_back(ElasticIndexKey(m_surgeon.generateTupleHash(tuple), tuple.address()));
+            }
+            // Take a breather after every chunk of m_nTuplesPerCall tuples.
+            if (++i == m_nTuplesPerCall) {
+                break;
+            }
         }
-        // Take a breather after every chunk of m_nTuplesPerCall tuples.
-        if (++i == m_nTuplesPerCall) {
-            break;
+        addRun(keys);
+        if (m_scanner->isScanComplete()) {
+            m_surgeon.indexStartBulkLoad();
         }
+        m_changesAtLastCall = m_pendingChanges.size();
+        return 1;
     }
 
-    // Done with indexing?
-    bool indexingComplete = m_scanner->isScanComplete();
-    if (indexingComplete) {
-        m_surgeon.setIndexingComplete();
+    if ((m_surgeon.isIndexBulkLoading() && !mergeRuns()) || !replayPendingChanges()) {
+        m_changesAtLastCall = m_pendingChanges.size();
+        return 1;
     }
-    return indexingComplete ? 0 : 1;
+
+    clearBuild();
+    m_surgeon.setIndexingComplete();
+    return 0;
 }
 
 /**
@@ -214,7 +236,12 @@ bool ElasticContext::notifyTupleInsert(TableTuple &tuple)
         StreamPredicateList &predicates = getPredicates();
         assert(predicates.size() > 0);
         if (predicates[0].eval(&tuple).isTrue()) {
-            m_surgeon.indexAdd(tuple);
+            if (isBuilding()) {
+                addPendingChange(ElasticIndexKey(m_surgeon.generateTupleHash(tuple), tuple.address()), true);
+            }
+            else {
+                m_surgeon.indexAdd(tuple);
+            }
         }
     }
     return true;
@@ -234,7 +261,10 @@ bool ElasticContext::notifyTupleUpdate(TableTuple &tuple)
 bool ElasticContext::notifyTupleDelete(TableTuple &tuple)
 {
     if (m_indexActive) {
-        if (m_surgeon.indexHas(tuple)) {
+        if (isBuilding()) {
+            addPendingChange(ElasticIndexKey(m_surgeon.generateTupleHash(tuple), tuple.address()), false);
+        }
+        else if (m_surgeon.indexHas(tuple)) {
             m_surgeon.indexRemove(tuple);
         }
     }
@@ -252,6 +282,13 @@ void ElasticContext::notifyTupleMovement(TBPtr sourceBlock,
     if (m_indexActive) {
         StreamPredicateList &predicates = getPredicates();
         assert(predicates.size() > 0);
+        if (isBuilding()) {
+            addPendingChange(ElasticIndexKey(m_surgeon.generateTupleHash(sourceTuple), sourceTuple.address()), false);
+            if (predicates[0].eval(&targetTuple).isTrue()) {
+                addPendingChange(ElasticIndexKey(m_surgeon.generateTupleHash(targetTuple), targetTuple.address()), true);
+            }
+            return;
+        }
         if (m_surgeon.indexHas(sourceTuple)) {
             m_surgeon.indexRemove(sourceTuple);
         }
@@ -261,6 +298,113 @@ void ElasticContext::notifyTupleMovement(TBPtr sourceBlock,
     }
 }
 
+bool ElasticContext::isBuilding()
+{
+    return m_surgeon.hasIndex() && !m_surgeon.isIndexingComplete();
+}
+
+void ElasticContext::addPendingChange(const ElasticIndexKey &key, bool add)
+{
+    m_pendingChanges.push_back(std::make_pair(key, add));
+}
+
+namespace {
+
+/**
+ * Orders the merge heap so that the smallest key is on top.
+ */
+struct RunHeadGreater {
+    bool operator()(const std::pair<ElasticIndexKey, size_t> &a,
+                    const std::pair<ElasticIndexKey, size_t> &b) const
+    {
+        return ElasticIndexComparator()(b.first, a.first);
+    }
+};
+
+}
+
+void ElasticContext::addRun(std::vector<ElasticIndexKey> &keys)
+{
+    if (keys.empty()) {
+        return;
+    }
+    ElasticIndex::sortKeys(keys);
+    m_runs.push_back(std::vector<ElasticIndexKey>());
+    m_runs.back().swap(keys);
+    m_runPositions.push_back(0);
+    m_mergeHeap.push_back(std::make_pair(m_runs.back().front(), m_runs.size() - 1));
+    std::push_heap(m_mergeHeap.begin(), m_mergeHeap.end(), RunHeadGreater());
+}
+
+/**
+ * K-way merge of the runs into the bulk load, m_nTuplesPerCall keys per call.
+ */
+bool ElasticContext::mergeRuns()
+{
+    for (size_t i = 0; i < m_nTuplesPerCall && !m_mergeHeap.empty(); ++i) {
+        std::pop_heap(m_mergeHeap.begin(), m_mergeHeap.end(), RunHeadGreater());
+        std::pair<ElasticIndexKey, size_t> &head = m_mergeHeap.back();
+        if (!m_hasMergedKey || !(head.first == m_lastMergedKey)) {
+            m_surgeon.indexBulkAppend(head.first);
+            m_lastMergedKey = head.first;
+            m_hasMergedKey = true;
+        }
+
+        const size_t run = head.second;
+        if (++m_runPositions[run] < m_runs[run].size()) {
+            head.first = m_runs[run][m_runPositions[run]];
+            std::push_heap(m_mergeHeap.begin(), m_mergeHeap.end(), RunHeadGreater());
+        }
+        else {
+            m_mergeHeap.pop_back();
+            std::vector<ElasticIndexKey>().swap(m_runs[run]);
+        }
+    }
+    if (!m_mergeHeap.empty()) {
+        return false;
+    }
+    m_surgeon.indexFinishBulkLoad();
+    std::vector<std::vector<ElasticIndexKey> >().swap(m_runs);
+    std::vector<size_t>().swap(m_runPositions);
+    return true;
+}
+
+/**
+ * Replay the inserts, deletes and moves made while the index was built.
+ * A scanned key that was removed before the scan reached it belongs to a
+ * tuple inserted after the removal, and that insert is replayed after it, so
+ * replaying the changes in order on top of the scanned keys yields the
+ * table's current keys. Each call replays the changes notified since the
+ * previous call plus a chunk of the backlog, so the replay always catches up.
+ */
+bool ElasticContext::replayPendingChanges()
+{
+    const size_t limit = std::min(m_pendingChanges.size(),
+            m_replayedChanges + m_nTuplesPerCall + (m_pendingChanges.size() - m_changesAtLastCall));
+    for (; m_replayedChanges < limit; ++m_replayedChanges) {
+        const std::pair<ElasticIndexKey, bool> &change = m_pendingChanges[m_replayedChanges];
+        if (change.second) {
+            m_surgeon.indexAdd(change.first);
+        }
+        else {
+            m_surgeon.indexRemove(change.first);
+        }
+    }
+    return m_replayedChanges == m_pendingChanges.size();
+}
+
+void ElasticContext::clearBuild()
+{
+    // Give the memory back, the buffers are as large as the table.
+    std::vector<std::vector<ElasticIndexKey> >().swap(m_runs);
+    std::vector<std::pair<ElasticIndexKey, size_t> >().swap(m_mergeHeap);
+    std::vector<size_t>().swap(m_runPositions);
+    m_hasMergedKey = false;
+    std::vector<std::pair<ElasticIndexKey, bool> >().swap(m_pendingChanges);
+    m_replayedChanges = 0;
+    m_changesAtLastCall = 0;
+}
+
 /**
  * Parse and save predicates.
  */
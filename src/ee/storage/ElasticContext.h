@@ -19,7 +19,9 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 #include <boost/scoped_ptr.hpp>
+#include "storage/ElasticIndex.h"
 #include "storage/ElasticScanner.h"
 #include "storage/TableStreamerContext.h"
 #include "storage/TupleBlock.h"
@@ -139,6 +141,74 @@ private:
      */
     bool m_indexActive;
 
+    /**
+     * True while the initial scan is running and the index is still empty.
+     */
+    bool isBuilding();
+
+    /**
+     * Record a change to the table made while the index is being built.
+     */
+    void addPendingChange(const ElasticIndexKey &key, bool add);
+
+    /**
+     * Sort the keys of one scanned chunk and keep them as a run to merge.
+     */
+    void addRun(std::vector<ElasticIndexKey> &keys);
+
+    /**
+     * Merge the next m_nTuplesPerCall keys of the runs into the index's bulk
+     * load. Return true once every run is merged and the load is finished.
+     */
+    bool mergeRuns();
+
+    /**
+     * Replay the next chunk of the changes made while the index was built.
+     * Return true once every change was replayed.
+     */
+    bool replayPendingChanges();
+
+    /**
+     * Release the keys and changes buffered by the build.
+     */
+    void clearBuild();
+
+    /**
+     * The sorted keys of each chunk of the scan. Once the scan completes they
+     * are merged into the index a chunk per call, and each run is released
+     * as soon as it is consumed.
+     */
+    std::vector<std::vector<ElasticIndexKey> > m_runs;
+
+    /**
+     * Min-heap of the next key to merge from each run and the run's index.
+     */
+    std::vector<std::pair<ElasticIndexKey, size_t> > m_mergeHeap;
+
+    /**
+     * Position of the next key to merge in each run.
+     */
+    std::vector<size_t> m_runPositions;
+
+    /**
+     * The last key merged, so a key scanned twice is loaded once.
+     */
+    ElasticIndexKey m_lastMergedKey;
+    bool m_hasMergedKey;
+
+    /**
+     * Inserts (true) and removes (false) notified while the index is built,
+     * in the order they happened. They are replayed on the bulk loaded index.
+     */
+    std::vector<std::pair<ElasticIndexKey, bool> > m_pendingChanges;
+
+    /**
+     * Number of pending changes replayed so far, and the number that had
+     * been notified when the last call returned.
+     */
+    size_t m_replayedChanges;
+    size_t m_changesAtLastCall;
+
     static const size_t DEFAULT_TUPLES_PER_CALL = 10000;
 };
 
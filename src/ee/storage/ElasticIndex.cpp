@@ -18,6 +18,8 @@
 #include "ElasticIndex.h"
 #include "persistenttable.h"
 
+#include <algorithm>
+
 namespace voltdb
 {
 
@@ -29,6 +31,99 @@ ElasticHash ElasticIndex::generateHash(const PersistentTable &table, const Table
     return tuple.getNValue(table.partitionColumn()).murmurHash3();
 }
 
+/**
+ * Add a batch of keys. An empty index is bulk loaded from the sorted, de-duplicated
+ * batch. Otherwise the keys are inserted in sorted order so consecutive inserts
+ * land in the same leaf.
+ */
+size_t ElasticIndex::add(std::vector<ElasticIndexKey> &keys)
+{
+    sortKeys(keys);
+    if (empty()) {
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        bulk_load(keys.begin(), keys.end());
+        return keys.size();
+    }
+    size_t added = 0;
+    for (std::vector<ElasticIndexKey>::const_iterator iter = keys.begin(); iter != keys.end(); ++iter) {
+        if (insert(*iter).second) {
+            ++added;
+        }
+    }
+    return added;
+}
+
+void ElasticIndex::startBulkLoad()
+{
+    assert(empty() && m_builder.get() == NULL);
+    m_builder.reset(new_bulk_builder());
+}
+
+void ElasticIndex::bulkAppend(const ElasticIndexKey &key)
+{
+    assert(m_builder.get() != NULL);
+    m_builder->append(key);
+}
+
+size_t ElasticIndex::finishBulkLoad()
+{
+    assert(m_builder.get() != NULL);
+    m_builder->finish();
+    m_builder.reset();
+    return size();
+}
+
+bool ElasticIndex::isBulkLoading() const
+{
+    return m_builder.get() != NULL;
+}
+
+/**
+ * Sort keys by (hash, address). Small batches go through std::sort. Larger
+ * ones get a stable 4 pass LSD radix sort on the sign flipped hash followed by
+ * a fix-up of the (rare) runs of equal hashes by tuple address.
+ */
+void ElasticIndex::sortKeys(std::vector<ElasticIndexKey> &keys)
+{
+    const size_t count = keys.size();
+    if (count < RADIX_SORT_THRESHOLD) {
+        std::sort(keys.begin(), keys.end(), ElasticIndexComparator());
+        return;
+    }
+
+    std::vector<ElasticIndexKey> scratch(count);
+    ElasticIndexKey *from = &keys[0];
+    ElasticIndexKey *to = &scratch[0];
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t offsets[256] = { 0 };
+        for (size_t ii = 0; ii < count; ii++) {
+            ++offsets[radixDigit(from[ii], shift)];
+        }
+        size_t total = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            size_t digitCount = offsets[digit];
+            offsets[digit] = total;
+            total += digitCount;
+        }
+        for (size_t ii = 0; ii < count; ii++) {
+            to[offsets[radixDigit(from[ii], shift)]++] = from[ii];
+        }
+        std::swap(from, to);
+    }
+    // An even number of passes leaves the result back in keys.
+    assert(from == &keys[0]);
+
+    size_t runStart = 0;
+    for (size_t ii = 1; ii <= count; ii++) {
+        if (ii == count || keys[ii].getHash() != keys[runStart].getHash()) {
+            if (ii - runStart > 1) {
+                std::sort(keys.begin() + runStart, keys.begin() + ii, ElasticIndexComparator());
+            }
+            runStart = ii;
+        }
+    }
+}
+
 ElasticIndexTupleRangeIterator::ElasticIndexTupleRangeIterator(
         ElasticIndex &index,
         const TupleSchema &schema,
@@ -19,8 +19,10 @@
 
 #include <iostream>
 #include <limits>
+#include <vector>
 #include <stx/btree.h>
 #include <boost/iterator/iterator_facade.hpp>
+#include <boost/scoped_ptr.hpp>
 #include "storage/TupleBlock.h"
 #include "common/tabletuple.h"
 
@@ -132,12 +134,58 @@ class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparat
      */
     bool add(const ElasticIndexKey &key);
 
+    /**
+     * Add a batch of keys to the index (direct).
+     * The keys are sorted (and, for an empty index, de-duplicated) in place.
+     * An empty index is bulk loaded in one pass, otherwise the keys are
+     * inserted in key order instead of bouncing between leaves.
+     * Return the number of keys that weren't present and got added.
+     */
+    size_t add(std::vector<ElasticIndexKey> &keys);
+
     /**
      * Remove key from index.
      * Return true if the key was present and removed.
      */
     bool remove(const PersistentTable &table, const TableTuple &tuple);
 
+    /**
+     * Remove key from index (direct).
+     * Return true if the key was present and removed.
+     */
+    bool remove(const ElasticIndexKey &key);
+
+    /**
+     * Start loading this empty index incrementally. Keys are passed to
+     * bulkAppend() in index order over as many calls as needed, and
+     * finishBulkLoad() then completes the tree in O(height). The index
+     * reads as empty until then. Dropping the index mid-load is safe.
+     */
+    void startBulkLoad();
+
+    /**
+     * Append the next key of an incremental bulk load. It must sort after
+     * every key appended before.
+     */
+    void bulkAppend(const ElasticIndexKey &key);
+
+    /**
+     * Complete an incremental bulk load.
+     * Return the number of keys loaded.
+     */
+    size_t finishBulkLoad();
+
+    /**
+     * Return true between startBulkLoad() and finishBulkLoad().
+     */
+    bool isBulkLoading() const;
+
+    /**
+     * Sort keys into index order (hash, then tuple address).
+     * Uses an LSD radix sort on the hash for larger batches.
+     */
+    static void sortKeys(std::vector<ElasticIndexKey> &keys);
+
     /**
      * Get full iterator.
      */
@@ -175,9 +223,18 @@ class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparat
 
   private:
 
+    // Below this many keys std::sort beats the radix sort setup cost.
+    static const size_t RADIX_SORT_THRESHOLD = 512;
+
+    static uint32_t radixDigit(const ElasticIndexKey &key, int shift);
+
     static ElasticHash generateHash(const PersistentTable &table, const TableTuple &tuple);
 
     static ElasticIndexKey generateKey(const PersistentTable &table, const TableTuple &tuple);
+
+    // Set by startBulkLoad() until finishBulkLoad().
+    // Destroyed before the tree, so an unfinished load frees its nodes.
+    boost::scoped_ptr<bulk_builder> m_builder;
 };
 
 /**
@@ -351,6 +408,15 @@ inline ElasticIndexKey ElasticIndex::generateKey(const PersistentTable &table, c
     return ElasticIndexKey(generateHash(table, tuple), tuple.address());
 }
 
+/**
+ * Internal method to extract one 8 bit radix sort digit from the hash.
+ * Flipping the sign bit makes the unsigned order match the signed one.
+ */
+inline uint32_t ElasticIndex::radixDigit(const ElasticIndexKey &key, int shift)
+{
+    return ((static_cast<uint32_t>(key.getHash()) ^ 0x80000000u) >> shift) & 0xFF;
+}
+
 /**
  * Return true if key is in the index (indirect from tuple).
  */
@@ -389,12 +455,8 @@ inline bool ElasticIndex::add(const PersistentTable &table, const TableTuple &tu
  */
 inline bool ElasticIndex::add(const ElasticIndexKey &key)
 {
-    bool inserted = false;
-    if (!exists(key)) {
-        inserted = insert(key).second;
-        assert(inserted);
-    }
-    return inserted;
+    // insert() doesn't replace an existing key, no need to look it up first.
+    return insert(key).second;
 }
 
 /**
@@ -403,12 +465,16 @@ inline bool ElasticIndex::add(const ElasticIndexKey &key)
  */
 inline bool ElasticIndex::remove(const PersistentTable &table, const TableTuple &tuple)
 {
-    bool removed = false;
-    ElasticIndexKey key = generateKey(table, tuple);
-    if (exists(key)) {
-        removed = this->erase(key);
-    }
-    return removed;
+    return remove(generateKey(table, tuple));
+}
+
+/**
+ * Remove key from index (direct).
+ * Return true if the key was present and removed.
+ */
+inline bool ElasticIndex::remove(const ElasticIndexKey &key)
+{
+    return this->erase(key) != 0;
 }
 
 /**
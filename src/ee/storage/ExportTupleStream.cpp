@@ -40,7 +40,7 @@ const int METADATA_COL_CNT = 6;
 
 ExportTupleStream::ExportTupleStream(CatalogId partitionId,
                                        int64_t siteId)
-    : TupleStreamBase(EL_BUFFER_SIZE),
+    : TupleStreamBase(EL_BUFFER_SIZE, 0, true),
       m_partitionId(partitionId), m_siteId(siteId),
       m_signature(""), m_generation(0)
 {}
@@ -72,7 +72,7 @@ void ExportTupleStream::setSignatureAndGeneration(std::string signature, int64_t
         m_committedUso = 0;
         //Reconstruct the next block so it has a USO of 0.
         assert(m_currBlock->offset() == 0);
-        extendBufferChain(m_defaultCapacity);
+        extendBufferChain(0);
     }
     m_signature = signature;
     m_generation = generation;
@@ -116,7 +116,7 @@ size_t ExportTupleStream::appendTuple(int64_t lastCommittedSpHandle,
     tupleMaxLength = computeOffsets(tuple, &rowHeaderSz);
 
     if (!m_currBlock) {
-        extendBufferChain(m_defaultCapacity);
+        extendBufferChain(0);
     }
 
     if (m_currBlock->remaining() < tupleMaxLength) {
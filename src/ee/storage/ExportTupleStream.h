@@ -57,7 +57,27 @@ public:
     }
 
     int64_t allocatedByteCount() const {
-        return (m_pendingBlocks.size() * (m_defaultCapacity - m_headerSpace)) +
+        // Blocks are sized adaptively, so add up their actual capacities
+        int64_t pendingBytes = 0;
+        for (std::deque<StreamBlock*>::const_iterator iter = m_pendingBlocks.begin();
+             iter != m_pendingBlocks.end(); ++iter) {
+            pendingBytes += (*iter)->capacity();
+        }
+        return pendingBytes +
+                ExecutorContext::getExecutorContext()->getTopend()->getQueuedExportBytes(m_partitionId, m_signature);
+    }
+
+    /**
+     * The bytes of data held in the blocks counted by allocatedByteCount.
+     * Together they give the fill ratio of the adaptively sized blocks.
+     */
+    int64_t occupiedByteCount() const {
+        int64_t pendingBytes = 0;
+        for (std::deque<StreamBlock*>::const_iterator iter = m_pendingBlocks.begin();
+             iter != m_pendingBlocks.end(); ++iter) {
+            pendingBytes += (*iter)->offset();
+        }
+        return pendingBytes +
                 ExecutorContext::getExecutorContext()->getTopend()->getQueuedExportBytes(m_partitionId, m_signature);
     }
 
@@ -22,6 +22,7 @@
 #include "common/tabletuple.h"
 #include "storage/table.h"
 #include "storage/persistenttable.h"
+#include "storage/streamedtable.h"
 #include "storage/tablefactory.h"
 #include <vector>
 #include <string>
@@ -125,11 +126,20 @@ void TableStats::updateStatsTuple(TableTuple *tuple) {
     int tupleLimit = m_table->tupleLimit();
     // This overflow is unlikely (requires 2 terabytes of allocated string memory)
     int64_t allocated_tuple_mem_kb = m_table->allocatedTupleMemory() / 1024;
-    int64_t occupied_tuple_mem_kb = 0;
+    // For a stream this is the data in its export blocks, which against the
+    // allocated memory gives the fill ratio of the blocks
+    int64_t occupiedTupleMemory = 0;
     PersistentTable* persistentTable = dynamic_cast<PersistentTable*>(m_table);
     if (persistentTable) {
-        occupied_tuple_mem_kb = persistentTable->occupiedTupleMemory() / 1024;
+        occupiedTupleMemory = persistentTable->occupiedTupleMemory();
     }
+    else {
+        StreamedTable* streamedTable = dynamic_cast<StreamedTable*>(m_table);
+        if (streamedTable) {
+            occupiedTupleMemory = streamedTable->occupiedTupleMemory();
+        }
+    }
+    int64_t occupied_tuple_mem_kb = occupiedTupleMemory / 1024;
     int64_t string_data_mem_kb = m_table->nonInlinedMemorySize() / 1024;
 
     if (interval()) {
@@ -140,9 +150,7 @@ void TableStats::updateStatsTuple(TableTuple *tuple) {
         m_lastAllocatedTupleMemory = m_table->allocatedTupleMemory();
         occupied_tuple_mem_kb =
             occupied_tuple_mem_kb - (m_lastOccupiedTupleMemory / 1024);
-        if (persistentTable) {
-            m_lastOccupiedTupleMemory = persistentTable->occupiedTupleMemory();
-        }
+        m_lastOccupiedTupleMemory = occupiedTupleMemory;
         string_data_mem_kb =
             string_data_mem_kb - (m_lastStringDataMemory / 1024);
         m_lastStringDataMemory = m_table->nonInlinedMemorySize();
@@ -54,10 +54,9 @@ void TempTableLimits::increaseAllocated(int bytes)
 
     m_logLatch = true;
     int thresh_mb = static_cast<int>(m_logThreshold / (1024 * 1024));
-    char msg[1024];
-    snprintf(msg, sizeof(msg), "More than %d MB of temp table memory used while executing SQL."
-             " This may indicate an operation that should be broken into smaller chunks.", thresh_mb);
-    LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_INFO, msg);
+    LogManager::getThreadLogger(LOGGERID_SQL)->logFormat(LOGLEVEL_INFO,
+            "More than %d MB of temp table memory used while executing SQL."
+            " This may indicate an operation that should be broken into smaller chunks.", thresh_mb);
 }
 
 } // namespace voltdb
@@ -39,7 +39,8 @@ using namespace voltdb;
 
 const int MAX_BUFFER_AGE = 4000;
 
-TupleStreamBase::TupleStreamBase(int defaultBufferSize, size_t extraHeaderSpace /*= 0*/)
+TupleStreamBase::TupleStreamBase(int defaultBufferSize, size_t extraHeaderSpace /*= 0*/,
+                                 bool adaptiveCapacity /*= false*/)
     : m_flushInterval(MAX_BUFFER_AGE),
       m_lastFlush(0), m_defaultCapacity(defaultBufferSize),
       m_uso(0), m_currBlock(NULL),
@@ -51,9 +52,11 @@ TupleStreamBase::TupleStreamBase(int defaultBufferSize, size_t extraHeaderSpace
       m_openTransactionUso(0),
       m_committedSpHandle(0), m_committedUso(0),
       m_committedUniqueId(0),
-      m_headerSpace(MAGIC_HEADER_SPACE_FOR_JAVA + extraHeaderSpace)
+      m_headerSpace(MAGIC_HEADER_SPACE_FOR_JAVA + extraHeaderSpace),
+      m_adaptiveCapacity(adaptiveCapacity),
+      m_currentCapacity(std::min<size_t>(MIN_ADAPTIVE_BUFFER_SIZE, defaultBufferSize))
 {
-    extendBufferChain(m_defaultCapacity);
+    extendBufferChain(0);
 }
 
 void
@@ -68,7 +71,8 @@ TupleStreamBase::setDefaultCapacity(size_t capacity)
     }
     cleanupManagedBuffers();
     m_defaultCapacity = capacity;
-    extendBufferChain(m_defaultCapacity);
+    m_currentCapacity = std::min<size_t>(MIN_ADAPTIVE_BUFFER_SIZE, capacity);
+    extendBufferChain(0);
 }
 
 
@@ -267,6 +271,27 @@ void TupleStreamBase::discardBlock(StreamBlock *sb)
     }
 }
 
+/*
+ * Follow the volume of the stream: a block that had to be closed
+ * because it was full asks for bigger blocks, and a flushed block
+ * that was mostly empty, or a flush with no data at all, for smaller
+ * ones.
+ */
+void TupleStreamBase::adaptCapacity(StreamBlock *closedBlock, size_t minLength)
+{
+    if (!m_adaptiveCapacity) {
+        return;
+    }
+    const size_t minCapacity = std::min<size_t>(MIN_ADAPTIVE_BUFFER_SIZE, m_defaultCapacity);
+    if (closedBlock != NULL && minLength > 0) {
+        m_currentCapacity = std::min(m_currentCapacity * 2, m_defaultCapacity);
+    }
+    else if (minLength == 0 &&
+             (closedBlock == NULL || closedBlock->offset() < closedBlock->capacity() / 4)) {
+        m_currentCapacity = std::max(m_currentCapacity / 2, minCapacity);
+    }
+}
+
 /*
  * Allocate another buffer, preserving the current buffer's content in
  * the pending queue.
@@ -278,35 +303,49 @@ void TupleStreamBase::extendBufferChain(size_t minLength)
         throwFatalException("Default capacity is less than required buffer size.");
     }
     StreamBlock *oldBlock = NULL;
+    StreamBlock *emptyBlock = NULL;
     size_t uso = m_uso;
 
     if (m_currBlock) {
         if (m_currBlock->offset() > 0) {
             m_pendingBlocks.push_back(m_currBlock);
             oldBlock = m_currBlock;
-            m_currBlock = NULL;
         }
-        // fully discard empty blocks. makes valgrind/testcase
-        // conclusion easier.
+        // empty blocks can be reused as they are, the data they
+        // would have held goes in the next block anyway.
         else {
-            discardBlock(m_currBlock);
-            m_currBlock = NULL;
+            emptyBlock = m_currBlock;
         }
+        m_currBlock = NULL;
+        adaptCapacity(oldBlock, minLength);
     }
     size_t blockSize = m_defaultCapacity;
     bool openTransaction = checkOpenTransaction(oldBlock, minLength, blockSize, uso);
 
     if (blockSize == 0) {
+        discardBlock(emptyBlock);
         throw TupleStreamException(SQLException::volt_output_buffer_overflow, "Transaction is bigger than DR Buffer size");
     }
+    // Blocks carrying over an open transaction keep their full size
+    if (m_adaptiveCapacity && !openTransaction && blockSize == m_defaultCapacity) {
+        blockSize = std::min(m_defaultCapacity, std::max(m_currentCapacity, m_headerSpace + minLength));
+    }
 
-    char *buffer = new char[blockSize];
-    if (!buffer) {
-        throwFatalException("Failed to claim managed buffer for Export.");
+    if (emptyBlock != NULL && m_adaptiveCapacity && !openTransaction && emptyBlock->uso() == uso &&
+            emptyBlock->headerSize() + emptyBlock->capacity() == blockSize &&
+            emptyBlock->type() == NORMAL_STREAM_BLOCK) {
+        m_currBlock = emptyBlock;
     }
-    m_currBlock = new StreamBlock(buffer, m_headerSpace, blockSize, uso);
-    if (blockSize > m_defaultCapacity) {
-        m_currBlock->setType(LARGE_STREAM_BLOCK);
+    else {
+        discardBlock(emptyBlock);
+        char *buffer = new char[blockSize];
+        if (!buffer) {
+            throwFatalException("Failed to claim managed buffer for Export.");
+        }
+        m_currBlock = new StreamBlock(buffer, m_headerSpace, blockSize, uso);
+        if (blockSize > m_defaultCapacity) {
+            m_currBlock->setType(LARGE_STREAM_BLOCK);
+        }
     }
 
     if (openTransaction) {
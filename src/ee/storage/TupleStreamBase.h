@@ -38,10 +38,20 @@ class Topend;
 //Necessary for very large rows
 const int EL_BUFFER_SIZE = /* 1024; */ (2 * 1024 * 1024) + MAGIC_HEADER_SPACE_FOR_JAVA + (4096 - MAGIC_HEADER_SPACE_FOR_JAVA);
 
+//Streams with adaptive buffer sizing start out with blocks this small and
+//double them, up to their default capacity, while blocks keep filling up
+const int MIN_ADAPTIVE_BUFFER_SIZE = 64 * 1024;
+
 class TupleStreamBase {
 public:
 
-    TupleStreamBase(int defaultBufferSizes, size_t extraHeaderSpace = 0);
+    /**
+     * With adaptiveCapacity, blocks start at MIN_ADAPTIVE_BUFFER_SIZE,
+     * double whenever one fills up and halve whenever one is flushed
+     * less than a quarter full, always staying within the default
+     * capacity.  Otherwise every block has the default capacity.
+     */
+    TupleStreamBase(int defaultBufferSizes, size_t extraHeaderSpace = 0, bool adaptiveCapacity = false);
 
     virtual ~TupleStreamBase()
     {
@@ -77,6 +87,9 @@ public:
 
     virtual bool checkOpenTransaction(StreamBlock *sb, size_t minLength, size_t& blockSize, size_t& uso) { return false; }
 
+    /** The size of the next regular block */
+    size_t currentCapacity() const { return m_adaptiveCapacity ? m_currentCapacity : m_defaultCapacity; }
+
     virtual void handleOpenTransaction(StreamBlock *oldBlock) {}
 
     /** Send committed data to the top end. */
@@ -117,6 +130,12 @@ public:
     int64_t m_committedUniqueId;
 
     size_t m_headerSpace;
+
+private:
+    void adaptCapacity(StreamBlock *closedBlock, size_t minLength);
+
+    const bool m_adaptiveCapacity;
+    size_t m_currentCapacity;
 };
 
 }
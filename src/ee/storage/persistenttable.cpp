@@ -1605,8 +1605,6 @@ bool PersistentTable::doForcedCompaction() {
     int64_t notPendingCompactions = 0;
     int64_t pendingCompactions = 0;
 
-    char msg[512];
-
     boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
 
     int failedCompactionCountBefore = m_failedCompactionCount;
@@ -1629,11 +1627,11 @@ bool PersistentTable::doForcedCompaction() {
              * This is a work around for ENG-939
              */
             if (m_failedCompactionCount % 5000 == 0) {
-                snprintf(msg, sizeof(msg), "Compaction predicate said there should be "
-                         "blocks to compact but no blocks were found "
-                         "to be eligible for compaction. This has "
-                         "occured %d times.", m_failedCompactionCount);
-                LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_ERROR, msg);
+                LogManager::getThreadLogger(LOGGERID_SQL)->logFormat(LOGLEVEL_ERROR,
+                        "Compaction predicate said there should be "
+                        "blocks to compact but no blocks were found "
+                        "to be eligible for compaction. This has "
+                        "occured %d times.", m_failedCompactionCount);
             }
             if (m_failedCompactionCount == 0) {
                 printBucketInfo();
@@ -1655,19 +1653,19 @@ bool PersistentTable::doForcedCompaction() {
     //If compactions have been failing lately, but it didn't fail this time
     //then compaction progressed until the predicate was satisfied
     if (failedCompactionCountBefore > 0 && failedCompactionCountBefore == m_failedCompactionCount) {
-        snprintf(msg, sizeof(msg), "Recovered from a failed compaction scenario "
+        LogManager::getThreadLogger(LOGGERID_SQL)->logFormat(LOGLEVEL_ERROR,
+                "Recovered from a failed compaction scenario "
                 "and compacted to the point that the compaction predicate was "
                 "satisfied after %d failed attempts", failedCompactionCountBefore);
-        LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_ERROR, msg);
         m_failedCompactionCount = 0;
     }
 
     assert(!compactionPredicate());
     boost::posix_time::ptime endTime(boost::posix_time::microsec_clock::universal_time());
     boost::posix_time::time_duration duration = endTime - startTime;
-    snprintf(msg, sizeof(msg), "Finished forced compaction of %zd non-snapshot blocks and %zd snapshot blocks with allocated tuple count %zd in %zd ms",
+    LogManager::getThreadLogger(LOGGERID_SQL)->logFormat(LOGLEVEL_INFO,
+            "Finished forced compaction of %jd non-snapshot blocks and %jd snapshot blocks with allocated tuple count %jd in %jd ms",
             ((intmax_t)notPendingCompactions), ((intmax_t)pendingCompactions), ((intmax_t)allocatedTupleCount()), ((intmax_t)duration.total_milliseconds()));
-    LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_INFO, msg);
     return (notPendingCompactions + pendingCompactions) > 0;
 }
 
@@ -1728,17 +1726,37 @@ int64_t PersistentTable::validatePartitioning(TheHashinator *hashinator, int32_t
 
     int64_t mispartitionedRows = 0;
 
-    while (iter.hasNext()) {
-        TableTuple tuple(schema());
-        iter.next(tuple);
-        int32_t newPartitionId = hashinator->hashinate(tuple.getNValue(m_partitionColumn));
-        if (newPartitionId != partitionId) {
+    // Route the partition column in batches so the hashinator can hash and
+    // search a whole vector of values per call.
+    const int32_t batchCapacity = TheHashinator::HASHINATE_BATCH_SIZE;
+    std::vector<NValue> values(batchCapacity);
+    std::vector<void*> addresses(batchCapacity);
+    std::vector<int32_t> partitions(batchCapacity);
+    TableTuple tuple(schema());
+    bool hasMore = true;
+    while (hasMore) {
+        int32_t batchCount = 0;
+        while (batchCount < batchCapacity && (hasMore = iter.next(tuple))) {
+            values[batchCount] = tuple.getNValue(m_partitionColumn);
+            addresses[batchCount] = tuple.address();
+            ++batchCount;
+        }
+        if (batchCount == 0) {
+            break;
+        }
+        hashinator->partitionsForValues(&values[0], batchCount, &partitions[0]);
+        for (int32_t ii = 0; ii < batchCount; ii++) {
+            int32_t newPartitionId = partitions[ii];
+            if (newPartitionId == partitionId) {
+                continue;
+            }
+            TableTuple mispartitioned(static_cast<char*>(addresses[ii]), schema());
             std::ostringstream buffer;
             buffer << "@ValidPartitioning found a mispartitioned row (hash: "
-                    << m_surgeon.generateTupleHash(tuple)
+                    << m_surgeon.generateTupleHash(mispartitioned)
                     << " should in "<< partitionId
                     << ", but in " << newPartitionId << "):\n"
-                    << tuple.debug(name())
+                    << mispartitioned.debug(name())
                     << std::endl;
             LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN,
                     buffer.str().c_str());
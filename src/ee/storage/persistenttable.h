@@ -130,7 +130,14 @@ public:
     void setIndexingComplete();
     bool indexHas(TableTuple &tuple) const;
     bool indexAdd(TableTuple &tuple);
+    bool indexAdd(const ElasticIndexKey &key);
+    size_t indexAdd(std::vector<ElasticIndexKey> &keys);
+    void indexStartBulkLoad();
+    void indexBulkAppend(const ElasticIndexKey &key);
+    size_t indexFinishBulkLoad();
+    bool isIndexBulkLoading() const;
     bool indexRemove(TableTuple &tuple);
+    bool indexRemove(const ElasticIndexKey &key);
     void initTableStreamer(TableStreamerInterface* streamer);
     bool hasStreamType(TableStreamType streamType) const;
     ElasticIndex::iterator indexIterator();
@@ -863,11 +870,46 @@ inline bool PersistentTableSurgeon::indexAdd(TableTuple &tuple) {
     return m_index->add(m_table, tuple);
 }
 
+inline bool PersistentTableSurgeon::indexAdd(const ElasticIndexKey &key) {
+    assert (m_index != NULL);
+    return m_index->add(key);
+}
+
+inline size_t PersistentTableSurgeon::indexAdd(std::vector<ElasticIndexKey> &keys) {
+    assert (m_index != NULL);
+    return m_index->add(keys);
+}
+
+inline void PersistentTableSurgeon::indexStartBulkLoad() {
+    assert (m_index != NULL);
+    m_index->startBulkLoad();
+}
+
+inline void PersistentTableSurgeon::indexBulkAppend(const ElasticIndexKey &key) {
+    assert (m_index != NULL);
+    m_index->bulkAppend(key);
+}
+
+inline size_t PersistentTableSurgeon::indexFinishBulkLoad() {
+    assert (m_index != NULL);
+    return m_index->finishBulkLoad();
+}
+
+inline bool PersistentTableSurgeon::isIndexBulkLoading() const {
+    assert (m_index != NULL);
+    return m_index->isBulkLoading();
+}
+
 inline bool PersistentTableSurgeon::indexRemove(TableTuple &tuple) {
     assert (m_index != NULL);
     return m_index->remove(m_table, tuple);
 }
 
+inline bool PersistentTableSurgeon::indexRemove(const ElasticIndexKey &key) {
+    assert (m_index != NULL);
+    return m_index->remove(key);
+}
+
 inline ElasticIndex::iterator PersistentTableSurgeon::indexIterator() {
     assert (m_index != NULL);
     return m_index->createIterator();
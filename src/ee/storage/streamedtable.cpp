@@ -208,6 +208,13 @@ int64_t StreamedTable::allocatedTupleMemory() const {
     return 0;
 }
 
+int64_t StreamedTable::occupiedTupleMemory() const {
+    if (m_wrapper) {
+        return m_wrapper->occupiedByteCount();
+    }
+    return 0;
+}
+
 /**
  * Get the current offset in bytes of the export stream for this Table
  * since startup.
@@ -96,6 +96,9 @@ public:
     //Override and say how many bytes are in Java and C++
     int64_t allocatedTupleMemory() const;
 
+    // How many of those bytes hold stream data
+    int64_t occupiedTupleMemory() const;
+
 
     /**
      * Get the current offset in bytes of the export stream for this Table
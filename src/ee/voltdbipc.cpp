@@ -1104,6 +1104,8 @@ int64_t VoltDBIPC::fragmentProgressUpdate(
 }
 
 void VoltDBIPC::crashVoltDB(voltdb::FatalException e) {
+    // Get out the debug output leading up to the crash
+    voltdb::LogManager::drainThreadLogRing();
     const char *reasonBytes = e.m_reason.c_str();
     int32_t reasonLength = static_cast<int32_t>(strlen(reasonBytes));
     int32_t lineno = static_cast<int32_t>(e.m_lineno);
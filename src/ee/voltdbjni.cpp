@@ -1184,18 +1184,13 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeHashi
         Pool *stringPool = engine->getStringPool();
         deserializeParameterSet(engine->getParameterBuffer(), engine->getParameterBufferCapacity(), params, engine->getStringPool());
         HashinatorType hashinatorType = static_cast<HashinatorType>(voltdb::ValuePeeker::peekAsInteger(params[1]));
-        boost::scoped_ptr<TheHashinator> hashinator;
         const char *configValue = voltdb::ValuePeeker::peekObjectValue(params[2]);
-        switch (hashinatorType) {
-        case HASHINATOR_LEGACY:
-            hashinator.reset(LegacyHashinator::newInstance(configValue));
-            break;
-        case HASHINATOR_ELASTIC:
-            hashinator.reset(ElasticHashinator::newInstance(configValue, reinterpret_cast<int32_t*>(configPtr), static_cast<uint32_t>(tokenCount)));
-            break;
-        default:
+        if (hashinatorType != HASHINATOR_LEGACY && hashinatorType != HASHINATOR_ELASTIC) {
             return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
         }
+        // Java holds on to the last config, so its token layout can be reused by address
+        TheHashinator *hashinator = engine->hashinatorForConfig(hashinatorType, configValue,
+                reinterpret_cast<int32_t*>(configPtr), static_cast<uint32_t>(tokenCount));
         int retval =
             hashinator->hashinate(params[0]);
         stringPool->purge();
@@ -0,0 +1,56 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+
+import org.voltdb.VoltTable.ColumnInfo;
+
+/**
+ * The execution profile of every plan node of the fragments in a site's
+ * EE plan cache, refreshed from the EE on each stats tick.
+ */
+public class PlanNodeStats extends SiteStatsSource {
+    public PlanNodeStats(long siteId) {
+        super(siteId, true);
+    }
+
+    @Override
+    protected Iterator<Object> getStatsRowKeyIterator(boolean interval) {
+        return null;
+    }
+
+    // Generally we fill in this schema from the EE, but we'll provide
+    // this so that we can fill in an empty table before the EE has
+    // provided us with a table.  Make sure that any changes to the EE
+    // schema are reflected here (sigh).
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("PARTITION_ID", VoltType.BIGINT));
+        columns.add(new ColumnInfo("FRAGMENT_ID", VoltType.BIGINT));
+        columns.add(new ColumnInfo("PLAN_NODE_ID", VoltType.INTEGER));
+        columns.add(new ColumnInfo("PLAN_NODE_TYPE", VoltType.STRING));
+        columns.add(new ColumnInfo("INVOCATIONS", VoltType.BIGINT));
+        columns.add(new ColumnInfo("ROWS_IN", VoltType.BIGINT));
+        columns.add(new ColumnInfo("ROWS_OUT", VoltType.BIGINT));
+        columns.add(new ColumnInfo("CPU_CYCLES", VoltType.BIGINT));
+        columns.add(new ColumnInfo("PEAK_TEMP_TABLE_BYTES", VoltType.BIGINT));
+        columns.add(new ColumnInfo("INDEX_PROBES", VoltType.BIGINT));
+    }
+}
@@ -16,13 +16,17 @@
  */
 package org.voltdb;
 
+import java.util.HashSet;
 import java.util.Map;
+import java.util.Set;
+import java.util.TreeMap;
 
 import org.cliffc_voltpatches.high_scale_lib.NonBlockingHashMap;
 import org.cliffc_voltpatches.high_scale_lib.NonBlockingHashSet;
 import org.json_voltpatches.JSONObject;
 import org.voltcore.network.Connection;
 import org.voltdb.TheHashinator.HashinatorConfig;
+import org.voltdb.VoltTable.ColumnInfo;
 import org.voltdb.catalog.Procedure;
 import org.voltdb.client.ClientResponse;
 
@@ -64,6 +68,10 @@ public class StatsAgent extends OpsAgent
             request.aggregateTables =
             aggregateProcedureOutputStats(request.aggregateTables);
             break;
+        case PLANNODE:
+            request.aggregateTables =
+            aggregatePlanNodeStats(request.aggregateTables);
+            break;
 
         default:
         }
@@ -179,6 +187,92 @@ public class StatsAgent extends OpsAgent
         return new VoltTable[] { timeTable.sortByOutput("PROCEDURE_OUTPUT") };
     }
 
+    // One plan node of a fragment, summed across partitions
+    private static class PlanNodeRow
+    {
+        long timestamp;
+        String planNodeType;
+        long invocations;
+        long rowsIn;
+        long rowsOut;
+        long cpuCycles;
+        long peakTempTableBytes;
+        long indexProbes;
+        // Replicas of a partition run the same fragments, count each partition once
+        final Set<Long> seenPartitions = new HashSet<Long>();
+    }
+
+    /**
+     * Produce PLANNODE aggregation: one row per plan node of each fragment,
+     * summed across the partitions that have the fragment cached.
+     */
+    private VoltTable[] aggregatePlanNodeStats(VoltTable[] baseStats)
+    {
+        if (baseStats == null || baseStats.length != 1) {
+            return baseStats;
+        }
+
+        TreeMap<Long, TreeMap<Integer, PlanNodeRow>> fragments =
+                new TreeMap<Long, TreeMap<Integer, PlanNodeRow>>();
+        baseStats[0].resetRowPosition();
+        while (baseStats[0].advanceRow()) {
+            long fragmentId = baseStats[0].getLong("FRAGMENT_ID");
+            int planNodeId = (int) baseStats[0].getLong("PLAN_NODE_ID");
+            TreeMap<Integer, PlanNodeRow> planNodes = fragments.get(fragmentId);
+            if (planNodes == null) {
+                planNodes = new TreeMap<Integer, PlanNodeRow>();
+                fragments.put(fragmentId, planNodes);
+            }
+            PlanNodeRow row = planNodes.get(planNodeId);
+            if (row == null) {
+                row = new PlanNodeRow();
+                row.planNodeType = baseStats[0].getString("PLAN_NODE_TYPE");
+                planNodes.put(planNodeId, row);
+            }
+            if (!row.seenPartitions.add(baseStats[0].getLong("PARTITION_ID"))) {
+                continue;
+            }
+            row.timestamp = Math.max(row.timestamp, baseStats[0].getLong("TIMESTAMP"));
+            row.invocations += baseStats[0].getLong("INVOCATIONS");
+            row.rowsIn += baseStats[0].getLong("ROWS_IN");
+            row.rowsOut += baseStats[0].getLong("ROWS_OUT");
+            row.cpuCycles += baseStats[0].getLong("CPU_CYCLES");
+            row.peakTempTableBytes = Math.max(row.peakTempTableBytes,
+                                              baseStats[0].getLong("PEAK_TEMP_TABLE_BYTES"));
+            row.indexProbes += baseStats[0].getLong("INDEX_PROBES");
+        }
+
+        VoltTable result = new VoltTable(
+                new ColumnInfo("TIMESTAMP", VoltType.BIGINT),
+                new ColumnInfo("FRAGMENT_ID", VoltType.BIGINT),
+                new ColumnInfo("PLAN_NODE_ID", VoltType.INTEGER),
+                new ColumnInfo("PLAN_NODE_TYPE", VoltType.STRING),
+                new ColumnInfo("PARTITIONS", VoltType.INTEGER),
+                new ColumnInfo("INVOCATIONS", VoltType.BIGINT),
+                new ColumnInfo("ROWS_IN", VoltType.BIGINT),
+                new ColumnInfo("ROWS_OUT", VoltType.BIGINT),
+                new ColumnInfo("CPU_CYCLES", VoltType.BIGINT),
+                new ColumnInfo("PEAK_TEMP_TABLE_BYTES", VoltType.BIGINT),
+                new ColumnInfo("INDEX_PROBES", VoltType.BIGINT));
+        for (Map.Entry<Long, TreeMap<Integer, PlanNodeRow>> fragment : fragments.entrySet()) {
+            for (Map.Entry<Integer, PlanNodeRow> planNode : fragment.getValue().entrySet()) {
+                PlanNodeRow row = planNode.getValue();
+                result.addRow(row.timestamp,
+                              fragment.getKey(),
+                              planNode.getKey(),
+                              row.planNodeType,
+                              row.seenPartitions.size(),
+                              row.invocations,
+                              row.rowsIn,
+                              row.rowsOut,
+                              row.cpuCycles,
+                              row.peakTempTableBytes,
+                              row.indexProbes);
+            }
+        }
+        return new VoltTable[] { result };
+    }
+
 
     /**
      * Need to release references to catalog related stats sources
@@ -436,6 +530,9 @@ public class StatsAgent extends OpsAgent
         case IMPORTER:
             stats = collectStats(StatsSelector.IMPORTER, interval);
             break;
+        case PLANNODE:
+            stats = collectStats(StatsSelector.PLANNODE, interval);
+            break;
         default:
             // Should have been successfully groomed in collectStatsImpl().  Log something
             // for our information but let the null check below return harmlessly
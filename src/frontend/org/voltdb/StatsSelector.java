@@ -54,5 +54,7 @@ public enum StatsSelector {
     CPU,            // Return CPU Stats
 
     COMMANDLOG,     // return number of outstanding bytes and txns on this node
-    IMPORTER
+    IMPORTER,
+
+    PLANNODE        // per plan node execution profile, from the EE only
 }
@@ -94,6 +94,12 @@ public interface SystemProcedureExecutionContext {
 
     public void resetDrAppliedTracker();
 
+    /**
+     * Hand the applied trackers' replicated stream positions to the EE, which
+     * skips replicated DR txns it has already applied.
+     */
+    public void pushDrAppliedTrackersToEE();
+
     public Map<Integer, Map<Integer, DRConsumerDrIdTracker>> getDrAppliedTrackers();
 
     public Pair<Long, Long> getDrLastAppliedUniqueIds();
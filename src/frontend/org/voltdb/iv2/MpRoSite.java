@@ -262,6 +262,11 @@ public class MpRoSite implements Runnable, SiteProcedureConnection
             throw new RuntimeException("RO MP Site doesn't do this, shouldn't be here.");
         }
 
+        @Override
+        public void pushDrAppliedTrackersToEE() {
+            throw new RuntimeException("RO MP Site doesn't do this, shouldn't be here.");
+        }
+
         @Override
         public Map<Integer, Map<Integer, DRConsumerDrIdTracker>> getDrAppliedTrackers()
         {
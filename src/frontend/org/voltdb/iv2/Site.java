@@ -52,6 +52,7 @@ import org.voltdb.MemoryStats;
 import org.voltdb.NonVoltDBBackend;
 import org.voltdb.ParameterSet;
 import org.voltdb.PartitionDRGateway;
+import org.voltdb.PlanNodeStats;
 import org.voltdb.PostGISBackend;
 import org.voltdb.PostgreSQLBackend;
 import org.voltdb.ProcedureRunner;
@@ -158,6 +159,7 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     // Stats
     final TableStats m_tableStats;
     final IndexStats m_indexStats;
+    final PlanNodeStats m_planNodeStats;
     final MemoryStats m_memStats;
 
     // Each execution site manages snapshot using a SnapshotSiteProcessor
@@ -510,6 +512,7 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         {
             assert(m_maxSeenDrLogsBySrcPartition.size() == 0);
             m_maxSeenDrLogsBySrcPartition = trackers;
+            setDRReplicatedAppliedSequenceNumbers();
         }
 
         @Override
@@ -517,6 +520,12 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             m_maxSeenDrLogsBySrcPartition.clear();
             m_lastLocalSpUniqueId = -1L;
             m_lastLocalMpUniqueId = -1L;
+            setDRReplicatedAppliedSequenceNumbers();
+        }
+
+        @Override
+        public void pushDrAppliedTrackersToEE() {
+            setDRReplicatedAppliedSequenceNumbers();
         }
 
         @Override
@@ -594,11 +603,16 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             agent.registerStatsSource(StatsSelector.INDEX,
                                       m_siteId,
                                       m_indexStats);
+            m_planNodeStats = new PlanNodeStats(m_siteId);
+            agent.registerStatsSource(StatsSelector.PLANNODE,
+                                      m_siteId,
+                                      m_planNodeStats);
             m_memStats = memStats;
         } else {
             // MPI doesn't need to track these stats
             m_tableStats = null;
             m_indexStats = null;
+            m_planNodeStats = null;
             m_memStats = null;
         }
     }
@@ -1148,6 +1162,31 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         m_ee.executeTask(TaskType.SET_DR_SEQUENCE_NUMBERS, paramBuffer);
     }
 
+    /**
+     * The EE skips replicated stream DR txns at or below the last one it applied
+     * from each producer cluster. That barrier lives in memory only, so seed it
+     * from the applied trackers, which snapshots and rejoin persist, whenever
+     * they are installed or reset. The replicated stream is still applied with
+     * @ApplyBinaryLogMP rather than routed to each site, so for now the barrier
+     * only protects against redelivery.
+     */
+    private void setDRReplicatedAppliedSequenceNumbers() {
+        Map<Integer, Long> sequenceNumbers = new HashMap<Integer, Long>();
+        for (Entry<Integer, Map<Integer, DRConsumerDrIdTracker>> e : m_maxSeenDrLogsBySrcPartition.entrySet()) {
+            DRConsumerDrIdTracker tracker = e.getValue().get(MpInitiator.MP_INIT_PID);
+            if (tracker != null && tracker.size() > 0) {
+                sequenceNumbers.put(e.getKey(), tracker.getSafePointDrId());
+            }
+        }
+        ByteBuffer paramBuffer = m_ee.getParamBufferForExecuteTask(4 + 12 * sequenceNumbers.size());
+        paramBuffer.putInt(sequenceNumbers.size());
+        for (Entry<Integer, Long> e : sequenceNumbers.entrySet()) {
+            paramBuffer.putInt(e.getKey());
+            paramBuffer.putLong(e.getValue());
+        }
+        m_ee.executeTask(TaskType.SET_DR_REPLICATED_APPLIED_SEQUENCE_NUMBERS, paramBuffer);
+    }
+
     @Override
     public void toggleProfiler(int toggle)
     {
@@ -1241,6 +1280,16 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                 m_indexStats.resetStatsTable();
             }
 
+            // update plan node stats, one row per plan node of each cached plan
+            final VoltTable[] s3 =
+                m_ee.getStats(StatsSelector.PLANNODE, new int[0], false, time);
+            if ((s3 != null) && (s3.length > 0)) {
+                m_planNodeStats.setStatsTable(s3[0]);
+            }
+            else {
+                m_planNodeStats.resetStatsTable();
+            }
+
             // update the rolled up memory statistics
             if (m_memStats != null) {
                 m_memStats.eeUpdateMemStats(m_siteId,
@@ -1353,6 +1402,7 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                     allConsumerSiteTrackers.get(m_partitionId);
             if (thisConsumerSiteTrackers != null) {
                 m_maxSeenDrLogsBySrcPartition = thisConsumerSiteTrackers;
+                setDRReplicatedAppliedSequenceNumbers();
             }
         }
         m_rejoinState = kStateReplayingRejoin;
@@ -38,6 +38,14 @@ public class EELoggers {
     public static final int fatal = 6;
     public static final int off = 7;
 
+    /*
+     * Set above the bits of all the loggers to have the EE buffer TRACE and
+     * DEBUG statements and forward them on tick instead of one JNI call per
+     * statement.  Turned on with -DEE_BUFFER_DEBUG_LOG=true
+     */
+    public static final long BUFFER_DEBUG = 1L << 63;
+    private static final boolean m_bufferDebug = Boolean.getBoolean("EE_BUFFER_DEBUG_LOG");
+
     /*
      * The order of the loggers in this array determines the order their
      * log level is encoded into the long and the order they will be read
@@ -54,7 +62,11 @@ public class EELoggers {
      */
     public final static long getLogLevels() {
         assert(loggers.length > 0);
-        return loggers[0].getLogLevels(loggers);
+        long logLevels = loggers[0].getLogLevels(loggers);
+        if (m_bufferDebug) {
+            logLevels |= BUFFER_DEBUG;
+        }
+        return logLevels;
     }
 
     /**
@@ -64,7 +64,8 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
         SP_JAVA_GET_DRID_TRACKER(4),
         SET_DRID_TRACKER(5),
         GENERATE_DR_EVENT(6),
-        RESET_DR_APPLIED_TRACKER(7);
+        RESET_DR_APPLIED_TRACKER(7),
+        SET_DR_REPLICATED_APPLIED_SEQUENCE_NUMBERS(8);
 
         private TaskType(int taskId) {
             this.taskId = taskId;
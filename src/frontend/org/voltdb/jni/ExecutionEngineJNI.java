@@ -19,6 +19,7 @@ package org.voltdb.jni;
 
 import java.io.IOException;
 import java.nio.ByteBuffer;
+import java.util.ArrayList;
 import java.util.List;
 
 import org.voltcore.logging.VoltLogger;
@@ -39,6 +40,8 @@ import org.voltdb.sysprocs.saverestore.SnapshotUtil;
 
 import com.google_voltpatches.common.base.Throwables;
 
+import sun.misc.Cleaner;
+
 /**
  * Wrapper for native Execution Engine library.
  * All native methods are private to make it simple
@@ -104,6 +107,27 @@ public class ExecutionEngineJNI extends ExecutionEngine {
      */
     private ByteBuffer fallbackBuffer = null;
 
+    /*
+     * True if the fallback buffer was allocated here on request of the EE,
+     * in which case the result tables can share it instead of copying it.
+     */
+    private boolean fallbackBufferIsJavaOwned = false;
+
+    /*
+     * The pooled buffers handed to the EE by allocateResultBuffer during the
+     * current native call, oldest first. The EE copies the results written so
+     * far out of the previous buffer after the callback returns, so they all
+     * stay here until the call is done and then go back to the pool. The last
+     * one is taken out of the chain if the result tables are sliced out of it.
+     */
+    private final ArrayList<BBContainer> resultBufferChain = new ArrayList<BBContainer>();
+
+    /*
+     * The config of the last hashinate call. The EE caches the hashinator it
+     * built for it by the address of its off heap tokens.
+     */
+    private HashinatorConfig hashinateConfig = null;
+
     private final BBContainer exceptionBufferOrigin = org.voltcore.utils.DBBPool.allocateDirect(1024 * 1024 * 5);
     private ByteBuffer exceptionBuffer = exceptionBufferOrigin.b();
 
@@ -306,7 +330,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
         // Execute the plan, passing a raw pointer to the byte buffers for input and output
         //Clear is destructive, do it before the native call
-        deserializer.clear();
+        clearResultBuffers();
         final int errorCode =
             nativeExecutePlanFragments(
                     pointer,
@@ -321,7 +345,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
         try {
             checkErrorCode(errorCode);
-            FastDeserializer fds = fallbackBuffer == null ? deserializer : new FastDeserializer(fallbackBuffer);
+            FastDeserializer fds = resultDeserializer();
             // get a copy of the result buffers and make the tables
             // use the copy
             try {
@@ -331,8 +355,16 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                 final boolean dirty = fds.readBoolean();
                 if (dirty)
                     m_dirty = true;
-                // get a copy of the buffer
-                final ByteBuffer fullBacking = fds.readBuffer(totalSize);
+                // get a copy of the buffer, unless it was allocated for
+                // these results alone
+                final ByteBuffer fullBacking;
+                if (fallbackBufferIsJavaOwned) {
+                    fullBacking = fds.buffer().slice();
+                    fullBacking.limit(totalSize);
+                    handOverResultBuffer(fullBacking);
+                } else {
+                    fullBacking = fds.readBuffer(totalSize);
+                }
                 final VoltTable[] results = new VoltTable[batchSize];
                 for (int i = 0; i < batchSize; ++i) {
                     final int numdeps = fullBacking.getInt(); // number of dependencies for this frag
@@ -355,7 +387,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                 throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
             }
         } finally {
-            fallbackBuffer = null;
+            clearFallbackBuffer();
         }
     }
 
@@ -365,7 +397,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             LOG.trace("Retrieving VoltTable:" + tableId);
         }
         //Clear is destructive, do it before the native call
-        deserializer.clear();
+        clearResultBuffers();
         final int errorCode = nativeSerializeTable(pointer, tableId, deserializer.buffer(),
                 deserializer.buffer().capacity());
         checkErrorCode(errorCode);
@@ -391,24 +423,27 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         }
 
         //Clear is destructive, do it before the native call
-        deserializer.clear();
+        clearResultBuffers();
         final int errorCode = nativeLoadTable(pointer, tableId, serialized_table,
                                               txnId, spHandle, lastCommittedSpHandle, uniqueId,
                                               returnUniqueViolations, shouldDRStream, undoToken);
         checkErrorCode(errorCode);
 
         try {
-            int length = deserializer.readInt();
+            FastDeserializer fds = resultDeserializer();
+            int length = fds.readInt();
             if (length == 0) return null;
             if (length < 0) VoltDB.crashLocalVoltDB("Length shouldn't be < 0", true, null);
 
             byte uniqueViolations[] = new byte[length];
-            deserializer.readFully(uniqueViolations);
+            fds.readFully(uniqueViolations);
 
             return uniqueViolations;
         } catch (final IOException ex) {
             LOG.error("Failed to retrieve unique violations: " + tableId, ex);
             throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
+        } finally {
+            clearFallbackBuffer();
         }
     }
 
@@ -444,16 +479,17 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             final Long now)
     {
         //Clear is destructive, do it before the native call
-        deserializer.clear();
+        clearResultBuffers();
         final int numResults = nativeGetStats(pointer, selector.ordinal(), locators, interval, now);
         if (numResults == -1) {
             throwExceptionForError(ERRORCODE_ERROR);
         }
 
         try {
-            deserializer.readInt();//Ignore the length of the result tables
+            FastDeserializer fds = resultDeserializer();
+            fds.readInt();//Ignore the length of the result tables
 
-            ByteBuffer buf = fallbackBuffer == null ? deserializer.buffer() : fallbackBuffer;
+            ByteBuffer buf = fds.buffer();
             final VoltTable results[] = new VoltTable[numResults];
             for (int ii = 0; ii < numResults; ii++) {
                 int len = buf.getInt();
@@ -465,6 +501,8 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         } catch (final IOException ex) {
             LOG.error("Failed to deserialze result table for getStats" + ex);
             throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
+        } finally {
+            clearFallbackBuffer();
         }
     }
 
@@ -507,7 +545,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                                                       TableStreamType streamType,
                                                       List<BBContainer> outputBuffers) {
         //Clear is destructive, do it before the native call
-        deserializer.clear();
+        clearResultBuffers();
         byte[] bytes = outputBuffers != null
                             ? SnapshotUtil.OutputBuffersToBytes(outputBuffers)
                             : null;
@@ -519,17 +557,20 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         assert(deserializer != null);
         int count;
         try {
-            count = deserializer.readInt();
+            FastDeserializer fds = resultDeserializer();
+            count = fds.readInt();
             if (count > 0) {
                 positions = new int[count];
                 for (int i = 0; i < count; i++) {
-                    positions[i] = deserializer.readInt();
+                    positions[i] = fds.readInt();
                 }
                 return Pair.of(remaining, positions);
             }
         } catch (final IOException ex) {
             LOG.error("Failed to deserialize position array" + ex);
             throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
+        } finally {
+            clearFallbackBuffer();
         }
 
         return Pair.of(remaining, new int[] {0});
@@ -544,7 +585,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             long ackTxnId, long seqNo, int partitionId, String tableSignature)
     {
         //Clear is destructive, do it before the native call
-        deserializer.clear();
+        clearResultBuffers();
         long retval = nativeExportAction(pointer,
                                          syncAction, ackTxnId, seqNo, getStringBytes(tableSignature));
         if (retval < 0) {
@@ -584,6 +625,8 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             throw new RuntimeException(exception); // can't happen
         }
 
+        // Keep the tokens alive so their address can't be reused by another config
+        hashinateConfig = config;
         return nativeHashinate(pointer, config.configPtr, config.numTokens);
     }
 
@@ -627,8 +670,65 @@ public class ExecutionEngineJNI extends ExecutionEngine {
      */
     public void fallbackToEEAllocatedBuffer(ByteBuffer buffer) {
         assert(buffer != null);
-        assert(fallbackBuffer == null);
         fallbackBuffer = buffer;
+        fallbackBufferIsJavaOwned = false;
+    }
+
+    /*
+     * Called by the EE when the results of the next batch overflow the reusable
+     * output buffer, or the previous buffer from this method. The EE writes the
+     * rest of the results straight into the returned buffer and the result tables
+     * are sliced out of it without a copy. The buffer comes from the DBBPool so a
+     * recycled one is neither allocated nor zeroed again; the EE doubles the
+     * requested length on each overflow, which follows the pool's size buckets.
+     */
+    public ByteBuffer allocateResultBuffer(int length) {
+        final BBContainer container = DBBPool.allocateDirectAndPool(length);
+        resultBufferChain.add(container);
+        fallbackBuffer = container.b();
+        fallbackBufferIsJavaOwned = true;
+        return fallbackBuffer;
+    }
+
+    /*
+     * The result tables are slices of the given view of the last buffer in the
+     * chain. Keep that buffer out of the pool until they are all unreachable.
+     */
+    private void handOverResultBuffer(ByteBuffer tablesBacking) {
+        final BBContainer container = resultBufferChain.remove(resultBufferChain.size() - 1);
+        Cleaner.create(tablesBacking, new Runnable() {
+            @Override
+            public void run() {
+                container.discard();
+            }
+        });
+    }
+
+    /*
+     * The output of the last native call: the fallback buffer if the output
+     * overflowed the reusable output buffer, otherwise the reusable buffer.
+     */
+    private FastDeserializer resultDeserializer() {
+        return fallbackBuffer == null ? deserializer : new FastDeserializer(fallbackBuffer);
+    }
+
+    private void clearFallbackBuffer() {
+        fallbackBuffer = null;
+        fallbackBufferIsJavaOwned = false;
+        for (BBContainer container : resultBufferChain) {
+            container.discard();
+        }
+        resultBufferChain.clear();
+    }
+
+    /*
+     * Reset the reusable output buffer and forget any fallback buffer left by an
+     * earlier call, so the output of the next native call is read from the right
+     * place. Clear is destructive, do it before the native call.
+     */
+    private void clearResultBuffers() {
+        deserializer.clear();
+        clearFallbackBuffer();
     }
 
     @Override
@@ -637,12 +737,14 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             psetBuffer.putLong(0, taskType.taskId);
 
             //Clear is destructive, do it before the native call
-            deserializer.clear();
+            clearResultBuffers();
             final int errorCode = nativeExecuteTask(pointer);
             checkErrorCode(errorCode);
-            return (byte[])deserializer.readArray(byte.class);
+            return (byte[])resultDeserializer().readArray(byte.class);
         } catch (IOException e) {
             Throwables.propagate(e);
+        } finally {
+            clearFallbackBuffer();
         }
         return null;
     }
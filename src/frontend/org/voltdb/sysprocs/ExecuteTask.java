@@ -122,6 +122,7 @@ public class ExecuteTask extends VoltSystemProcedure {
                             context.appendApplyBinaryLogTxns(producerClusterId, producerPartitionId, -1L, tracker);
                         }
                     }
+                    context.pushDrAppliedTrackersToEE();
                     result.addRow(STATUS_OK);
 
                 } catch (Exception e) {
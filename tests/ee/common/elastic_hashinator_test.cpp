@@ -23,9 +23,13 @@
 #include "harness.h"
 #include "common/serializeio.h"
 #include "common/ElasticHashinator.h"
+#include "common/Pool.hpp"
 
+#include <algorithm>
 #include <cfloat>
 #include <limits>
+#include <set>
+#include <vector>
 
 using namespace std;
 using namespace voltdb;
@@ -112,6 +116,117 @@ TEST_F(ElasticHashinatorTest, TestNValueHashToken)
     }
 }
 
+// A token spread over the whole int32_t range, computed in 64 bits
+static int32_t randomToken()
+{
+    return static_cast<int32_t>(static_cast<int64_t>(rand()) * 2 - RAND_MAX);
+}
+
+TEST_F(ElasticHashinatorTest, TestEytzingerMatchesLinearSearch)
+{
+    srand(42);
+    for (int tokenCount = 1; tokenCount < 70; tokenCount++) {
+        std::set<int32_t> tokenSet;
+        tokenSet.insert(std::numeric_limits<int32_t>::min());
+        while (tokenSet.size() < tokenCount) {
+            tokenSet.insert(randomToken());
+        }
+        std::vector<int32_t> tokens(tokenSet.begin(), tokenSet.end());
+
+        boost::scoped_array<char> config(new char[4 + (8 * tokenCount)]);
+        ReferenceSerializeOutput output(config.get(), 4 + (8 * tokenCount));
+        output.writeInt(tokenCount);
+        for (int ii = 0; ii < tokenCount; ii++) {
+            output.writeInt(tokens[ii]);
+            output.writeInt(ii);
+        }
+        boost::scoped_ptr<TheHashinator> hashinator(ElasticHashinator::newInstance(config.get(), NULL, 0));
+
+        std::vector<int32_t> probes;
+        for (int ii = 0; ii < tokenCount; ii++) {
+            probes.push_back(tokens[ii]);
+            if (tokens[ii] != std::numeric_limits<int32_t>::max()) {
+                probes.push_back(tokens[ii] + 1);
+            }
+            if (tokens[ii] != std::numeric_limits<int32_t>::min()) {
+                probes.push_back(tokens[ii] - 1);
+            }
+        }
+        probes.push_back(std::numeric_limits<int32_t>::max());
+        for (int ii = 0; ii < 200; ii++) {
+            probes.push_back(randomToken());
+        }
+
+        std::vector<int32_t> batched(probes.size());
+        hashinator->partitionsForTokens(&probes[0], static_cast<int32_t>(probes.size()), &batched[0]);
+        for (int ii = 0; ii < probes.size(); ii++) {
+            int32_t expected = static_cast<int32_t>(
+                    std::upper_bound(tokens.begin(), tokens.end(), probes[ii]) - tokens.begin()) - 1;
+            ASSERT_EQ(expected, hashinator->partitionForToken(probes[ii]));
+            ASSERT_EQ(expected, batched[ii]);
+        }
+    }
+}
+
+TEST_F(ElasticHashinatorTest, TestBatchHashinate)
+{
+    const int tokenCount = 64;
+    boost::scoped_array<char> config(new char[4 + (8 * tokenCount)]);
+    ReferenceSerializeOutput output(config.get(), 4 + (8 * tokenCount));
+    output.writeInt(tokenCount);
+    for (int ii = 0; ii < tokenCount; ii++) {
+        output.writeInt(static_cast<int32_t>(std::numeric_limits<int32_t>::min() + (ii * (UINT32_MAX / tokenCount))));
+        output.writeInt(ii % 8);
+    }
+    boost::scoped_ptr<TheHashinator> hashinator(ElasticHashinator::newInstance(config.get(), NULL, 0));
+
+    Pool pool;
+    std::vector<NValue> values;
+    for (int i = -1000; i < 1000; i++) {
+        values.push_back(ValueFactory::getBigIntValue(i * 7919));
+        values.push_back(ValueFactory::getIntegerValue(i));
+    }
+    values.push_back(ValueFactory::getBigIntValue(INT64_MIN));
+    values.push_back(NValue::getNullValue(VALUE_TYPE_INTEGER));
+    values.push_back(NValue::getNullValue(VALUE_TYPE_VARCHAR));
+    for (int i = 0; i < 300; i++) {
+        std::ostringstream key;
+        key << "key" << i;
+        values.push_back(ValueFactory::getStringValue(key.str().c_str(), &pool));
+    }
+
+    std::vector<int32_t> partitions(values.size());
+    hashinator->partitionsForValues(&values[0], static_cast<int32_t>(values.size()), &partitions[0]);
+    for (int ii = 0; ii < values.size(); ii++) {
+        EXPECT_EQ(hashinator->hashinate(values[ii]), partitions[ii]);
+    }
+}
+
+TEST_F(ElasticHashinatorTest, TestSharesConfig)
+{
+    const uint32_t tokenCount = 4;
+    int32_t tokens[tokenCount * 2];
+    for (int ii = 0; ii < tokenCount; ii++) {
+        tokens[ii * 2] = std::numeric_limits<int32_t>::min() + ii * (UINT32_MAX / tokenCount);
+        tokens[ii * 2 + 1] = ii;
+    }
+    boost::scoped_ptr<TheHashinator> shared(ElasticHashinator::newInstance(NULL, tokens, tokenCount));
+    EXPECT_TRUE(shared->sharesConfig(tokens, tokenCount));
+    EXPECT_FALSE(shared->sharesConfig(tokens, tokenCount - 1));
+    EXPECT_FALSE(shared->sharesConfig(tokens + 2, tokenCount));
+
+    // A hashinator built from serialized config owns a copy of its tokens
+    boost::scoped_array<char> config(new char[4 + (8 * tokenCount)]);
+    ReferenceSerializeOutput output(config.get(), 4 + (8 * tokenCount));
+    output.writeInt(tokenCount);
+    for (int ii = 0; ii < tokenCount * 2; ii++) {
+        output.writeInt(tokens[ii]);
+    }
+    boost::scoped_ptr<TheHashinator> owned(ElasticHashinator::newInstance(config.get(), NULL, 0));
+    EXPECT_FALSE(owned->sharesConfig(tokens, tokenCount));
+    EXPECT_EQ(shared->partitionForToken(0), owned->partitionForToken(0));
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,139 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "harness.h"
+
+#include "common/HyperLogLogSketch.h"
+#include "hyperloglog/hyperloglog.hpp"
+
+using namespace voltdb;
+
+class HyperLogLogSketchTest : public Test {
+public:
+    static void addValues(HyperLogLogSketch& sketch, hll::HyperLogLog& reference,
+                          int64_t first, int64_t count) {
+        for (int64_t value = first; value < first + count; ++value) {
+            sketch.add(reinterpret_cast<const char*>(&value), sizeof(value));
+            reference.add(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+
+    static std::string serialize(const HyperLogLogSketch& sketch) {
+        std::vector<char> buffer(sketch.serializedSize());
+        sketch.serializeTo(&buffer[0]);
+        return std::string(buffer.begin(), buffer.end());
+    }
+};
+
+TEST_F(HyperLogLogSketchTest, SameEstimatesAsDense) {
+    const int64_t counts[] = { 0, 1, 10, 1000, 4000, 20000, 300000 };
+    for (int ii = 0; ii < sizeof(counts) / sizeof(counts[0]); ++ii) {
+        HyperLogLogSketch sketch;
+        hll::HyperLogLog reference(HyperLogLogSketch::REGISTER_BIT_WIDTH);
+        addValues(sketch, reference, 0, counts[ii]);
+        EXPECT_EQ(reference.estimate(), sketch.estimate());
+        EXPECT_EQ(counts[ii] <= 4000, sketch.isSparse());
+    }
+}
+
+TEST_F(HyperLogLogSketchTest, SerializedSketchesAreSmall) {
+    HyperLogLogSketch sketch;
+    hll::HyperLogLog reference(HyperLogLogSketch::REGISTER_BIT_WIDTH);
+    addValues(sketch, reference, 0, 100);
+    std::string bytes = serialize(sketch);
+    // A few bytes per value, rather than a byte per register
+    EXPECT_TRUE(bytes.size() < 400);
+
+    HyperLogLogSketch copy;
+    ASSERT_TRUE(copy.deserializeFrom(bytes.data(), bytes.size()));
+    EXPECT_TRUE(copy.isSparse());
+    EXPECT_EQ(sketch.estimate(), copy.estimate());
+
+    addValues(sketch, reference, 100, 100000);
+    bytes = serialize(sketch);
+    EXPECT_EQ(2 + HyperLogLogSketch::NUM_REGISTERS * 5 / 8, bytes.size());
+    ASSERT_TRUE(copy.deserializeFrom(bytes.data(), bytes.size()));
+    EXPECT_FALSE(copy.isSparse());
+    EXPECT_EQ(reference.estimate(), copy.estimate());
+}
+
+TEST_F(HyperLogLogSketchTest, MergePartitions) {
+    // Overlapping values on each partition, some of them sparse
+    const int64_t firsts[] = { 0, 500, 600, 50000 };
+    const int64_t counts[] = { 1000, 200, 60000, 10 };
+    hll::HyperLogLog reference(HyperLogLogSketch::REGISTER_BIT_WIDTH);
+    HyperLogLogSketch merged;
+    for (int ii = 0; ii < 4; ++ii) {
+        HyperLogLogSketch partition;
+        hll::HyperLogLog partitionReference(HyperLogLogSketch::REGISTER_BIT_WIDTH);
+        addValues(partition, partitionReference, firsts[ii], counts[ii]);
+        reference.merge(partitionReference);
+
+        std::string bytes = serialize(partition);
+        HyperLogLogSketch received;
+        ASSERT_TRUE(received.deserializeFrom(bytes.data(), bytes.size()));
+        merged.merge(received);
+        if (ii == 1) {
+            EXPECT_TRUE(merged.isSparse());
+            EXPECT_EQ(reference.estimate(), merged.estimate());
+        }
+    }
+    EXPECT_FALSE(merged.isSparse());
+    EXPECT_EQ(reference.estimate(), merged.estimate());
+
+    merged.clear();
+    EXPECT_TRUE(merged.isSparse());
+    EXPECT_EQ(0.0, merged.estimate());
+}
+
+TEST_F(HyperLogLogSketchTest, AcceptsDenseDump) {
+    HyperLogLogSketch sketch;
+    hll::HyperLogLog reference(HyperLogLogSketch::REGISTER_BIT_WIDTH);
+    addValues(sketch, reference, 0, 5000);
+    std::ostringstream oss;
+    reference.dump(oss);
+    HyperLogLogSketch copy;
+    ASSERT_TRUE(copy.deserializeFrom(oss.str().data(), oss.str().size()));
+    EXPECT_EQ(reference.estimate(), copy.estimate());
+}
+
+TEST_F(HyperLogLogSketchTest, RejectsGarbage) {
+    HyperLogLogSketch sketch;
+    hll::HyperLogLog reference(HyperLogLogSketch::REGISTER_BIT_WIDTH);
+    addValues(sketch, reference, 0, 100);
+    std::string bytes = serialize(sketch);
+
+    HyperLogLogSketch copy;
+    EXPECT_FALSE(copy.deserializeFrom(bytes.data(), 1));
+    EXPECT_FALSE(copy.deserializeFrom(bytes.data(), bytes.size() - 1));
+    std::string longer = bytes + '\x01';
+    EXPECT_FALSE(copy.deserializeFrom(longer.data(), longer.size()));
+    std::string wrongWidth = bytes;
+    wrongWidth[1] = 12;
+    EXPECT_FALSE(copy.deserializeFrom(wrongWidth.data(), wrongWidth.size()));
+    std::string unknownFormat = bytes;
+    unknownFormat[0] = 'x';
+    EXPECT_FALSE(copy.deserializeFrom(unknownFormat.data(), unknownFormat.size()));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,117 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "harness.h"
+
+#include "common/LikeMatcher.h"
+#include "common/NValue.hpp"
+#include "common/ThreadLocalPool.h"
+#include "common/ValueFactory.hpp"
+
+using namespace voltdb;
+
+class LikeMatcherTest : public Test {
+protected:
+    static LikeMatcher::Kind kindOf(const std::string &pattern) {
+        LikeMatcher matcher;
+        matcher.prepare(pattern.data(), static_cast<int32_t>(pattern.size()));
+        return matcher.kind();
+    }
+
+    // Random text over a few one and multi byte characters
+    static std::string randomText(int maxCharacters, bool withPercent) {
+        static const char *pieces[] = { "a", "b", "é", "一", "%" };
+        const int pieceCount = withPercent ? 5 : 4;
+        std::string text;
+        int characters = rand() % (maxCharacters + 1);
+        for (int i = 0; i < characters; i++) {
+            text += pieces[rand() % pieceCount];
+        }
+        return text;
+    }
+
+    // for the persistent strings compared with NValue::like
+    ThreadLocalPool m_pool;
+};
+
+TEST_F(LikeMatcherTest, Classification) {
+    EXPECT_EQ(LikeMatcher::EXACT, kindOf(""));
+    EXPECT_EQ(LikeMatcher::EXACT, kindOf("abc"));
+    EXPECT_EQ(LikeMatcher::PREFIX, kindOf("abc%"));
+    EXPECT_EQ(LikeMatcher::PREFIX, kindOf("abc%%"));
+    EXPECT_EQ(LikeMatcher::SUFFIX, kindOf("%abc"));
+    EXPECT_EQ(LikeMatcher::CONTAINS, kindOf("%abc%"));
+    EXPECT_EQ(LikeMatcher::SEGMENTS, kindOf("%"));
+    EXPECT_EQ(LikeMatcher::SEGMENTS, kindOf("a%c"));
+    EXPECT_EQ(LikeMatcher::SEGMENTS, kindOf("%a%b%"));
+    EXPECT_EQ(LikeMatcher::GENERAL, kindOf("a_c"));
+    EXPECT_EQ(LikeMatcher::GENERAL, kindOf("%a_%"));
+}
+
+TEST_F(LikeMatcherTest, FindSubstring) {
+    std::string haystack;
+    for (int i = 0; i < 100; i++) {
+        haystack += static_cast<char>('a' + (i * 7) % 5);
+    }
+    for (size_t start = 0; start < haystack.size(); start++) {
+        for (size_t length = 1; length <= 20 && start + length <= haystack.size(); length++) {
+            std::string needle = haystack.substr(start, length);
+            const char *found = LikeMatcher::findSubstring(haystack.data(), haystack.size(),
+                                                           needle.data(), needle.size());
+            ASSERT_TRUE(found != NULL);
+            EXPECT_EQ(haystack.find(needle), static_cast<size_t>(found - haystack.data()));
+        }
+    }
+    EXPECT_TRUE(LikeMatcher::findSubstring(haystack.data(), haystack.size(), "zz", 2) == NULL);
+    // a match at the very end, beyond the last full 16 byte block
+    std::string tail = haystack + "xyz";
+    EXPECT_EQ(tail.size() - 3, static_cast<size_t>(
+            LikeMatcher::findSubstring(tail.data(), tail.size(), "xyz", 3) - tail.data()));
+}
+
+/**
+ * The matcher agrees with NValue::like on random patterns and values.
+ */
+TEST_F(LikeMatcherTest, AgreesWithLike) {
+    srand(42);
+    LikeMatcher matcher;
+    for (int p = 0; p < 300; p++) {
+        std::string pattern = randomText(6, true);
+        matcher.prepare(pattern.data(), static_cast<int32_t>(pattern.size()));
+        ASSERT_FALSE(matcher.isGeneral());
+        NValue patternValue = ValueFactory::getStringValue(pattern);
+        for (int v = 0; v < 50; v++) {
+            std::string value = randomText(v < 40 ? 8 : 40, false);
+            NValue valueValue = ValueFactory::getStringValue(value);
+            bool expected = valueValue.like(patternValue).isTrue();
+            bool matched = matcher.matches(value.data(), static_cast<int32_t>(value.size()));
+            if (expected != matched) {
+                printf("'%s' LIKE '%s' should be %d\n", value.c_str(), pattern.c_str(), expected);
+            }
+            EXPECT_EQ(expected, matched);
+            valueValue.free();
+        }
+        patternValue.free();
+    }
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -1951,6 +1951,82 @@ TEST_F(NValueTest, DecimalQuotients) {
    }
 }
 
+/*
+ * Small decimals take the native 128 bit path, large ones ttmath's;
+ * the results must not depend on which.
+ */
+TEST_F(NValueTest, DecimalArithmeticAcrossOperandSizes) {
+    const char* small[] = { "0", "1", "-1", "0.000000000001", "-3.5", "1234567.891234567891", "-9999999.999999999999" };
+    const char* large[] = { "12345678901234567.89", "-98765432109876543210.5", "99999999999999999999999999.999999999999" };
+    for (size_t i = 0; i < sizeof(small) / sizeof(small[0]); i++) {
+        for (size_t j = 0; j < sizeof(small) / sizeof(small[0]); j++) {
+            NValue lhs = ValueFactory::getDecimalValueFromString(small[i]);
+            NValue rhs = ValueFactory::getDecimalValueFromString(small[j]);
+            TTInt lhsValue = ValuePeeker::peekDecimal(lhs);
+            TTInt rhsValue = ValuePeeker::peekDecimal(rhs);
+
+            TTInt expected(lhsValue);
+            expected.Add(rhsValue);
+            ASSERT_EQ(expected, ValuePeeker::peekDecimal(lhs.op_add(rhs)));
+            expected = lhsValue;
+            expected.Sub(rhsValue);
+            ASSERT_EQ(expected, ValuePeeker::peekDecimal(lhs.op_subtract(rhs)));
+
+            TTLInt product;
+            product.FromInt(lhsValue);
+            product *= rhsValue;
+            product /= NValue::kMaxScaleFactor;
+            expected.FromInt(product);
+            ASSERT_EQ(expected, ValuePeeker::peekDecimal(lhs.op_multiply(rhs)));
+
+            if ( ! rhsValue.IsZero()) {
+                TTLInt quotient;
+                quotient.FromInt(lhsValue);
+                quotient *= NValue::kMaxScaleFactor;
+                quotient.Div(rhsValue);
+                expected.FromInt(quotient);
+                ASSERT_EQ(expected, ValuePeeker::peekDecimal(lhs.op_divide(rhs)));
+            }
+
+            int order = lhsValue == rhsValue ? VALUE_COMPARE_EQUAL :
+                        (lhsValue > rhsValue ? VALUE_COMPARE_GREATERTHAN : VALUE_COMPARE_LESSTHAN);
+            ASSERT_EQ(order, lhs.compare(rhs));
+
+            NValue sum = lhs;
+            sum.op_add_in_place(rhs);
+            ASSERT_EQ(0, sum.compare(lhs.op_add(rhs)));
+        }
+    }
+
+    // products and quotients of large operands still fall back, or overflow
+    NValue big = ValueFactory::getDecimalValueFromString(large[0]);
+    NValue ans = ValueFactory::getDecimalValueFromString("121932631124828532111263.5269");
+    ASSERT_EQ(0, ans.compare(big.op_multiply(ValueFactory::getDecimalValueFromString("9876543.21"))));
+    ans = ValueFactory::getDecimalValueFromString("-123456789012345678.9");
+    ASSERT_EQ(0, ans.compare(big.op_divide(ValueFactory::getDecimalValueFromString("-0.1"))));
+    NValue bigger = ValueFactory::getDecimalValueFromString(large[1]);
+    ASSERT_EQ(VALUE_COMPARE_LESSTHAN, bigger.compare(big));
+
+    NValue max = ValueFactory::getDecimalValueFromString(large[2]);
+    bool caughtException = false;
+    try {
+        max.op_multiply(ValueFactory::getDecimalValueFromString("1.000000000001"));
+    } catch (SQLException& ex) {
+        caughtException = true;
+    }
+    ASSERT_TRUE(caughtException);
+
+    // a running sum that overflows throws as op_add does
+    NValue sum = max;
+    caughtException = false;
+    try {
+        sum.op_add_in_place(ValueFactory::getDecimalValueFromString("0.000000000001"));
+    } catch (SQLException& ex) {
+        caughtException = true;
+    }
+    ASSERT_TRUE(caughtException);
+}
+
 TEST_F(NValueTest, SerializeToExport)
 {
     // test basic nvalue elt serialization. Note that
@@ -2146,6 +2222,8 @@ TEST_F(NValueTest, TestLike)
     testExpressions.push_back("%defg"); testMatches.push_back(1);
     testExpressions.push_back("%de%"); testMatches.push_back(1);
     testExpressions.push_back("%%g"); testMatches.push_back(1);
+    testExpressions.push_back("aaaaaaa%%"); testMatches.push_back(1);
+    testExpressions.push_back("%g%%%"); testMatches.push_back(1);
     testExpressions.push_back("%_a%"); testMatches.push_back(1);
     testExpressions.push_back("%__c%"); testMatches.push_back(2);
     testExpressions.push_back("a_%c%"); testMatches.push_back(2);
@@ -2419,6 +2497,56 @@ TEST_F(NValueTest, TestExtract)
 
 }
 
+TEST_F(NValueTest, TestCivilDateArithmetic)
+{
+    // Check the table-free conversions against boost across the range of timestamps.
+    const int64_t step = 1000 * MICROS_PER_DAY + 37 * MICROS_PER_HOUR + 123457;
+    for (int64_t epoch_micros = GREGORIAN_EPOCH; epoch_micros <= NYE9999; epoch_micros += step) {
+        boost::posix_time::ptime ptime = EPOCH + boost::posix_time::microseconds(epoch_micros);
+        boost::gregorian::date date = ptime.date();
+        int year, month, day;
+        micros_to_civil(epoch_micros, year, month, day);
+        EXPECT_EQ(date.year(), year);
+        EXPECT_EQ(date.month(), month);
+        EXPECT_EQ(date.day(), day);
+        EXPECT_EQ(days_from_civil(year, month, day), floor_div(epoch_micros, MICROS_PER_DAY));
+        EXPECT_EQ(ptime.time_of_day().total_microseconds(), micros_of_day(epoch_micros));
+
+        boost::posix_time::ptime month_start(boost::gregorian::date(year, month, 1));
+        EXPECT_EQ((month_start - EPOCH).total_microseconds(), truncate_micros_to_month(epoch_micros));
+        boost::posix_time::ptime hour_start(date, boost::posix_time::hours(ptime.time_of_day().hours()));
+        EXPECT_EQ((hour_start - EPOCH).total_microseconds(), truncate_micros_to_hour(epoch_micros));
+
+        boost::gregorian::date monday =
+            (EPOCH + boost::posix_time::microseconds(truncate_micros_to_week(epoch_micros))).date();
+        EXPECT_EQ(1, monday.day_of_week());
+        EXPECT_TRUE((date - monday).days() >= 0 && (date - monday).days() < 7);
+
+        // the end of a month stays the end of a month, as with boost
+        if (year < 9998) {
+            boost::posix_time::ptime later = ptime + boost::gregorian::months(13);
+            EXPECT_EQ((later - EPOCH).total_microseconds(), addMonths(epoch_micros, 13));
+        }
+    }
+
+    // 2016-01-31 + 1 month, and 2016-02-29 + 1 year
+    EXPECT_EQ(days_from_civil(2016, 2, 29) * MICROS_PER_DAY,
+              addMonths(days_from_civil(2016, 1, 31) * MICROS_PER_DAY, 1));
+    EXPECT_EQ(days_from_civil(2017, 2, 28) * MICROS_PER_DAY,
+              addMonths(days_from_civil(2016, 2, 29) * MICROS_PER_DAY, 12));
+
+    int64_t timestamps[] = { 1000000000000000, INT64_NULL, -1 };
+    int64_t hours[3];
+    truncate_micros_batch(truncate_micros_to_hour, timestamps, hours, 3);
+    EXPECT_EQ(days_from_civil(2001, 9, 9) * MICROS_PER_DAY + 3600000000LL, hours[0]);
+    EXPECT_EQ(INT64_NULL, hours[1]);
+    EXPECT_EQ(-3600000000LL, hours[2]);
+    truncate_micros_batch(truncate_micros_to_day, timestamps, timestamps, 3);
+    EXPECT_EQ(days_from_civil(2001, 9, 9) * MICROS_PER_DAY, timestamps[0]);
+    EXPECT_EQ(INT64_NULL, timestamps[1]);
+    EXPECT_EQ(-MICROS_PER_DAY, timestamps[2]);
+}
+
 static NValue streamNValueArrayintoInList(ValueType vt, NValue* nvalue, int length, Pool* testPool)
 {
     char serial_buffer[1024];
@@ -49,9 +49,16 @@
  */
 
 #include <limits>
+#include <new>
 #include <string>
+#include <vector>
 #include "harness.h"
+#include "common/executorcontext.hpp"
+#include "common/Pool.hpp"
 #include "common/serializeio.h"
+#include "common/Topend.h"
+
+#include "boost/shared_array.hpp"
 
 using namespace std;
 using namespace voltdb;
@@ -138,6 +145,116 @@ TEST(SerializeOutput, ReserveBytes) {
     EXPECT_EQ(0, memcmp(static_cast<const char*>(out.data()) + 1, &DATA, sizeof(DATA)));
 }
 
+class ResultBufferTopend : public DummyTopend {
+public:
+    ResultBufferTopend(bool provideBuffers) :
+        m_provideBuffers(provideBuffers), m_failAfter(-1), m_fallbackBuffer(NULL) {}
+
+    char* allocateResultBuffer(size_t length) {
+        if (m_failAfter == 0) {
+            throw std::bad_alloc();
+        }
+        --m_failAfter;
+        if (!m_provideBuffers) {
+            return NULL;
+        }
+        // Like the Java engine, keep the earlier buffers: the EE copies the
+        // results written so far out of the previous one
+        m_resultBuffers.push_back(boost::shared_array<char>(new char[length]));
+        m_lengths.push_back(length);
+        return m_resultBuffers.back().get();
+    }
+
+    void fallbackToEEAllocatedBuffer(char *buffer, size_t length) {
+        m_fallbackBuffer = buffer;
+        m_lengths.push_back(length);
+    }
+
+    bool m_provideBuffers;
+    // Number of calls to allocateResultBuffer before it throws, -1 to never throw
+    int m_failAfter;
+    std::vector<boost::shared_array<char> > m_resultBuffers;
+    std::vector<size_t> m_lengths;
+    char *m_fallbackBuffer;
+};
+
+class FallbackSerializeOutputTest : public Test {
+protected:
+    void expandIntoFallbackBuffer(ResultBufferTopend &topend) {
+        Pool pool;
+        ExecutorContext context(0, 0, NULL, &topend, &pool, NULL, NULL, "", 0, NULL, NULL, 0);
+
+        char reusedBuffer[16];
+        FallbackSerializeOutput out;
+        out.initializeWithPosition(reusedBuffer, sizeof(reusedBuffer), 0);
+        for (int64_t i = 0; i < 8; ++i) {
+            out.writeLong(i);
+        }
+        EXPECT_EQ(8 * sizeof(int64_t), out.size());
+
+        // Expanded several times, doubling the buffer each time
+        ASSERT_EQ(2, topend.m_lengths.size());
+        EXPECT_EQ(2 * sizeof(reusedBuffer), topend.m_lengths[0]);
+        EXPECT_EQ(4 * sizeof(reusedBuffer), topend.m_lengths[1]);
+        if (topend.m_provideBuffers) {
+            EXPECT_EQ(topend.m_resultBuffers.back().get(), out.data());
+            EXPECT_TRUE(topend.m_fallbackBuffer == NULL);
+        }
+        else {
+            EXPECT_EQ(topend.m_fallbackBuffer, out.data());
+        }
+        ReferenceSerializeInputBE in(out.data(), out.size());
+        for (int64_t i = 0; i < 8; ++i) {
+            EXPECT_EQ(i, in.readLong());
+        }
+
+        // Starting over drops the fallback buffer
+        out.initializeWithPosition(reusedBuffer, sizeof(reusedBuffer), 0);
+        EXPECT_EQ(reusedBuffer, out.data());
+    }
+};
+
+TEST_F(FallbackSerializeOutputTest, EEAllocatedBuffer) {
+    ResultBufferTopend topend(false);
+    expandIntoFallbackBuffer(topend);
+}
+
+TEST_F(FallbackSerializeOutputTest, TopendResultBuffer) {
+    ResultBufferTopend topend(true);
+    expandIntoFallbackBuffer(topend);
+}
+
+TEST_F(FallbackSerializeOutputTest, TopendThrows) {
+    // The first expansion falls back to an EE allocated buffer, the second one
+    // fails and must leave that buffer with the output so it is freed with it
+    ResultBufferTopend topend(false);
+    topend.m_failAfter = 1;
+    Pool pool;
+    ExecutorContext context(0, 0, NULL, &topend, &pool, NULL, NULL, "", 0, NULL, NULL, 0);
+
+    char reusedBuffer[16];
+    FallbackSerializeOutput out;
+    out.initializeWithPosition(reusedBuffer, sizeof(reusedBuffer), 0);
+    for (int64_t i = 0; i < 4; ++i) {
+        out.writeLong(i);
+    }
+    EXPECT_EQ(topend.m_fallbackBuffer, out.data());
+
+    bool threw = false;
+    try {
+        out.writeLong(4);
+    }
+    catch (const std::bad_alloc &) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    EXPECT_EQ(topend.m_fallbackBuffer, out.data());
+    ReferenceSerializeInputBE in(out.data(), out.size());
+    for (int64_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(i, in.readLong());
+    }
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -156,6 +156,88 @@ TEST_F(TableTupleTest, ToJsonArray)
     nvalVisibleString.free();
 }
 
+TEST_F(TableTupleTest, KeyLayout)
+{
+    TupleSchemaBuilder builder(5);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(1, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(2, VALUE_TYPE_DOUBLE);
+    builder.setColumnAtIndex(3, VALUE_TYPE_VARCHAR, 10);
+    builder.setColumnAtIndex(4, VALUE_TYPE_VARCHAR, 256);
+    ScopedTupleSchema schema(builder.build());
+    TupleKeyLayout layout(schema.get());
+
+    StandAloneTupleStorage lhsStorage(schema.get());
+    StandAloneTupleStorage rhsStorage(schema.get());
+    const TableTuple& lhs = lhsStorage.tuple();
+    const TableTuple& rhs = rhsStorage.tuple();
+
+    NValue lhsString = ValueFactory::getStringValue("no matter how long");
+    NValue rhsString = ValueFactory::getStringValue("no matter how long");
+    NValue shortString = ValueFactory::getStringValue("short");
+    NValue emptyString = ValueFactory::getStringValue("");
+    lhs.setNValue(0, ValueFactory::getBigIntValue(-5));
+    lhs.setNValue(1, ValueFactory::getNullValue());
+    lhs.setNValue(2, ValueFactory::getDoubleValue(0.0));
+    lhs.setNValue(3, shortString);
+    lhs.setNValue(4, lhsString);
+    rhs.setNValue(0, ValueFactory::getBigIntValue(-5));
+    rhs.setNValue(1, ValueFactory::getNullValue());
+    // -0.0 has other bytes than 0.0, but is equal to it
+    rhs.setNValue(2, ValueFactory::getDoubleValue(-0.0));
+    rhs.setNValue(3, shortString);
+    rhs.setNValue(4, rhsString);
+
+    EXPECT_TRUE(layout.equals(lhs, rhs));
+    EXPECT_EQ(layout.hash(lhs), layout.hash(rhs));
+    EXPECT_TRUE(lhs.equalsNoSchemaCheck(rhs));
+
+    rhs.setNValue(1, ValueFactory::getIntegerValue(0));
+    EXPECT_FALSE(layout.equals(lhs, rhs));
+    rhs.setNValue(1, ValueFactory::getNullValue());
+
+    // NULL is not the empty string
+    lhs.setNValue(3, emptyString);
+    rhs.setNValue(3, ValueFactory::getNullValue());
+    EXPECT_FALSE(layout.equals(lhs, rhs));
+    EXPECT_NE(layout.hash(lhs), layout.hash(rhs));
+    lhs.setNValue(3, ValueFactory::getNullValue());
+    EXPECT_TRUE(layout.equals(lhs, rhs));
+    EXPECT_EQ(layout.hash(lhs), layout.hash(rhs));
+
+    // Hashers given the same layout find equal keys.
+    boost::shared_ptr<const TupleKeyLayout> shared(new TupleKeyLayout(schema.get()));
+    TableTupleHasher hasher(shared);
+    TableTupleEqualityChecker checker(shared);
+    EXPECT_EQ(hasher(lhs), hasher(rhs));
+    EXPECT_TRUE(checker(lhs, rhs));
+
+    // A layout fits schemas with the same types and fixed-width columns in the same places.
+    TupleSchemaBuilder longerBuilder(5);
+    longerBuilder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    longerBuilder.setColumnAtIndex(1, VALUE_TYPE_INTEGER);
+    longerBuilder.setColumnAtIndex(2, VALUE_TYPE_DOUBLE);
+    longerBuilder.setColumnAtIndex(3, VALUE_TYPE_VARCHAR, 200);
+    longerBuilder.setColumnAtIndex(4, VALUE_TYPE_VARCHAR, 20);
+    ScopedTupleSchema longerSchema(longerBuilder.build());
+    EXPECT_TRUE(layout.fits(schema.get()));
+    EXPECT_TRUE(layout.fits(longerSchema.get()));
+
+    TupleSchemaBuilder otherBuilder(5);
+    otherBuilder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    otherBuilder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    otherBuilder.setColumnAtIndex(2, VALUE_TYPE_DOUBLE);
+    otherBuilder.setColumnAtIndex(3, VALUE_TYPE_VARCHAR, 10);
+    otherBuilder.setColumnAtIndex(4, VALUE_TYPE_VARCHAR, 256);
+    ScopedTupleSchema otherSchema(otherBuilder.build());
+    EXPECT_FALSE(layout.fits(otherSchema.get()));
+
+    lhsString.free();
+    rhsString.free();
+    shortString.free();
+    emptyString.free();
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
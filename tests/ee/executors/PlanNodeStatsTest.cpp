@@ -0,0 +1,153 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "harness.h"
+
+#include "common/executorcontext.hpp"
+#include "common/Pool.hpp"
+#include "common/ThreadLocalPool.h"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
+#include "executors/PlanNodeStats.h"
+#include "stats/StatsAgent.h"
+#include "storage/temptable.h"
+
+#include "boost/scoped_ptr.hpp"
+
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+class PlanNodeStatsTest : public Test
+{
+public:
+    PlanNodeStatsTest()
+    {
+        m_pool.reset(new Pool());
+        m_executorContext.reset(new ExecutorContext(0,             // siteId
+                                                    0,             // partitionId
+                                                    NULL,          // undoQuantum
+                                                    NULL,          // topend
+                                                    m_pool.get(),  // tempStringPool
+                                                    NULL,          // params
+                                                    NULL,          // engine
+                                                    "",            // hostname
+                                                    0,             // hostId
+                                                    NULL,          // drTupleStream
+                                                    NULL,          // drReplicatedStream
+                                                    0));           // drClusterId
+    }
+
+protected:
+    static int64_t column(TableTuple* tuple, int index)
+    {
+        return ValuePeeker::peekAsBigInt(tuple->getNValue(index));
+    }
+
+    ThreadLocalPool m_threadLocalPool;
+    boost::scoped_ptr<Pool> m_pool;
+    boost::scoped_ptr<ExecutorContext> m_executorContext;
+};
+
+TEST_F(PlanNodeStatsTest, CountersAndIntervals)
+{
+    PlanNodeStats stats;
+    EXPECT_FALSE(stats.isConfigured());
+    stats.configure(12345, 3, "INDEXSCAN");
+    EXPECT_TRUE(stats.isConfigured());
+
+    stats.recordExecution(10, 4, 1000, 131072);
+    stats.recordExecution(20, 6, 500, 65536);
+    stats.countIndexProbes(7);
+
+    std::vector<std::string> names = PlanNodeStats::generatePlanNodeStatsColumnNames();
+    int fragmentIdCol = 5;
+    ASSERT_EQ(std::string("FRAGMENT_ID"), names[fragmentIdCol]);
+
+    TableTuple* tuple = stats.getStatsTuple(true, 1);
+    EXPECT_EQ(12345, column(tuple, fragmentIdCol));
+    EXPECT_EQ(3, column(tuple, fragmentIdCol + 1));
+    int32_t length;
+    const char* type = ValuePeeker::peekObject_withoutNull(tuple->getNValue(fragmentIdCol + 2), &length);
+    EXPECT_EQ(std::string("INDEXSCAN"), std::string(type, length));
+    EXPECT_EQ(2, column(tuple, fragmentIdCol + 3));       // INVOCATIONS
+    EXPECT_EQ(30, column(tuple, fragmentIdCol + 4));      // ROWS_IN
+    EXPECT_EQ(10, column(tuple, fragmentIdCol + 5));      // ROWS_OUT
+    EXPECT_EQ(1500, column(tuple, fragmentIdCol + 6));    // CPU_CYCLES
+    EXPECT_EQ(131072, column(tuple, fragmentIdCol + 7));  // PEAK_TEMP_TABLE_BYTES
+    EXPECT_EQ(7, column(tuple, fragmentIdCol + 8));       // INDEX_PROBES
+
+    // Interval counters start over after each interval read
+    stats.recordExecution(1, 1, 50, 4096);
+    tuple = stats.getStatsTuple(true, 2);
+    EXPECT_EQ(1, column(tuple, fragmentIdCol + 3));
+    EXPECT_EQ(1, column(tuple, fragmentIdCol + 4));
+    EXPECT_EQ(50, column(tuple, fragmentIdCol + 6));
+    EXPECT_EQ(4096, column(tuple, fragmentIdCol + 7));
+    EXPECT_EQ(0, column(tuple, fragmentIdCol + 8));
+
+    // ... but totals do not
+    tuple = stats.getStatsTuple(false, 3);
+    EXPECT_EQ(3, column(tuple, fragmentIdCol + 3));
+    EXPECT_EQ(31, column(tuple, fragmentIdCol + 4));
+    EXPECT_EQ(1550, column(tuple, fragmentIdCol + 6));
+}
+
+TEST_F(PlanNodeStatsTest, StatsAgent)
+{
+    PlanNodeStats root;
+    PlanNodeStats child;
+    root.configure(1, 1, "SEND");
+    child.configure(1, 2, "SEQSCAN");
+    child.recordExecution(0, 100, 10, 0);
+    root.recordExecution(100, 0, 10, 0);
+
+    StatsAgent agent;
+    agent.registerStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE, 0, &root);
+    agent.registerStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE, 0, &child);
+    std::vector<CatalogId> locators(1, 0);
+    TempTable* result = agent.getStats(STATISTICS_SELECTOR_TYPE_PLAN_NODE, locators, false, 0);
+    ASSERT_TRUE(result != NULL);
+    EXPECT_EQ(2, result->activeTupleCount());
+    EXPECT_EQ(PlanNodeStats::generatePlanNodeStatsColumnNames().size(), result->columnCount());
+
+    // An evicted plan takes only its own plan nodes out of the stats
+    agent.unregisterStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE, 0, &child);
+    result = agent.getStats(STATISTICS_SELECTOR_TYPE_PLAN_NODE, locators, false, 0);
+    ASSERT_TRUE(result != NULL);
+    EXPECT_EQ(1, result->activeTupleCount());
+    // Drop the registrations before the sources go away
+    agent.unregisterStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_NODE);
+}
+
+TEST_F(PlanNodeStatsTest, CycleCounterAdvances)
+{
+    uint64_t start = PlanNodeStats::readCycleCounter();
+    volatile int64_t sum = 0;
+    for (int ii = 0; ii < 100000; ++ii) {
+        sum += ii;
+    }
+    EXPECT_TRUE(PlanNodeStats::readCycleCounter() > start);
+}
+
+} // namespace voltdb
+
+int main()
+{
+    return TestSuite::globalInstance()->runAll();
+}
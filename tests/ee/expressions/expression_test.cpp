@@ -61,7 +61,10 @@
 
 #include "expressions/abstractexpression.h"
 #include "expressions/expressions.h"
+#include "expressions/expressionutil.h"
 #include "common/types.h"
+#include "common/Pool.hpp"
+#include "common/ThreadLocalPool.h"
 #include "common/ValuePeeker.hpp"
 #include "common/PlannerDomValue.h"
 
@@ -453,6 +456,58 @@ TEST_F(ExpressionTest, Timestamp) {
 
 }
 
+/*
+ * Show that only constant and parameter patterns get the cached LIKE
+ * matcher, and that a pattern taken from the tuple is used row by row.
+ */
+TEST_F(ExpressionTest, LikePatternSource) {
+    // for the constant's pattern
+    ThreadLocalPool threadLocalPool;
+    vector<voltdb::ValueType> types(2, voltdb::VALUE_TYPE_VARCHAR);
+    vector<int32_t> columnSizes(2, 16);
+    vector<bool> allowNull(2, true);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+    boost::scoped_array<char> tupleStorage(new char[schema->tupleLength() + TUPLE_HEADER_SIZE]);
+    TableTuple t(tupleStorage.get(), schema);
+    Pool pool;
+    PlannerDomRoot domRoot("{}");
+
+    boost::scoped_ptr<AbstractExpression> constLike(
+        ExpressionUtil::comparisonFactory(domRoot.rootObject(), EXPRESSION_TYPE_COMPARE_LIKE,
+                                          new TupleValueExpression(0, 0),
+                                          new ConstantValueExpression(ValueFactory::getStringValue("ab%"))));
+    ASSERT_TRUE(dynamic_cast<LikeExpression*>(constLike.get()) != NULL);
+
+    boost::scoped_ptr<AbstractExpression> paramLike(
+        ExpressionUtil::comparisonFactory(domRoot.rootObject(), EXPRESSION_TYPE_COMPARE_LIKE,
+                                          new TupleValueExpression(0, 0),
+                                          new ParameterValueExpression(0, NULL)));
+    ASSERT_TRUE(dynamic_cast<LikeExpression*>(paramLike.get()) != NULL);
+
+    boost::scoped_ptr<AbstractExpression> columnLike(
+        ExpressionUtil::comparisonFactory(domRoot.rootObject(), EXPRESSION_TYPE_COMPARE_LIKE,
+                                          new TupleValueExpression(0, 0),
+                                          new TupleValueExpression(0, 1)));
+    ASSERT_TRUE(dynamic_cast<LikeExpression*>(columnLike.get()) == NULL);
+
+    const char *rows[][2] = {
+        { "abcd", "ab%" },
+        { "abcd", "%cd" },
+        { "abcd", "%x%" },
+        { "xabc", "ab%" },
+        { "abcd", "a_cd" }
+    };
+    const bool columnExpected[] = { true, true, false, false, true };
+    const bool constExpected[] = { true, true, true, false, true };
+    for (int ii = 0; ii < 5; ii++) {
+        t.setNValue(0, ValueFactory::getStringValue(rows[ii][0], &pool));
+        t.setNValue(1, ValueFactory::getStringValue(rows[ii][1], &pool));
+        EXPECT_EQ(columnExpected[ii], columnLike->eval(&t, NULL).isTrue());
+        EXPECT_EQ(constExpected[ii], constLike->eval(&t, NULL).isTrue());
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
 int main() {
      return TestSuite::globalInstance()->runAll();
 }
@@ -51,6 +51,7 @@
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <boost/ptr_container/ptr_vector.hpp>
 #include "harness.h"
 
 #include "expressions/abstractexpression.h"
@@ -67,6 +68,10 @@
 #include "expressions/expressionutil.h"
 #include "expressions/functionexpression.h"
 #include "expressions/constantvalueexpression.h"
+#include "expressions/expressionoptimizer.h"
+#include "expressions/memoizedexpression.h"
+#include "expressions/JsonPathEvaluator.h"
+#include "expressions/RegexpPatternCache.h"
 
 using namespace voltdb;
 
@@ -83,12 +88,13 @@ struct FunctionTest : public Test {
         FunctionTest() :
                 Test(),
                 m_pool(),
+                m_params(1),
                 m_executorContext(0,
                                   0,
                                   (UndoQuantum *)0,
                                   (Topend *)0,
                                   &m_pool,
-                                  NULL,
+                                  &m_params,
                                   (VoltDBEngine *)0,
                                   "localhost",
                                   0,
@@ -141,9 +147,26 @@ struct FunctionTest : public Test {
         template <typename LEFT_INPUT_TYPE, typename MIDDLE_INPUT_TYPE, typename RIGHT_INPUT_TYPE, typename OUTPUT_TYPE>
         int testTernary(int operation, LEFT_INPUT_TYPE left_input, MIDDLE_INPUT_TYPE middle_input, RIGHT_INPUT_TYPE right_input, OUTPUT_TYPE output, bool expect_null = false);
 
+        /**
+         * Set the parameter and the txn time, then start an execution
+         * the way the executors of a fragment would.
+         */
+        void startExecution(int64_t param, int64_t uniqueId) {
+            m_params[0] = ValueFactory::getBigIntValue(param);
+            m_executorContext.setupForPlanFragments(NULL, 0, 0, 0, uniqueId);
+            ++m_executorContext.m_executionCount;
+        }
+
+        /** Change the parameter and the txn time without starting an execution. */
+        void changeWithinExecution(int64_t param, int64_t uniqueId) {
+            m_params[0] = ValueFactory::getBigIntValue(param);
+            m_executorContext.setupForPlanFragments(NULL, 0, 0, 0, uniqueId);
+        }
+
         static const int64_t BIGINT_SIZE = int64_t(sizeof(int64_t) * CHAR_BIT);
 private:
         Pool            m_pool;
+        NValueArray     m_params;
         ExecutorContext m_executorContext;
 };
 
@@ -739,6 +762,100 @@ TEST_F(FunctionTest, RegularExpressionMatch) {
     ASSERT_EQ(testBinary(FUNC_VOLT_REGEXP_POSITION, testUTF8String, "[a-z]家", 0), 0);
 }
 
+TEST_F(FunctionTest, RegularExpressionPatternCache) {
+    std::string testString("TEST reGexp_poSiTion123456Test");
+    RegexpPatternCache &cache = ExecutorContext::getExecutorContext()->regexpPatternCache();
+    const int64_t compiled = cache.compileCount();
+
+    // The pattern is compiled once for all rows
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(testBinary(FUNC_VOLT_REGEXP_POSITION, testString, std::string("[a-z](\\d+)[A-Z]"), 20), 0);
+    }
+    EXPECT_EQ(compiled + 1, cache.compileCount());
+    // Different flags make a different pattern
+    ASSERT_EQ(testTernary(FUNC_VOLT_REGEXP_POSITION, testString, std::string("[a-z](\\d+)[A-Z]"), "i", 20), 0);
+    ASSERT_EQ(testTernary(FUNC_VOLT_REGEXP_POSITION, testString, std::string("[a-z](\\d+)[A-Z]"), "i", 20), 0);
+    EXPECT_EQ(compiled + 2, cache.compileCount());
+
+    // Crowd the pattern out of the cache, after which it is compiled again
+    for (int i = 0; i < RegexpPatternCache::CAPACITY; i++) {
+        std::ostringstream pattern;
+        pattern << "position(\\d{" << i + 1 << "})";
+        ASSERT_EQ(testBinary(FUNC_VOLT_REGEXP_POSITION, testString, pattern.str(), 0), 0);
+    }
+    EXPECT_EQ(RegexpPatternCache::CAPACITY, cache.size());
+    const int64_t crowded = cache.compileCount();
+    ASSERT_EQ(testBinary(FUNC_VOLT_REGEXP_POSITION, testString, std::string("[a-z](\\d+)[A-Z]"), 20), 0);
+    EXPECT_EQ(crowded + 1, cache.compileCount());
+
+    // A pattern that fails to compile is not cached
+    for (int i = 0; i < 2; i++) {
+        bool sawexception = false;
+        try {
+            testBinary(FUNC_VOLT_REGEXP_POSITION, testString, std::string("[a-z](a]"), 0);
+        } catch (voltdb::SQLException &ex) {
+            sawexception = true;
+        }
+        ASSERT_TRUE(sawexception);
+    }
+    EXPECT_EQ(crowded + 1, cache.compileCount());
+
+    // PCRE2 is built with JIT support, and cached patterns are JIT compiled
+    uint32_t jit = 0;
+    ASSERT_LE(0, pcre2_config(PCRE2_CONFIG_JIT, &jit));
+    EXPECT_EQ(1, jit);
+    const std::string jitPattern("[a-z](\\d+)[A-Z]");
+    pcre2_match_data *matchData = NULL;
+    int errorCode = 0;
+    pcre2_code *code = cache.get(jitPattern.data(), jitPattern.size(), 0, &matchData, &errorCode);
+    ASSERT_TRUE(code != NULL);
+    size_t jitSize = 0;
+    ASSERT_EQ(0, pcre2_pattern_info(code, PCRE2_INFO_JITSIZE, &jitSize));
+    EXPECT_LT(0, jitSize);
+}
+
+TEST_F(FunctionTest, JsonFieldWithoutDom) {
+    const std::string doc("{\"id\": 7, \"user\": {\"name\": \"x\\u00e9\", \"tags\": [\"a\", \"b\"]},"
+                          " \"score\": 2.50, \"ok\": true, \"none\": null,"
+                          " \"dup\": {\"a\": 1}, \"dup\": {\"b\": 2}}");
+    JsonPathEvaluator &evaluator = ExecutorContext::getExecutorContext()->jsonPathEvaluator();
+    const int64_t parsed = evaluator.pathParseCount();
+
+    // Values are rendered as jsoncpp would render them
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "id", "7"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user.name", "x\xc3\xa9"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user.tags", "[\"a\",\"b\"]"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user.tags[-1]", "b"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "score", "2.50"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "ok", "true"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user", "{\"name\":\"x\xc3\xa9\",\"tags\":[\"a\",\"b\"]}"), 0);
+    // The last of duplicate keys wins
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "dup.b", "2"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "dup.a", "", true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "none", "", true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user.tags[2]", "", true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "id.x", "", true), 0);
+
+    // Paths are parsed once for all rows.  More paths were read above than
+    // the cache keeps, so the first row may parse this one again.
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user.tags[-1]", "b"), 0);
+    const int64_t afterFirst = evaluator.pathParseCount();
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, "user.tags[-1]", "b"), 0);
+    }
+    EXPECT_EQ(afterFirst, evaluator.pathParseCount());
+    EXPECT_LT(parsed, afterFirst);
+
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, std::string("[1, {\"b\": 2, \"a\": 1}]"),
+                         1, "{\"a\":1,\"b\":2}"), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, std::string("[1, 2]"), 2, "", true), 0);
+
+    // Documents the reader does not take are still handled by jsoncpp
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, std::string("{\"a\": 1 /* comment */}"), "a", "1"), 0);
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, std::string("{\"a\": "), "a", "Invalid JSON"));
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, doc, "a[x]", "Invalid JSON path"));
+}
+
 static NValue timestampFromString(const std::string& dateString) {
     return ValueFactory::getTimestampValue(NValue::parseTimestampString(dateString));
 }
@@ -1057,6 +1174,163 @@ TEST_F(FunctionTest, TestTimestampValidity)
                            True));
 }
 
+TEST_F(FunctionTest, ExpressionOptimizer) {
+    // (ARRAY_LENGTH(C0) = 2 * 3) AND (ARRAY_LENGTH(C0) + 0 = 6), loaded as part of a fragment
+    const char* arrayLengthC0 =
+        "{\"TYPE\":100,\"VALUE_TYPE\":5,\"FUNCTION_ID\":20004,\"NAME\":\"array_length\","
+        "\"ARGS\":[{\"TYPE\":32,\"VALUE_TYPE\":9,\"VALUE_SIZE\":15,\"COLUMN_IDX\":0}]}";
+    std::string json = std::string(
+        "{\"PREDICATE\":{\"TYPE\":20,\"VALUE_TYPE\":23,"
+        "\"LEFT\":{\"TYPE\":10,\"VALUE_TYPE\":23,\"LEFT\":") + arrayLengthC0 + ","
+        "\"RIGHT\":{\"TYPE\":3,\"VALUE_TYPE\":6,"
+        "\"LEFT\":{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":2},"
+        "\"RIGHT\":{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":3}}},"
+        "\"RIGHT\":{\"TYPE\":10,\"VALUE_TYPE\":23,"
+        "\"LEFT\":{\"TYPE\":1,\"VALUE_TYPE\":6,\"LEFT\":" + arrayLengthC0 + ","
+        "\"RIGHT\":{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":0}},"
+        "\"RIGHT\":{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":6}}},"
+        // ABS(C1) twice is cheaper to evaluate than to share
+        "\"PROJECTION\":[{\"TYPE\":100,\"VALUE_TYPE\":6,\"FUNCTION_ID\":10,\"NAME\":\"abs\","
+        "\"ARGS\":[{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":1}]},"
+        "{\"TYPE\":100,\"VALUE_TYPE\":6,\"FUNCTION_ID\":10,\"NAME\":\"abs\","
+        "\"ARGS\":[{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":1}]}]}";
+    PlannerDomRoot domRoot(json.c_str());
+    PlannerDomValue fragment = domRoot.rootObject();
+
+    boost::scoped_ptr<AbstractExpression> predicate;
+    boost::scoped_ptr<AbstractExpression> absC1;
+    {
+        ExpressionOptimizer optimizer(fragment);
+        EXPECT_EQ(&optimizer, ExpressionOptimizer::current());
+        predicate.reset(AbstractExpression::buildExpressionTree(fragment.valueForKey("PREDICATE")));
+        absC1.reset(AbstractExpression::buildExpressionTree(fragment.valueForKey("PROJECTION").valueAtIndex(0)));
+        // 2 * 3 is folded, both uses of ARRAY_LENGTH(C0) share one memo
+        EXPECT_EQ(1, optimizer.foldedCount());
+        EXPECT_EQ(1, optimizer.memoizedCount());
+        EXPECT_EQ(1, optimizer.sharedCount());
+    }
+    EXPECT_EQ(NULL, ExpressionOptimizer::current());
+    EXPECT_EQ(EXPRESSION_TYPE_VALUE_CONSTANT, predicate->getLeft()->getRight()->getExpressionType());
+    EXPECT_EQ(EXPRESSION_TYPE_FUNCTION, predicate->getLeft()->getLeft()->getExpressionType());
+    EXPECT_TRUE(dynamic_cast<const MemoizedExpression*>(predicate->getLeft()->getLeft()) != NULL);
+    EXPECT_TRUE(dynamic_cast<MemoizedExpression*>(absC1.get()) == NULL);
+
+    std::vector<ValueType> types;
+    types.push_back(VALUE_TYPE_VARCHAR);
+    types.push_back(VALUE_TYPE_BIGINT);
+    std::vector<int32_t> sizes;
+    sizes.push_back(15);
+    sizes.push_back(8);
+    std::vector<bool> allowNull(2, true);
+    TupleSchema* schema = TupleSchema::createTupleSchemaForTest(types, sizes, allowNull);
+    {
+        StandAloneTupleStorage storage(schema);
+        TableTuple tuple = storage.tuple();
+        // the memo sees each change of the column
+        const char* values[] = { "[1,2,3,4,5,6]", "[6,5,4,3,2,1]", "[1,2,3]", "[0,0,0,0,0,0]" };
+        bool expected[] = { true, true, false, true };
+        for (int ii = 0; ii < 4; ++ii) {
+            tuple.setNValue(0, ValueFactory::getTempStringValue(values[ii]));
+            EXPECT_EQ(expected[ii], predicate->eval(&tuple, NULL).isTrue());
+            EXPECT_EQ(expected[ii], predicate->eval(&tuple, NULL).isTrue());
+        }
+        tuple.setNValue(0, NValue::getNullValue(VALUE_TYPE_VARCHAR));
+        EXPECT_FALSE(predicate->eval(&tuple, NULL).isTrue());
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
+TEST_F(FunctionTest, ExpressionOptimizerTellsSubtreesApart) {
+    // ARRAY_LENGTH(C0), ARRAY_LENGTH(C1), ARRAY_LENGTH(C0) and ARRAY_LENGTH(C0) + 0.5:
+    // only the subtrees which are the same all the way down are shared
+    std::string json = std::string("{\"PROJECTION\":[");
+    for (int ii = 0; ii < 4; ++ii) {
+        std::ostringstream arrayLength;
+        arrayLength << "{\"TYPE\":100,\"VALUE_TYPE\":5,\"FUNCTION_ID\":20004,\"NAME\":\"array_length\","
+                    << "\"ARGS\":[{\"TYPE\":32,\"VALUE_TYPE\":9,\"VALUE_SIZE\":15,\"COLUMN_IDX\":"
+                    << (ii == 1 ? 1 : 0) << "}]}";
+        if (ii > 0) {
+            json += ",";
+        }
+        if (ii == 3) {
+            json += "{\"TYPE\":1,\"VALUE_TYPE\":8,\"LEFT\":" + arrayLength.str() +
+                ",\"RIGHT\":{\"TYPE\":30,\"VALUE_TYPE\":8,\"ISNULL\":false,\"VALUE\":0.5}}";
+        }
+        else {
+            json += arrayLength.str();
+        }
+    }
+    json += "]}";
+    PlannerDomRoot domRoot(json.c_str());
+    PlannerDomValue fragment = domRoot.rootObject();
+
+    boost::ptr_vector<AbstractExpression> projection;
+    {
+        ExpressionOptimizer optimizer(fragment);
+        for (int ii = 0; ii < 4; ++ii) {
+            projection.push_back(AbstractExpression::buildExpressionTree(
+                    fragment.valueForKey("PROJECTION").valueAtIndex(ii)));
+        }
+        EXPECT_EQ(0, optimizer.foldedCount());
+        EXPECT_EQ(1, optimizer.memoizedCount());
+        EXPECT_EQ(2, optimizer.sharedCount());
+    }
+    EXPECT_TRUE(dynamic_cast<MemoizedExpression*>(&projection[0]) != NULL);
+    EXPECT_TRUE(dynamic_cast<MemoizedExpression*>(&projection[1]) == NULL);
+    EXPECT_TRUE(dynamic_cast<MemoizedExpression*>(&projection[2]) != NULL);
+    EXPECT_TRUE(dynamic_cast<MemoizedExpression*>(&projection[3]) == NULL);
+    EXPECT_TRUE(dynamic_cast<const MemoizedExpression*>(projection[3].getLeft()) != NULL);
+}
+
+TEST_F(FunctionTest, ExpressionOptimizerPerExecution) {
+    // ABS(?0) + 1 and NOW only change between executions
+    const char* json =
+        "{\"PROJECTION\":[{\"TYPE\":1,\"VALUE_TYPE\":6,"
+        "\"LEFT\":{\"TYPE\":100,\"VALUE_TYPE\":6,\"FUNCTION_ID\":10,\"NAME\":\"abs\","
+        "\"ARGS\":[{\"TYPE\":31,\"VALUE_TYPE\":6,\"PARAM_IDX\":0}]},"
+        "\"RIGHT\":{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":1}},"
+        "{\"TYPE\":100,\"VALUE_TYPE\":11,\"FUNCTION_ID\":43,\"NAME\":\"current_timestamp\",\"ARGS\":[]}]}";
+    PlannerDomRoot domRoot(json);
+    PlannerDomValue fragment = domRoot.rootObject();
+
+    boost::scoped_ptr<AbstractExpression> absParam;
+    boost::scoped_ptr<AbstractExpression> now;
+    {
+        ExpressionOptimizer optimizer(fragment);
+        absParam.reset(AbstractExpression::buildExpressionTree(fragment.valueForKey("PROJECTION").valueAtIndex(0)));
+        now.reset(AbstractExpression::buildExpressionTree(fragment.valueForKey("PROJECTION").valueAtIndex(1)));
+        EXPECT_EQ(0, optimizer.foldedCount());
+        EXPECT_EQ(2, optimizer.memoizedCount());
+        EXPECT_EQ(0, optimizer.sharedCount());
+    }
+    ASSERT_TRUE(dynamic_cast<MemoizedExpression*>(absParam.get()) != NULL);
+    ASSERT_TRUE(dynamic_cast<MemoizedExpression*>(now.get()) != NULL);
+
+    // NOW is taken from the txn's unique id, in milliseconds
+    const int64_t firstMillis = 1000;
+    const int64_t secondMillis = 3000;
+    const int64_t firstUniqueId = firstMillis << (UniqueId::COUNTER_BITS + UniqueId::PARTITIONID_BITS);
+    const int64_t secondUniqueId = secondMillis << (UniqueId::COUNTER_BITS + UniqueId::PARTITIONID_BITS);
+
+    startExecution(-4, firstUniqueId);
+    EXPECT_EQ(5, ValuePeeker::peekAsBigInt(absParam->eval(NULL, NULL)));
+    const int64_t firstNow = ValuePeeker::peekTimestamp(now->eval(NULL, NULL));
+
+    // Each is evaluated once per execution: changes within it are not seen
+    changeWithinExecution(9, secondUniqueId);
+    for (int ii = 0; ii < 3; ++ii) {
+        EXPECT_EQ(5, ValuePeeker::peekAsBigInt(absParam->eval(NULL, NULL)));
+        EXPECT_EQ(firstNow, ValuePeeker::peekTimestamp(now->eval(NULL, NULL)));
+    }
+
+    // The next execution sees the new parameter and txn time
+    startExecution(9, secondUniqueId);
+    EXPECT_EQ(10, ValuePeeker::peekAsBigInt(absParam->eval(NULL, NULL)));
+    EXPECT_EQ(firstNow + (secondMillis - firstMillis) * 1000,
+              ValuePeeker::peekTimestamp(now->eval(NULL, NULL)));
+    EXPECT_EQ(10, ValuePeeker::peekAsBigInt(absParam->eval(NULL, NULL)));
+}
+
 int main(int argc, char **argv) {
     for (argv++; *argv; argv++) {
         if (strcmp(*argv, "--verbose") == 0) {
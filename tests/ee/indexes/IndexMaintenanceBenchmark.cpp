@@ -0,0 +1,418 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures index maintenance (insert, update, delete) throughput over
+ * tree and hash indexes, unique and multi, of several key widths, with
+ * and without partial index predicates, and the cost of evaluating
+ * partial index predicates in compiled versus interpreted form.
+ *
+ * Run without arguments, each case uses a small number of rows and
+ * prints nothing, so the suite runs as a silent correctness test with
+ * the other index tests.  For a real measurement pass the number of
+ * rows, which also turns on the timing report, e.g.
+ *     IndexMaintenanceBenchmark 1000000
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
+#include "expressions/abstractexpression.h"
+#include "expressions/expressionutil.h"
+#include "indexes/tableindex.h"
+#include "indexes/tableindexfactory.h"
+
+using namespace voltdb;
+using namespace std;
+
+#define SMOKE_SCALE 2000
+
+static int dataScale = SMOKE_SCALE;
+// Timings are only reported for an explicit measurement run.
+static bool reportTimings = false;
+
+static int64_t getMicrosNow() {
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// Table layout: an id, four key columns with repeating values, and a
+// nullable filter column that partial index predicates test.
+#define ID_COL 0
+#define FILTER_COL 5
+#define NUM_COLS 6
+
+// Predicates are built the way the catalog delivers them, from JSON.
+// Expression and value types are given by their enum values:
+// COMPARE_LESSTHAN = 12, COMPARE_LESSTHANOREQUALTO = 14,
+// COMPARE_GREATERTHANOREQUALTO = 15,
+// CONJUNCTION_AND = 20, OPERATOR_NOT = 8, OPERATOR_IS_NULL = 9,
+// OPERATOR_PLUS = 1, VALUE_CONSTANT = 30, VALUE_TUPLE = 32,
+// BIGINT = 6, BOOLEAN = 23.
+static string filterColumnJson() {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":%d}", FILTER_COL);
+    return buffer;
+}
+
+static string constantJson(int64_t value) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":%lld}",
+             static_cast<long long>(value));
+    return buffer;
+}
+
+static string binaryJson(int type, int valueType, const string& left, const string& right) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "{\"TYPE\":%d,\"VALUE_TYPE\":%d,", type, valueType);
+    return string(buffer) + "\"LEFT\":" + left + ",\"RIGHT\":" + right + "}";
+}
+
+static string unaryJson(int type, const string& operand) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "{\"TYPE\":%d,\"VALUE_TYPE\":23,", type);
+    return string(buffer) + "\"LEFT\":" + operand + "}";
+}
+
+enum PredicateKind {
+    NO_PREDICATE,
+    // filter >= 500
+    SIMPLE_PREDICATE,
+    // filter IS NOT NULL AND 250 <= filter AND filter < 750
+    RANGE_PREDICATE,
+    // filter + 1 >= 501, which is not compiled
+    INTERPRETED_PREDICATE
+};
+
+static const char* predicateName(PredicateKind kind) {
+    switch (kind) {
+    case NO_PREDICATE:
+        return "none";
+    case SIMPLE_PREDICATE:
+        return "filter >= 500";
+    case RANGE_PREDICATE:
+        return "filter IS NOT NULL AND 250 <= filter AND filter < 750";
+    default:
+        return "filter + 1 >= 501";
+    }
+}
+
+static AbstractExpression* createPredicate(PredicateKind kind) {
+    string json;
+    switch (kind) {
+    case NO_PREDICATE:
+        return NULL;
+    case SIMPLE_PREDICATE:
+        json = binaryJson(15, 23, filterColumnJson(), constantJson(500));
+        break;
+    case RANGE_PREDICATE:
+        // "250 <= filter" has the constant on the left.
+        json = binaryJson(20, 23,
+                          unaryJson(8, unaryJson(9, filterColumnJson())),
+                          binaryJson(20, 23,
+                                     binaryJson(14, 23, constantJson(250), filterColumnJson()),
+                                     binaryJson(12, 23, filterColumnJson(), constantJson(750))));
+        break;
+    default:
+        json = binaryJson(15, 23,
+                          binaryJson(1, 6, filterColumnJson(), constantJson(1)),
+                          constantJson(501));
+        break;
+    }
+    return ExpressionUtil::loadExpressionFromJson(json);
+}
+
+class BenchmarkRecorder {
+public:
+    BenchmarkRecorder() : m_start(0), m_duration(0) {}
+
+    void start() {
+        m_start = getMicrosNow();
+    }
+
+    void stop() {
+        m_duration += getMicrosNow() - m_start;
+    }
+
+    void print(const string& name, int64_t ops) const {
+        if (! reportTimings) {
+            return;
+        }
+        int64_t micros = m_duration > 0 ? m_duration : 1;
+        printf("    %-10s %10lld ops in %8lld us, %10.0f ops/sec\n",
+               name.c_str(), static_cast<long long>(ops), static_cast<long long>(m_duration),
+               static_cast<double>(ops) * 1000000.0 / static_cast<double>(micros));
+    }
+
+private:
+    int64_t m_start;
+    int64_t m_duration;
+};
+
+class IndexMaintenanceBenchmark : public Test {
+public:
+    IndexMaintenanceBenchmark() : m_data(NULL), m_scratch(NULL) {
+        vector<ValueType> columnTypes(NUM_COLS, VALUE_TYPE_BIGINT);
+        vector<int32_t> columnLengths(NUM_COLS, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        vector<bool> columnAllowNull(NUM_COLS, false);
+        columnAllowNull[FILTER_COL] = true;
+        m_schema = TupleSchema::createTupleSchemaForTest(columnTypes, columnLengths, columnAllowNull);
+        m_tupleLength = TableTuple(m_schema).tupleLength();
+    }
+
+    ~IndexMaintenanceBenchmark() {
+        delete[] m_data;
+        delete[] m_scratch;
+        TupleSchema::freeTupleSchema(m_schema);
+    }
+
+protected:
+    void initTuples(int numTuples) {
+        delete[] m_data;
+        delete[] m_scratch;
+        m_numTuples = numTuples;
+        m_data = new char[m_tupleLength * numTuples];
+        m_scratch = new char[m_tupleLength];
+        memset(m_data, 0, m_tupleLength * numTuples);
+        memset(m_scratch, 0, m_tupleLength);
+
+        srand(888);
+        static const int moduli[] = { 97, 89, 83, 79 };
+        for (int i = 0; i < numTuples; ++i) {
+            TableTuple tuple = tupleAt(i);
+            tuple.setNValue(ID_COL, ValueFactory::getBigIntValue(i));
+            for (int col = 1; col < FILTER_COL; ++col) {
+                tuple.setNValue(col, ValueFactory::getBigIntValue(i % moduli[col - 1]));
+            }
+            tuple.setNValue(FILTER_COL, randomFilterValue());
+        }
+    }
+
+    static NValue randomFilterValue() {
+        if (rand() % 10 == 0) {
+            return NValue::getNullValue(VALUE_TYPE_BIGINT);
+        }
+        return ValueFactory::getBigIntValue(rand() % 1000);
+    }
+
+    TableTuple tupleAt(int i) {
+        return TableTuple(m_data + m_tupleLength * i, m_schema);
+    }
+
+    // Unique indexes lead with the id; multi indexes use only the
+    // repeating key columns.
+    TableIndex* createIndex(TableIndexType type, bool unique, int keyWidth, PredicateKind kind) {
+        vector<int32_t> columnIndices;
+        for (int i = 0; i < keyWidth; ++i) {
+            columnIndices.push_back(unique ? i : i + 1);
+        }
+        vector<AbstractExpression*> exprs;
+        TableIndexScheme scheme("bench_index", type, columnIndices, exprs,
+                                createPredicate(kind),
+                                unique,
+                                false, // countable
+                                "",    // expression as text
+                                predicateName(kind),
+                                m_schema);
+        return TableIndexFactory::getInstance(scheme);
+    }
+
+    int64_t countAccepted(const AbstractExpression* predicate) {
+        if (predicate == NULL) {
+            return m_numTuples;
+        }
+        int64_t accepted = 0;
+        for (int i = 0; i < m_numTuples; ++i) {
+            TableTuple tuple = tupleAt(i);
+            if (predicate->eval(&tuple, NULL).isTrue()) {
+                ++accepted;
+            }
+        }
+        return accepted;
+    }
+
+    // Insert every tuple, update every tuple's filter column (and every
+    // other tuple's key), then delete every tuple, following the index
+    // maintenance done by PersistentTable.
+    void runMaintenance(TableIndexType type, bool unique, int keyWidth, PredicateKind kind) {
+        TableIndex* index = createIndex(type, unique, keyWidth, kind);
+        if (reportTimings) {
+            printf("  %s %s, %d key column(s), predicate: %s%s\n",
+                   type == HASH_TABLE_INDEX ? "hash" : "tree",
+                   unique ? "unique" : "multi",
+                   keyWidth,
+                   predicateName(kind),
+                   kind != NO_PREDICATE && ! index->isPredicateCompiled() ? " (interpreted)" : "");
+        }
+
+        BenchmarkRecorder insertRecorder;
+        insertRecorder.start();
+        for (int i = 0; i < m_numTuples; ++i) {
+            TableTuple tuple = tupleAt(i);
+            index->addEntry(&tuple, NULL);
+        }
+        insertRecorder.stop();
+        EXPECT_EQ(countAccepted(index->getPredicate()), index->getSize());
+
+        BenchmarkRecorder updateRecorder;
+        TableTuple target(m_scratch, m_schema);
+        updateRecorder.start();
+        for (int i = 0; i < m_numTuples; ++i) {
+            TableTuple source = tupleAt(i);
+            target.copy(source);
+            target.setNValue(FILTER_COL, randomFilterValue());
+            if (i % 2 == 1) {
+                target.setNValue(1, ValueFactory::getBigIntValue(ValuePeeker::peekAsBigInt(source.getNValue(1)) + 1));
+            }
+            if (index->checkForIndexChange(&source, &target)) {
+                index->deleteEntry(&source);
+                source.copy(target);
+                index->addEntry(&source, NULL);
+            }
+            else {
+                source.copy(target);
+            }
+        }
+        updateRecorder.stop();
+        EXPECT_EQ(countAccepted(index->getPredicate()), index->getSize());
+
+        BenchmarkRecorder deleteRecorder;
+        deleteRecorder.start();
+        for (int i = 0; i < m_numTuples; ++i) {
+            TableTuple tuple = tupleAt(i);
+            index->deleteEntry(&tuple);
+        }
+        deleteRecorder.stop();
+        EXPECT_EQ(0, index->getSize());
+
+        insertRecorder.print("insert", m_numTuples);
+        updateRecorder.print("update", m_numTuples);
+        deleteRecorder.print("delete", m_numTuples);
+        delete index;
+    }
+
+    // Evaluate the predicate of a partial index against every tuple
+    // both ways and check that the answers agree.
+    void runPredicateEvaluation(PredicateKind kind) {
+        TableIndex* index = createIndex(BALANCED_TREE_INDEX, false, 1, kind);
+        const AbstractExpression* predicate = index->getPredicate();
+        if (reportTimings) {
+            printf("  predicate: %s\n", predicateName(kind));
+        }
+
+        const int repeat = 5;
+        int64_t interpretedAccepted = 0;
+        BenchmarkRecorder interpretedRecorder;
+        interpretedRecorder.start();
+        for (int r = 0; r < repeat; ++r) {
+            for (int i = 0; i < m_numTuples; ++i) {
+                TableTuple tuple = tupleAt(i);
+                if (predicate->eval(&tuple, NULL).isTrue()) {
+                    ++interpretedAccepted;
+                }
+            }
+        }
+        interpretedRecorder.stop();
+
+        int64_t accepted = 0;
+        BenchmarkRecorder recorder;
+        recorder.start();
+        for (int r = 0; r < repeat; ++r) {
+            for (int i = 0; i < m_numTuples; ++i) {
+                TableTuple tuple = tupleAt(i);
+                if (index->predicateAccepts(&tuple)) {
+                    ++accepted;
+                }
+            }
+        }
+        recorder.stop();
+
+        for (int i = 0; i < m_numTuples; ++i) {
+            TableTuple tuple = tupleAt(i);
+            ASSERT_EQ(predicate->eval(&tuple, NULL).isTrue(), index->predicateAccepts(&tuple));
+        }
+        EXPECT_EQ(interpretedAccepted, accepted);
+        EXPECT_EQ(kind != INTERPRETED_PREDICATE, index->isPredicateCompiled());
+
+        interpretedRecorder.print("eval", m_numTuples * repeat);
+        recorder.print(index->isPredicateCompiled() ? "compiled" : "fallback", m_numTuples * repeat);
+        delete index;
+    }
+
+    TupleSchema* m_schema;
+    int m_tupleLength;
+    int m_numTuples;
+    char* m_data;
+    char* m_scratch;
+};
+
+TEST_F(IndexMaintenanceBenchmark, IndexTypesAndKeyWidths) {
+    initTuples(dataScale);
+    const TableIndexType types[] = { BALANCED_TREE_INDEX, HASH_TABLE_INDEX };
+    const int keyWidths[] = { 1, 2, 4 };
+    for (int t = 0; t < 2; ++t) {
+        for (int unique = 1; unique >= 0; --unique) {
+            for (int w = 0; w < 3; ++w) {
+                runMaintenance(types[t], unique == 1, keyWidths[w], NO_PREDICATE);
+            }
+        }
+    }
+}
+
+TEST_F(IndexMaintenanceBenchmark, PartialIndexes) {
+    initTuples(dataScale);
+    const TableIndexType types[] = { BALANCED_TREE_INDEX, HASH_TABLE_INDEX };
+    const PredicateKind kinds[] = { SIMPLE_PREDICATE, RANGE_PREDICATE, INTERPRETED_PREDICATE };
+    for (int t = 0; t < 2; ++t) {
+        for (int unique = 1; unique >= 0; --unique) {
+            for (int k = 0; k < 3; ++k) {
+                runMaintenance(types[t], unique == 1, 2, kinds[k]);
+            }
+        }
+    }
+}
+
+TEST_F(IndexMaintenanceBenchmark, PredicateEvaluation) {
+    initTuples(dataScale);
+    runPredicateEvaluation(SIMPLE_PREDICATE);
+    runPredicateEvaluation(RANGE_PREDICATE);
+    runPredicateEvaluation(INTERPRETED_PREDICATE);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        dataScale = atoi(argv[1]);
+        if (dataScale <= 0) {
+            printf("Usage: %s [number of rows, default %d]\n", argv[0], SMOKE_SCALE);
+            return 0;
+        }
+        reportTimings = true;
+    }
+    return TestSuite::globalInstance()->runAll();
+}
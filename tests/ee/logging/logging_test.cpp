@@ -25,6 +25,7 @@
 #include "logging/LogManager.h"
 #include "logging/LogProxy.h"
 #include <stdint.h>
+#include <string>
 
 voltdb::LoggerId loggerIds[] = {
         voltdb::LOGGERID_SQL,
@@ -50,6 +51,12 @@ public:
     voltdb::LoggerId lastLoggerId;
     voltdb::LogLevel lastLogLevel;
     char *lastStatement;
+    std::string lastText;
+    int count;
+
+    TestProxy() : lastLoggerId(voltdb::LOGGERID_INVALID), lastLogLevel(voltdb::LOGLEVEL_OFF),
+                  lastStatement(NULL), count(0) {}
+
     /**
      * Log a statement on behalf of the specified logger at the specified log level
      * @param LoggerId ID of the logger that received this statement
@@ -60,6 +67,8 @@ public:
         const_cast<TestProxy*>(this)->lastLoggerId = loggerId;
         const_cast<TestProxy*>(this)->lastLogLevel = level;
         const_cast<TestProxy*>(this)->lastStatement = const_cast<char*>(statement);
+        const_cast<TestProxy*>(this)->lastText = statement;
+        const_cast<TestProxy*>(this)->count++;
     };
 
 };
@@ -68,6 +77,10 @@ class LoggingTest : public Test {
     public:
         LoggingTest() : m_logManager(new TestProxy()) {}
         voltdb::LogManager m_logManager;
+
+        TestProxy *proxy() {
+            return dynamic_cast<TestProxy*>(const_cast<voltdb::LogProxy*>(m_logManager.getLogProxy()));
+        }
 };
 
 TEST_F(LoggingTest, TestManagerSetLevels) {
@@ -130,6 +143,123 @@ TEST_F(LoggingTest, TestLoggerUsesProxyLevels) {
         }
     }
 }
+/**
+ * With the log ring enabled, debug statements wait for a drain while
+ * more important ones still go straight out, after the waiting ones.
+ */
+TEST_F(LoggingTest, TestLogRingDefersDebug) {
+    // TRACE for both loggers, without buffering
+    m_logManager.setLogLevels(voltdb::LOGLEVEL_TRACE | (voltdb::LOGLEVEL_TRACE << 3));
+    EXPECT_TRUE(m_logManager.getLogRing() == NULL);
+
+    m_logManager.enableLogRing(4096);
+    m_logManager.setLogLevels(voltdb::LOGLEVEL_TRACE | (voltdb::LOGLEVEL_TRACE << 3) |
+                              voltdb::LOGLEVELS_BUFFER_DEBUG);
+    EXPECT_EQ(4096, m_logManager.getLogRing()->capacity());
+    const voltdb::Logger *logger = voltdb::LogManager::getThreadLogger(voltdb::LOGGERID_SQL);
+
+    logger->log(voltdb::LOGLEVEL_DEBUG, "foo");
+    logger->log(voltdb::LOGLEVEL_TRACE, "bar");
+    EXPECT_EQ(0, proxy()->count);
+    EXPECT_EQ(2, m_logManager.drainLogRing());
+    EXPECT_EQ(2, proxy()->count);
+    EXPECT_EQ("bar", proxy()->lastText);
+    EXPECT_EQ(voltdb::LOGLEVEL_TRACE, proxy()->lastLogLevel);
+    EXPECT_EQ(0, m_logManager.drainLogRing());
+
+    logger->log(voltdb::LOGLEVEL_DEBUG, "first");
+    logger->log(voltdb::LOGLEVEL_WARN, "second");
+    EXPECT_EQ(4, proxy()->count);
+    EXPECT_EQ("second", proxy()->lastText);
+    EXPECT_TRUE(m_logManager.getLogRing()->isEmpty());
+
+    // Crashing gets out what is buffered
+    logger->log(voltdb::LOGLEVEL_DEBUG, "third");
+    voltdb::LogManager::drainThreadLogRing();
+    EXPECT_EQ(5, proxy()->count);
+    EXPECT_EQ("third", proxy()->lastText);
+
+    // Going back to INFO forwards what is buffered and frees the ring
+    logger->log(voltdb::LOGLEVEL_DEBUG, "fourth");
+    m_logManager.setLogLevels(voltdb::LOGLEVEL_INFO | (voltdb::LOGLEVEL_INFO << 3) |
+                              voltdb::LOGLEVELS_BUFFER_DEBUG);
+    EXPECT_EQ(6, proxy()->count);
+    EXPECT_EQ("fourth", proxy()->lastText);
+    EXPECT_TRUE(m_logManager.getLogRing() == NULL);
+}
+
+/**
+ * Formatted statements are only formatted when loggable, into the ring
+ * when they are buffered and directly otherwise.
+ */
+TEST_F(LoggingTest, TestLogFormat) {
+    const voltdb::Logger *logger = voltdb::LogManager::getThreadLogger(voltdb::LOGGERID_SQL);
+    m_logManager.setLogLevels(voltdb::LOGLEVEL_INFO | (voltdb::LOGLEVEL_INFO << 3));
+    logger->logFormat(voltdb::LOGLEVEL_DEBUG, "rows %d of %d", 1, 2);
+    EXPECT_EQ(0, proxy()->count);
+    logger->logFormat(voltdb::LOGLEVEL_INFO, "rows %d of %s", 1, "two");
+    EXPECT_EQ(1, proxy()->count);
+    EXPECT_EQ("rows 1 of two", proxy()->lastText);
+
+    m_logManager.enableLogRing(4096);
+    m_logManager.setLogLevels(voltdb::LOGLEVEL_DEBUG | (voltdb::LOGLEVEL_DEBUG << 3) |
+                              voltdb::LOGLEVELS_BUFFER_DEBUG);
+    logger->logFormat(voltdb::LOGLEVEL_TRACE, "rows %d of %d", 2, 3);
+    logger->logFormat(voltdb::LOGLEVEL_DEBUG, "rows %d of %d", 3, 4);
+    EXPECT_EQ(1, proxy()->count);
+    EXPECT_EQ(1, m_logManager.drainLogRing());
+    EXPECT_EQ("rows 3 of 4", proxy()->lastText);
+
+    // Statements longer than a quarter of the ring are cut down
+    std::string statement(2000, 'x');
+    logger->logFormat(voltdb::LOGLEVEL_DEBUG, "%s%s", statement.c_str(), statement.c_str());
+    EXPECT_EQ(1, m_logManager.drainLogRing());
+    EXPECT_EQ(std::string(4096 / 4 - 8 - 1, 'x'), proxy()->lastText);
+
+    // Statements that do not fit before the end of the buffer wrap to its start
+    std::string shorter(100, 'y');
+    for (int i = 0; i < 200; i++) {
+        logger->logFormat(voltdb::LOGLEVEL_DEBUG, "%03d %s", i, shorter.c_str());
+        if (i % 3 == 2) {
+            EXPECT_EQ(3, m_logManager.drainLogRing());
+            char expected[8];
+            snprintf(expected, sizeof(expected), "%03d ", i);
+            EXPECT_EQ(expected + shorter, proxy()->lastText);
+        }
+    }
+    EXPECT_EQ(0, m_logManager.getLogRing()->droppedCount());
+}
+
+/**
+ * A full ring drops statements and the next drain says how many.
+ */
+TEST_F(LoggingTest, TestLogRingDropsWhenFull) {
+    m_logManager.enableLogRing(4096);
+    m_logManager.setLogLevels(voltdb::LOGLEVEL_DEBUG | voltdb::LOGLEVELS_BUFFER_DEBUG);
+    const voltdb::Logger *logger = voltdb::LogManager::getThreadLogger(voltdb::LOGGERID_SQL);
+
+    std::string statement(100, 'x');
+    for (int i = 0; i < 100; i++) {
+        logger->log(voltdb::LOGLEVEL_DEBUG, statement.c_str());
+    }
+    const voltdb::LogRing *ring = m_logManager.getLogRing();
+    EXPECT_TRUE(ring->droppedCount() > 0);
+    size_t drained = m_logManager.drainLogRing();
+    EXPECT_EQ(100, drained + ring->droppedCount());
+    EXPECT_EQ(drained + 1, proxy()->count);
+    EXPECT_EQ(voltdb::LOGGERID_HOST, proxy()->lastLoggerId);
+    EXPECT_EQ(voltdb::LOGLEVEL_WARN, proxy()->lastLogLevel);
+
+    // The space is reused once drained, wrapping around the buffer
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 20; i++) {
+            logger->log(voltdb::LOGLEVEL_DEBUG, statement.c_str());
+        }
+        EXPECT_EQ(20, m_logManager.drainLogRing());
+        EXPECT_EQ(statement, proxy()->lastText);
+    }
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
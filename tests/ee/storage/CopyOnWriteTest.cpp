@@ -56,6 +56,7 @@
 
 #include "jsoncpp/jsoncpp.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdint.h>
 #include <stdarg.h>
@@ -1816,6 +1817,10 @@ public:
         m_test.m_moved.insert(value);
     }
 
+    void setTuplesPerCall(size_t nTuplesPerCall) {
+        m_context->setTuplesPerCall(nTuplesPerCall);
+    }
+
     int32_t m_partitionId;
     const std::vector<std::string> &m_predicateStrings;
     boost::scoped_ptr<ElasticContext> m_context;
@@ -1863,6 +1868,65 @@ TEST_F(CopyOnWriteTest, ElasticIndex) {
     checkIndex("ElasticIndex", getElasticIndex(), predicates, false);
 }
 
+// Test an elastic index built over many chunks while the table changes.
+TEST_F(CopyOnWriteTest, ElasticIndexChunkedBuild) {
+    const int NUM_PARTITIONS = 1;
+    const int TUPLES_PER_BLOCK = 50;
+    const int NUM_INITIAL = 300;
+    const int NUM_CYCLES_PER_CHUNK = 10;
+    const int FREQ_INSERT = 1;
+    const int FREQ_DELETE = 10;
+    const int FREQ_UPDATE = 5;
+    const int FREQ_COMPACTION = 100;
+
+    ElasticTableScrambler tableScrambler(*this,
+                                         NUM_PARTITIONS, TUPLES_PER_BLOCK, NUM_INITIAL,
+                                         FREQ_INSERT, FREQ_DELETE,
+                                         FREQ_UPDATE, FREQ_COMPACTION);
+
+    tableScrambler.initialize();
+
+    T_HashRangeVector ranges;
+    ranges.push_back(T_HashRange(0x00000000, 0x7fffffff));
+    std::vector<std::string> predicateStrings;
+    predicateStrings.push_back(generateHashRangePredicate(ranges));
+    StreamPredicateList predicates;
+    parsePredicateList(predicateStrings, predicates);
+
+    DummyElasticTableStreamer *streamerPtr = new DummyElasticTableStreamer(*this, 0, predicateStrings);
+    boost::shared_ptr<TableStreamerInterface> streamer(streamerPtr);
+    doActivateStream(TABLE_STREAM_ELASTIC_INDEX, streamer, predicateStrings, false);
+    const size_t TUPLES_PER_CALL = 20;
+    streamerPtr->setTuplesPerCall(TUPLES_PER_CALL);
+
+    // Insert, delete, update and compact between the chunks of the scan,
+    // of the merge into the index and of the replay of the changes.
+    size_t nCalls = 0;
+    size_t nMergeCalls = 0;
+    while (doStreamMore(TABLE_STREAM_ELASTIC_INDEX) != 0) {
+        // The index reads as empty until its bulk load is finished.
+        if (getElasticIndex()->isBulkLoading()) {
+            ASSERT_EQ(0, getElasticIndex()->size());
+            nMergeCalls++;
+        }
+        for (int icycle = 0; icycle < NUM_CYCLES_PER_CHUNK; icycle++) {
+            tableScrambler.scramble();
+        }
+        nCalls++;
+    }
+    ASSERT_LE(10, nCalls);
+    // The merge is spread over calls as well. The range holds about half of
+    // the table, so well over a quarter of it gets merged TUPLES_PER_CALL at a time.
+    ASSERT_LE(NUM_INITIAL / 4 / TUPLES_PER_CALL, nMergeCalls);
+    checkIndex("ElasticIndexChunkedBuild", getElasticIndex(), predicates, false);
+
+    // Changes after the build go straight to the index.
+    for (int icycle = 0; icycle < NUM_CYCLES_PER_CHUNK * 10; icycle++) {
+        tableScrambler.scramble();
+    }
+    checkIndex("ElasticIndexChunkedBuild after", getElasticIndex(), predicates, false);
+}
+
 /**
  * Tests that a snapshot scan and an elastic index can coexist.
  * The sequence is:
@@ -1999,6 +2063,90 @@ TEST_F(CopyOnWriteTest, ElasticIndexLowerUpperBounds) {
     ASSERT_TRUE(index.createUpperBoundIterator(3) == index.end());
 }
 
+TEST_F(CopyOnWriteTest, ElasticIndexAddBatch) {
+    ElasticIndex batchIndex;
+    ElasticIndex singleIndex;
+    std::vector<ElasticIndexKey> keys;
+    char *base = reinterpret_cast<char*>(&batchIndex);
+    // Enough keys for the radix sort path, with hash collisions and duplicates.
+    for (int i = 0; i < 5000; i++) {
+        ElasticHash hash = static_cast<ElasticHash>(rand() % 2000) - 1000;
+        if (i % 7 == 0) {
+            hash = std::numeric_limits<int32_t>::min() + i;
+        }
+        keys.push_back(ElasticIndexKey(hash, base + (rand() % 3000)));
+    }
+    for (size_t i = 0; i < keys.size(); i++) {
+        singleIndex.add(keys[i]);
+    }
+    // Seed the batch index so the batch is merged into a non-empty tree.
+    batchIndex.add(keys[0]);
+    size_t added = batchIndex.add(keys);
+    ASSERT_EQ(singleIndex.size(), added + 1);
+    ASSERT_EQ(singleIndex.size(), batchIndex.size());
+    for (size_t i = 1; i < keys.size(); i++) {
+        ASSERT_FALSE(ElasticIndexComparator()(keys[i], keys[i - 1]));
+    }
+    ElasticIndex::const_iterator itBatch = batchIndex.createIterator();
+    ElasticIndex::const_iterator itSingle = singleIndex.createIterator();
+    while (itSingle != singleIndex.end()) {
+        ASSERT_TRUE(*itSingle == *itBatch);
+        ++itSingle;
+        ++itBatch;
+    }
+    ASSERT_TRUE(itBatch == batchIndex.end());
+
+    // An empty index takes the bulk load path, duplicates included.
+    ElasticIndex loadedIndex;
+    std::vector<ElasticIndexKey> loadKeys(keys);
+    std::random_shuffle(loadKeys.begin(), loadKeys.end());
+    ASSERT_EQ(singleIndex.size(), loadedIndex.add(loadKeys));
+    ASSERT_EQ(singleIndex.size(), loadedIndex.size());
+    ElasticIndex::const_iterator itLoaded = loadedIndex.createIterator();
+    for (itSingle = singleIndex.createIterator(); itSingle != singleIndex.end(); ++itSingle) {
+        ASSERT_TRUE(*itSingle == *itLoaded);
+        ASSERT_TRUE(loadedIndex.find(*itSingle) != loadedIndex.end());
+        ++itLoaded;
+    }
+    ASSERT_TRUE(itLoaded == loadedIndex.end());
+    // The bulk loaded tree must keep working as a regular btree.
+    for (size_t i = 0; i < keys.size(); i += 3) {
+        loadedIndex.erase(keys[i]);
+        ASSERT_TRUE(loadedIndex.find(keys[i]) == loadedIndex.end());
+    }
+    ASSERT_TRUE(loadedIndex.add(keys[0]));
+
+    // The incremental bulk load builds the same tree over many appends.
+    std::vector<ElasticIndexKey> uniqueKeys(keys);
+    uniqueKeys.erase(std::unique(uniqueKeys.begin(), uniqueKeys.end()), uniqueKeys.end());
+    ElasticIndex appendedIndex;
+    appendedIndex.startBulkLoad();
+    for (size_t i = 0; i < uniqueKeys.size(); i++) {
+        appendedIndex.bulkAppend(uniqueKeys[i]);
+        ASSERT_TRUE(appendedIndex.empty());
+    }
+    ASSERT_EQ(singleIndex.size(), appendedIndex.finishBulkLoad());
+    ASSERT_FALSE(appendedIndex.isBulkLoading());
+    ElasticIndex::const_iterator itAppended = appendedIndex.createIterator();
+    for (itSingle = singleIndex.createIterator(); itSingle != singleIndex.end(); ++itSingle) {
+        ASSERT_TRUE(*itSingle == *itAppended);
+        ++itAppended;
+    }
+    ASSERT_TRUE(itAppended == appendedIndex.end());
+    for (size_t i = 0; i < uniqueKeys.size(); i += 3) {
+        ASSERT_TRUE(appendedIndex.remove(uniqueKeys[i]));
+    }
+    ASSERT_TRUE(appendedIndex.add(uniqueKeys[0]));
+
+    // An index dropped in the middle of a load frees what was built.
+    boost::scoped_ptr<ElasticIndex> droppedIndex(new ElasticIndex());
+    droppedIndex->startBulkLoad();
+    for (size_t i = 0; i < uniqueKeys.size() / 2; i++) {
+        droppedIndex->bulkAppend(uniqueKeys[i]);
+    }
+    droppedIndex.reset();
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -485,6 +485,52 @@ public:
         m_engine->prepareContext();
     }
 
+    // Take the flushed buffers so that they can be applied more than once
+    std::vector<DRStreamData> takeDRStreamData(int64_t lastCommittedSpHandle) {
+        std::vector<DRStreamData> buffers;
+        if (flush(lastCommittedSpHandle)) {
+            while (!m_topend.blocks.empty()) {
+                buffers.push_back(getDRStreamData());
+            }
+        }
+        m_topend.receivedDRBuffer = false;
+        return buffers;
+    }
+
+    int64_t applyToReplica(const std::vector<DRStreamData> &buffers, bool success = true) {
+        beginTxn(m_engineReplica,
+                 addPartitionId(m_spHandleReplica), // txnid
+                 addPartitionId(m_spHandleReplica), // sphandle
+                 addPartitionId(m_spHandleReplica - 1), // last sphandle
+                 addPartitionId(m_spHandleReplica)); // fake uniqueid
+        m_spHandleReplica++;
+
+        boost::unordered_map<int64_t, PersistentTable*> tables;
+        tables[42] = m_tableReplica;
+        tables[24] = m_replicatedTableReplica;
+
+        int64_t rowCount = 0;
+        m_drStream.m_enabled = false;
+        m_drReplicatedStream.m_enabled = false;
+        try {
+            for (size_t i = 0; i < buffers.size(); i++) {
+                rowCount += m_sinkWrapper.apply(&buffers[i].first[buffers[i].second], tables, &m_pool, m_engineReplica, 1);
+            }
+        } catch (SerializableEEException &e) {
+            m_drStream.m_enabled = true;
+            m_drReplicatedStream.m_enabled = true;
+            endTxn(m_engineReplica, false);
+            m_engine->prepareContext();
+            throw;
+        }
+        m_drStream.m_enabled = true;
+        m_drReplicatedStream.m_enabled = true;
+        endTxn(m_engineReplica, success);
+
+        m_engine->prepareContext();
+        return rowCount;
+    }
+
     void enableActiveActive() {
         m_engine->enableActiveActiveForTest(m_engine->getConflictStreamedTable(), NULL);
         m_engineReplica->enableActiveActiveForTest(m_engineReplica->getConflictStreamedTable(), NULL);
@@ -978,6 +1024,56 @@ TEST_F(DRBinaryLogTest, ReplicatedTableWrites) {
     EXPECT_EQ(2, committed.seqNum);
 }
 
+TEST_F(DRBinaryLogTest, ReplicatedTableApplyBarrier) {
+    beginTxn(m_engine, 109, 99, 98, 70);
+    insertTuple(m_replicatedTable, prepareTempTuple(m_replicatedTable, 42, 55555, "349508345.34583", "a thing", "a totally different thing altogether", 5433));
+    endTxn(m_engine, true);
+    std::vector<DRStreamData> first = takeDRStreamData(99);
+
+    beginTxn(m_engine, 110, 100, 99, 71);
+    insertTuple(m_replicatedTable, prepareTempTuple(m_replicatedTable, 7, 234, "23452436.54", "what", "this is starting to get silly", 2342));
+    endTxn(m_engine, true);
+    std::vector<DRStreamData> second = takeDRStreamData(100);
+
+    beginTxn(m_engine, 111, 101, 100, 72);
+    insertTuple(m_replicatedTable, prepareTempTuple(m_replicatedTable, 24, 2321, "23455.5554", "and another", "this is starting to get even sillier", 2222));
+    endTxn(m_engine, true);
+    std::vector<DRStreamData> third = takeDRStreamData(101);
+
+    EXPECT_EQ(-1, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+    EXPECT_EQ(1, applyToReplica(first));
+    EXPECT_EQ(1, m_replicatedTableReplica->activeTupleCount());
+    EXPECT_EQ(0, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+
+    // Rolling back a txn rolls back the barrier too
+    EXPECT_EQ(1, applyToReplica(second, false));
+    EXPECT_EQ(1, m_replicatedTableReplica->activeTupleCount());
+    EXPECT_EQ(0, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+
+    // Gaps are allowed, DR events take sequence numbers as well
+    EXPECT_EQ(1, applyToReplica(third));
+    EXPECT_EQ(2, m_replicatedTableReplica->activeTupleCount());
+    EXPECT_EQ(2, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+
+    // Redelivered txns, and any txn behind the barrier, are skipped
+    EXPECT_EQ(0, applyToReplica(first));
+    EXPECT_EQ(0, applyToReplica(second));
+    EXPECT_EQ(0, applyToReplica(third));
+    EXPECT_EQ(2, m_replicatedTableReplica->activeTupleCount());
+
+    // The barrier can be restored from the consumer's persisted trackers
+    boost::unordered_map<int32_t, int64_t> sequenceNumbers;
+    sequenceNumbers[1] = 0;
+    m_sinkWrapper.setReplicatedSequenceNumbers(sequenceNumbers);
+    EXPECT_EQ(0, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+    EXPECT_EQ(1, applyToReplica(second));
+    EXPECT_EQ(3, m_replicatedTableReplica->activeTupleCount());
+    EXPECT_EQ(1, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+
+    m_sinkWrapper.setReplicatedSequenceNumbers(boost::unordered_map<int32_t, int64_t>());
+    EXPECT_EQ(-1, m_sinkWrapper.lastAppliedReplicatedSequenceNumber(1));
+}
+
 TEST_F(DRBinaryLogTest, SerializeNulls) {
     beginTxn(m_engine, 109, 99, 98, 70);
     TableTuple first_tuple = insertTuple(m_replicatedTable, firstTupleWithNulls(m_replicatedTable));
@@ -792,6 +792,47 @@ TEST_F(DRTupleStreamTest, BufferAllowsAtLeastOneTxn) {
     EXPECT_EQ(results->offset(), MAGIC_TRANSACTION_SIZE + MAGIC_TUPLE_SIZE);
 }
 
+/**
+ * Blocks grow while they keep filling up, a transaction that spills out
+ * of a small block is carried over into a block of full size, and
+ * blocks shrink again once flushes find them mostly empty.
+ */
+TEST_F(DRTupleStreamTest, AdaptiveCapacity) {
+    const size_t headerSpace = MAGIC_HEADER_SPACE_FOR_JAVA + MAGIC_DR_TRANSACTION_PADDING;
+    m_wrapper.setDefaultCapacity(MIN_ADAPTIVE_BUFFER_SIZE * 8);
+    m_wrapper.setSecondaryCapacity(MIN_ADAPTIVE_BUFFER_SIZE * 16);
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE, m_wrapper.currentCapacity());
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE - headerSpace, m_wrapper.m_currBlock->capacity());
+
+    // The first block fills up in the middle of a transaction
+    int txnId = 1;
+    while (!m_topend.receivedDRBuffer) {
+        appendTuple(txnId - 1, txnId);
+        if (!m_topend.receivedDRBuffer) {
+            m_wrapper.endTransaction(addPartitionId(txnId));
+            txnId++;
+        }
+    }
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE * 2, m_wrapper.currentCapacity());
+    ASSERT_EQ(1, m_topend.blocks.size());
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE - headerSpace, m_topend.blocks.front()->capacity());
+    EXPECT_EQ(m_topend.blocks.front()->uso() + m_topend.blocks.front()->offset(),
+              m_wrapper.m_currBlock->uso());
+    m_topend.blocks.pop_front();
+    m_topend.receivedDRBuffer = false;
+
+    // The transaction went along into a block of full size
+    EXPECT_LT(m_wrapper.m_currBlock->uso(), m_wrapper.m_uso);
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE * 8 - headerSpace, m_wrapper.m_currBlock->capacity());
+    m_wrapper.endTransaction(addPartitionId(txnId));
+
+    // which a flush finds mostly empty, so the next block is smaller again
+    m_wrapper.periodicFlush(-1, addPartitionId(txnId));
+    ASSERT_TRUE(m_topend.receivedDRBuffer);
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE, m_wrapper.currentCapacity());
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE - headerSpace, m_wrapper.m_currBlock->capacity());
+}
+
 TEST_F(DRTupleStreamTest, EnumHack)
 {
     DRRecordType type = DR_RECORD_DELETE;
@@ -220,6 +220,8 @@ TEST_F(ExportTupleStreamTest, BasicOps)
     m_wrapper->periodicFlush(-1, 19);
 
     EXPECT_EQ( 1289, m_wrapper->allocatedByteCount());
+    // the flushed blocks only hold data
+    EXPECT_EQ( 1289, m_wrapper->occupiedByteCount());
 
     // get the first buffer flushed
     ASSERT_TRUE(m_topend.receivedExportBuffer);
@@ -238,6 +240,7 @@ TEST_F(ExportTupleStreamTest, BasicOps)
     // ack all of the data and re-verify block count
     allocatedByteCount = m_wrapper->allocatedByteCount();
     EXPECT_TRUE(allocatedByteCount == 0);
+    EXPECT_EQ(0, m_wrapper->occupiedByteCount());
 }
 
 /**
@@ -498,6 +501,38 @@ TEST_F(ExportTupleStreamTest, RollbackWholeBuffer)
     EXPECT_EQ(results->offset(), (MAGIC_TUPLE_SIZE * 10));
 }
 
+/**
+ * Blocks grow while they keep filling up and shrink again when the
+ * stream goes quiet.
+ */
+TEST_F(ExportTupleStreamTest, AdaptiveCapacity) {
+    m_wrapper->setDefaultCapacity(MIN_ADAPTIVE_BUFFER_SIZE * 4);
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE, m_wrapper->currentCapacity());
+
+    int txnId = 1;
+    while (!m_topend.receivedExportBuffer) {
+        appendTuple(txnId - 1, txnId);
+        txnId++;
+    }
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE * 2, m_wrapper->currentCapacity());
+    boost::shared_ptr<StreamBlock> results = m_topend.blocks.front();
+    m_topend.blocks.pop_front();
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE - MAGIC_HEADER_SPACE_FOR_JAVA, results->capacity());
+
+    // The next block is flushed nearly empty...
+    m_wrapper->periodicFlush(-1, txnId - 1);
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE, m_wrapper->currentCapacity());
+    ASSERT_EQ(1, m_topend.blocks.size());
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE * 2 - MAGIC_HEADER_SPACE_FOR_JAVA, m_topend.blocks.front()->capacity());
+
+    // ... and idle flushes keep the empty block rather than reallocating it
+    StreamBlock *idleBlock = m_wrapper->m_currBlock;
+    m_wrapper->periodicFlush(-1, txnId - 1);
+    m_wrapper->periodicFlush(-1, txnId - 1);
+    EXPECT_EQ(idleBlock, m_wrapper->m_currBlock);
+    EXPECT_EQ(MIN_ADAPTIVE_BUFFER_SIZE, m_wrapper->currentCapacity());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,137 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Tests for the bulk_load and bulk_builder additions to the vendored
+ * stx btree. Every tree size up to a few levels deep is built with
+ * several node sizes, and verify() checks the node fill, key order,
+ * levels and leaf links of each one.
+ */
+
+#include <cstdio>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include "harness.h"
+#include "stx/btree_set.h"
+
+const int MAX_SIZE = 3000;
+
+template <int LEAF_SLOTS, int INNER_SLOTS>
+struct SmallNodeTraits {
+    static const bool selfverify = false;
+    static const bool debug = false;
+    static const int leafslots = LEAF_SLOTS;
+    static const int innerslots = INNER_SLOTS;
+};
+
+class BTreeBulkLoadTest : public Test {
+public:
+    /*
+     * Check the tree's invariants and that it holds exactly the keys
+     * 0, 2, 4, ... in order.
+     */
+    template <typename Set>
+    void checkTree(const Set &tree, int size) {
+        tree.verify();
+        ASSERT_EQ(static_cast<size_t>(size), tree.size());
+        int expected = 0;
+        for (typename Set::const_iterator it = tree.begin(); it != tree.end(); ++it) {
+            ASSERT_EQ(expected, *it);
+            expected += 2;
+        }
+        ASSERT_EQ(size * 2, expected);
+        int reversed = size * 2;
+        for (typename Set::const_reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it) {
+            reversed -= 2;
+            ASSERT_EQ(reversed, *it);
+        }
+        ASSERT_EQ(0, reversed);
+    }
+
+    template <typename Set>
+    void sweep() {
+        std::vector<int> keys;
+        for (int size = 0; size <= MAX_SIZE; size++) {
+            Set loaded;
+            loaded.bulk_load(keys.begin(), keys.end());
+            checkTree(loaded, size);
+
+            Set built;
+            boost::scoped_ptr<typename Set::bulk_builder> builder(built.new_bulk_builder());
+            for (int i = 0; i < size; i++) {
+                builder->append(keys[i]);
+            }
+            ASSERT_EQ(static_cast<size_t>(size), builder->size());
+            builder->finish();
+            checkTree(built, size);
+
+            // The built tree takes inserts and erases like any other
+            built.insert(-1);
+            built.insert(size * 2 + 1);
+            built.verify();
+            built.erase(-1);
+            built.erase(size * 2 + 1);
+            checkTree(built, size);
+
+            keys.push_back(size * 2);
+        }
+    }
+};
+
+TEST_F(BTreeBulkLoadTest, SmallestNodes) {
+    sweep<stx::btree_set<int, std::less<int>, SmallNodeTraits<4, 4> > >();
+}
+
+TEST_F(BTreeBulkLoadTest, OddNodes) {
+    sweep<stx::btree_set<int, std::less<int>, SmallNodeTraits<5, 7> > >();
+}
+
+TEST_F(BTreeBulkLoadTest, MixedNodes) {
+    sweep<stx::btree_set<int, std::less<int>, SmallNodeTraits<16, 8> > >();
+}
+
+TEST_F(BTreeBulkLoadTest, DefaultNodes) {
+    sweep<stx::btree_set<int> >();
+}
+
+TEST_F(BTreeBulkLoadTest, UnfinishedBuilder) {
+    // Destroying a builder before finish() frees its nodes and leaves the
+    // tree empty
+    typedef stx::btree_set<int, std::less<int>, SmallNodeTraits<4, 4> > Set;
+    for (int size = 0; size <= 200; size++) {
+        Set tree;
+        {
+            boost::scoped_ptr<Set::bulk_builder> builder(tree.new_bulk_builder());
+            for (int i = 0; i < size; i++) {
+                builder->append(i);
+            }
+        }
+        ASSERT_TRUE(tree.empty());
+        tree.verify();
+    }
+}
+
+int main() {
+    assert(printf("Assertions are enabled\n"));
+    return TestSuite::globalInstance()->runAll();
+}
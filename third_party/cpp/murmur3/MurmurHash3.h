@@ -4,6 +4,8 @@
 // We've changed it for use with VoltDB:
 //   - We changed the functions declared below to return their hash by
 //     value, rather than accept a pointer to storage for the result
+//   - We added MurmurHash64A, from the MurmurHash2 family, to hash runs
+//     of tuple bytes into a 64 bit seed
 
 //-----------------------------------------------------------------------------
 // MurmurHash3 was written by Austin Appleby, and is placed in the public
@@ -12,6 +14,9 @@
 #ifndef _MURMURHASH3_H_
 #define _MURMURHASH3_H_
 
+#include <stddef.h>
+#include <string.h>
+
 namespace voltdb {
 
 //-----------------------------------------------------------------------------
@@ -47,6 +52,39 @@ inline int32_t MurmurHash3_x64_128 ( int64_t value) {
 
 uint32_t MurmurHash3_x86_32(const void* key, uint32_t len, uint32_t seed);
 
+// MurmurHash64A, reading the tail bytes as it does on a little-endian
+// machine.  Inline because it is called for every few bytes of a tuple.
+inline uint64_t MurmurHash64A(const void* key, size_t len, uint64_t seed) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = seed ^ (len * m);
+
+    const char* data = static_cast<const char*>(key);
+    const char* end = data + (len & ~static_cast<size_t>(7));
+    for (; data != end; data += 8) {
+        uint64_t k;
+        memcpy(&k, data, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    const size_t tailLength = len & 7;
+    if (tailLength != 0) {
+        uint64_t k = 0;
+        memcpy(&k, data, tailLength);
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
 //-----------------------------------------------------------------------------
 
 }
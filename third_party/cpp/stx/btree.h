@@ -33,6 +33,8 @@
 #include <ostream>
 #include <memory>
 #include <cstddef>
+#include <iterator>
+#include <vector>
 #include <assert.h>
 
 // *** Debugging Macros
@@ -2055,6 +2057,371 @@ public:
         }
     }
 
+    /// Bulk load a sorted range [ibegin,iend) of unique items into an empty
+    /// B+ tree. The iterators may dereference to either pair_type or plain
+    /// key_type. Leaves are filled left to right and the inner levels are
+    /// built bottom up, so each node is written exactly once.
+    template <typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend)
+    {
+        BTREE_ASSERT(empty());
+
+        size_t num_items = std::distance(ibegin, iend);
+        if (num_items == 0) return;
+        stats.itemcount = num_items;
+
+        // calculate number of leaves needed, round up.
+        size_t num_leaves = (num_items + leafslotmax - 1) / leafslotmax;
+
+        Iterator it = ibegin;
+        for (size_t i = 0; i < num_leaves; ++i)
+        {
+            leaf_node *leaf = allocate_leaf();
+
+            // spread the items evenly over the remaining leaves.
+            leaf->slotuse = static_cast<unsigned short>(num_items / (num_leaves - i));
+            for (unsigned short s = 0; s < leaf->slotuse; ++s, ++it)
+                bulk_set_slot(leaf, s, *it);
+
+            if (tailleaf != NULL) {
+                tailleaf->nextleaf = leaf;
+                leaf->prevleaf = tailleaf;
+            }
+            else {
+                headleaf = leaf;
+            }
+            tailleaf = leaf;
+
+            num_items -= leaf->slotuse;
+        }
+
+        BTREE_ASSERT(it == iend && num_items == 0);
+
+        // if the tree fits into a single leaf then we're done.
+        if (headleaf == tailleaf) {
+            root = headleaf;
+            return;
+        }
+
+        // first level of inner nodes, pointing to the leaves.
+        size_t num_parents = (num_leaves + innerslotmax) / (innerslotmax + 1);
+
+        // inner nodes of the level just built and the max key below each.
+        typedef std::pair<inner_node*, const key_type*> nextlevel_type;
+        std::vector<nextlevel_type> nextlevel(num_parents);
+
+        leaf_node *leaf = headleaf;
+        for (size_t i = 0; i < num_parents; ++i)
+        {
+            inner_node *n = allocate_inner(1);
+
+            // slotuse counts keys, an inner node has one more child than keys.
+            n->slotuse = static_cast<unsigned short>(num_leaves / (num_parents - i) - 1);
+
+            for (unsigned short s = 0; s < n->slotuse; ++s)
+            {
+                n->slotkey[s] = leaf->slotkey[leaf->slotuse - 1];
+                n->childid[s] = leaf;
+                leaf = leaf->nextleaf;
+            }
+            n->childid[n->slotuse] = leaf;
+
+            nextlevel[i].first = n;
+            nextlevel[i].second = &leaf->slotkey[leaf->slotuse - 1];
+
+            leaf = leaf->nextleaf;
+            num_leaves -= n->slotuse + 1;
+        }
+
+        BTREE_ASSERT(leaf == NULL && num_leaves == 0);
+
+        // build inner nodes pointing to inner nodes until one root remains.
+        for (unsigned short level = 2; num_parents != 1; ++level)
+        {
+            size_t num_children = num_parents;
+            num_parents = (num_children + innerslotmax) / (innerslotmax + 1);
+
+            size_t inner_index = 0;
+            for (size_t i = 0; i < num_parents; ++i)
+            {
+                inner_node *n = allocate_inner(level);
+
+                n->slotuse = static_cast<unsigned short>(num_children / (num_parents - i) - 1);
+
+                for (unsigned short s = 0; s < n->slotuse; ++s)
+                {
+                    n->slotkey[s] = *nextlevel[inner_index].second;
+                    n->childid[s] = nextlevel[inner_index].first;
+                    ++inner_index;
+                }
+                n->childid[n->slotuse] = nextlevel[inner_index].first;
+
+                // slots already consumed can be overwritten with the parents.
+                nextlevel[i].first = n;
+                nextlevel[i].second = nextlevel[inner_index].second;
+
+                ++inner_index;
+                num_children -= n->slotuse + 1;
+            }
+
+            BTREE_ASSERT(num_children == 0);
+        }
+
+        root = nextlevel[0].first;
+
+        if (selfverify) verify();
+    }
+
+    /// Incremental form of bulk_load for loads too large to do in one step.
+    /// Sorted, unique items are fed to append() over as many calls as the
+    /// caller likes and finish() then completes the tree in O(height). Each
+    /// append() touches only the rightmost node of each level, so the work
+    /// done between two calls is proportional to the items appended in it.
+    /// Full nodes are handed to their parent one node late, which lets
+    /// finish() rebalance the two rightmost nodes of every level so none of
+    /// them underflows. The tree stays empty until finish(); destroying an
+    /// unfinished builder frees the nodes built so far.
+    class bulk_builder
+    {
+    public:
+        explicit bulk_builder(btree_self &tree)
+            : m_tree(tree), m_headleaf(NULL), m_tailleaf(NULL), m_itemcount(0)
+        {
+            BTREE_ASSERT(tree.empty() && tree.root == NULL);
+        }
+
+        ~bulk_builder()
+        {
+            for (size_t level = 0; level < m_open.size(); ++level) {
+                free_subtree(m_open[level]);
+                free_subtree(m_held[level]);
+            }
+        }
+
+        /// Number of items appended so far
+        size_type size() const
+        {
+            return m_itemcount;
+        }
+
+        /// Append the next item, which must be greater than every item
+        /// appended before. It may be either a pair_type or a plain key_type.
+        template <typename Item>
+        void append(const Item &x)
+        {
+            if (m_open.empty()) {
+                grow(0);
+            }
+            leaf_node *leaf = static_cast<leaf_node*>(m_open[0]);
+            if (leaf != NULL && leaf->isfull()) {
+                roll(0);
+                leaf = NULL;
+            }
+            if (leaf == NULL) {
+                leaf = m_tree.allocate_leaf();
+                if (m_tailleaf != NULL) {
+                    m_tailleaf->nextleaf = leaf;
+                    leaf->prevleaf = m_tailleaf;
+                }
+                else {
+                    m_headleaf = leaf;
+                }
+                m_tailleaf = leaf;
+                m_open[0] = leaf;
+            }
+            bulk_set_slot(leaf, leaf->slotuse, x);
+            ++leaf->slotuse;
+            ++m_itemcount;
+        }
+
+        /// Complete the tree with the items appended so far. The builder
+        /// is empty afterwards.
+        void finish()
+        {
+            for (size_t level = 0; level < m_open.size(); ++level) {
+                node *held = m_held[level];
+                node *open = m_open[level];
+                m_held[level] = m_open[level] = NULL;
+                if (held == NULL && open == NULL) {
+                    // Nothing was appended
+                    BTREE_ASSERT(m_itemcount == 0);
+                    break;
+                }
+                if (held != NULL && open != NULL) {
+                    rebalance(level, held, open);
+                }
+                bool isTop = level + 1 == m_open.size() ||
+                    (m_open[level + 1] == NULL && m_held[level + 1] == NULL);
+                if (isTop && (held == NULL || open == NULL)) {
+                    m_tree.root = held != NULL ? held : open;
+                    break;
+                }
+                if (held != NULL) {
+                    add_child(level + 1, held, m_heldmax[level]);
+                }
+                if (open != NULL) {
+                    add_child(level + 1, open, max_key(level, open));
+                }
+            }
+            m_tree.headleaf = m_headleaf;
+            m_tree.tailleaf = m_tailleaf;
+            m_tree.stats.itemcount = m_itemcount;
+            m_headleaf = m_tailleaf = NULL;
+            m_itemcount = 0;
+            m_open.clear();
+            m_held.clear();
+            m_openmax.clear();
+            m_heldmax.clear();
+
+            if (selfverify) m_tree.verify();
+        }
+
+    private:
+        void grow(size_t level)
+        {
+            if (m_open.size() <= level) {
+                m_open.resize(level + 1, NULL);
+                m_held.resize(level + 1, NULL);
+                m_openmax.resize(level + 1);
+                m_heldmax.resize(level + 1);
+            }
+        }
+
+        /// The largest key below the open node of a level
+        const key_type& max_key(size_t level, const node *n) const
+        {
+            if (n->isleafnode()) {
+                const leaf_node *leaf = static_cast<const leaf_node*>(n);
+                return leaf->slotkey[leaf->slotuse - 1];
+            }
+            return m_openmax[level];
+        }
+
+        /// The open node of a level is full: hold it back and hand the node
+        /// held before it to the parent level.
+        void roll(size_t level)
+        {
+            if (m_held[level] != NULL) {
+                node *held = m_held[level];
+                m_held[level] = NULL;
+                add_child(level + 1, held, m_heldmax[level]);
+            }
+            m_heldmax[level] = max_key(level, m_open[level]);
+            m_held[level] = m_open[level];
+            m_open[level] = NULL;
+        }
+
+        /// Hand a child to the open node of a level. childmax is a copy,
+        /// growing the per level vectors may move the key it came from.
+        void add_child(size_t level, node *child, key_type childmax)
+        {
+            grow(level);
+            inner_node *inner = static_cast<inner_node*>(m_open[level]);
+            if (inner != NULL && inner->isfull()) {
+                roll(level);
+                inner = NULL;
+            }
+            if (inner == NULL) {
+                inner = m_tree.allocate_inner(static_cast<unsigned short>(level));
+                inner->childid[0] = child;
+                m_open[level] = inner;
+            }
+            else {
+                inner->slotkey[inner->slotuse] = m_openmax[level];
+                ++inner->slotuse;
+                inner->childid[inner->slotuse] = child;
+            }
+            m_openmax[level] = childmax;
+        }
+
+        /// Move slots from the full held node to the open node after it,
+        /// so that neither underflows.
+        void rebalance(size_t level, node *held, node *open)
+        {
+            if (open->isleafnode()) {
+                leaf_node *left = static_cast<leaf_node*>(held);
+                leaf_node *right = static_cast<leaf_node*>(open);
+                if (!right->isunderflow()) return;
+                unsigned short shift = static_cast<unsigned short>(
+                    (left->slotuse + right->slotuse) / 2 - right->slotuse);
+                std::copy_backward(right->slotkey, right->slotkey + right->slotuse,
+                                   right->slotkey + right->slotuse + shift);
+                std::copy_backward(right->slotdata, right->slotdata + right->slotuse,
+                                   right->slotdata + right->slotuse + shift);
+                std::copy(left->slotkey + left->slotuse - shift, left->slotkey + left->slotuse,
+                          right->slotkey);
+                std::copy(left->slotdata + left->slotuse - shift, left->slotdata + left->slotuse,
+                          right->slotdata);
+                left->slotuse = static_cast<unsigned short>(left->slotuse - shift);
+                right->slotuse = static_cast<unsigned short>(right->slotuse + shift);
+                m_heldmax[level] = left->slotkey[left->slotuse - 1];
+            }
+            else {
+                inner_node *left = static_cast<inner_node*>(held);
+                inner_node *right = static_cast<inner_node*>(open);
+                if (!right->isunderflow()) return;
+                // Count children, an inner node has one more child than keys
+                unsigned short leftchildren = static_cast<unsigned short>(left->slotuse + 1);
+                unsigned short rightchildren = static_cast<unsigned short>(right->slotuse + 1);
+                unsigned short shift = static_cast<unsigned short>(
+                    (leftchildren + rightchildren) / 2 - rightchildren);
+                std::copy_backward(right->slotkey, right->slotkey + right->slotuse,
+                                   right->slotkey + right->slotuse + shift);
+                std::copy_backward(right->childid, right->childid + rightchildren,
+                                   right->childid + rightchildren + shift);
+                // The moved children keep their keys, the last one takes the
+                // held node's max key, which had no slot in the held node.
+                std::copy(left->childid + leftchildren - shift, left->childid + leftchildren,
+                          right->childid);
+                std::copy(left->slotkey + leftchildren - shift, left->slotkey + left->slotuse,
+                          right->slotkey);
+                right->slotkey[shift - 1] = m_heldmax[level];
+                m_heldmax[level] = left->slotkey[leftchildren - shift - 1];
+                left->slotuse = static_cast<unsigned short>(left->slotuse - shift);
+                right->slotuse = static_cast<unsigned short>(right->slotuse + shift);
+            }
+        }
+
+        void free_subtree(node *n)
+        {
+            if (n != NULL) {
+                m_tree.clear_recursive(n);
+                m_tree.free_node(n);
+            }
+        }
+
+        btree_self &m_tree;
+
+        /// Per level, the node being filled and the full node before it
+        /// that has not been handed to its parent yet
+        std::vector<node*> m_open;
+        std::vector<node*> m_held;
+
+        /// Per level, the largest key below the last child of the open node
+        /// and below the held node
+        std::vector<key_type> m_openmax;
+        std::vector<key_type> m_heldmax;
+
+        leaf_node *m_headleaf;
+        leaf_node *m_tailleaf;
+        size_type m_itemcount;
+    };
+
+private:
+    /// Store a key/data pair into a leaf slot during bulk_load.
+    static inline void bulk_set_slot(leaf_node *leaf, unsigned short slot, const pair_type &x)
+    {
+        leaf->slotkey[slot] = x.first;
+        leaf->slotdata[slot] = x.second;
+    }
+
+    /// Store a plain key into a leaf slot during bulk_load.
+    static inline void bulk_set_slot(leaf_node *leaf, unsigned short slot, const key_type &x)
+    {
+        leaf->slotkey[slot] = x;
+    }
+
+
 private:
     // *** Private Insertion Functions
 
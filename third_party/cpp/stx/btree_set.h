@@ -496,6 +496,24 @@ public:
         }
     }
 
+    /// Bulk load a sorted range [ibegin,iend) of unique keys into an empty
+    /// B+ tree. Much faster than inserting the keys one at a time.
+    template <typename Iterator>
+    inline void bulk_load(Iterator ibegin, Iterator iend)
+    {
+        tree.bulk_load(ibegin, iend);
+    }
+
+    /// Incremental form of bulk_load, see btree::bulk_builder.
+    typedef typename btree_impl::bulk_builder bulk_builder;
+
+    /// Start an incremental bulk load into this empty set. The caller owns
+    /// the builder and must not use the set until its finish().
+    inline bulk_builder* new_bulk_builder()
+    {
+        return new bulk_builder(tree);
+    }
+
 public:
     // *** Public Erase Functions
 